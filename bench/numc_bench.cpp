@@ -0,0 +1,637 @@
+#include <NumC.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nc = NumC;
+
+namespace
+{
+    /// @brief Keeps the compiler from optimizing a computed value away.
+    template<typename T>
+    inline void do_not_optimize(T const& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /// @brief Stream buffer discarding everything written to it.
+    class NullBuffer : public std::streambuf
+    {
+        protected:
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override
+            {
+                return n;
+            }
+    };
+
+    /// @brief Result of a single benchmark case.
+    struct Result
+    {
+        std::string name;
+        nc::size_t elements;
+        nc::size_t iterations;
+        double ns_per_iter;
+        double elements_per_sec;
+        double gb_per_sec;
+    };
+
+    /// @brief Runs benchmark cases and collects their results.
+    class Runner
+    {
+        public:
+            Runner(double min_time, const std::string& filter) :
+                __min_time(min_time),
+                __filter(filter)
+            {}
+
+            /**
+             * @brief Times a kernel. The kernel is repeated until the
+             * minimum time is reached and the best of 5 such batches is
+             * reported.
+             *
+             * @param name Case name.
+             * @param elements Elements processed per kernel call.
+             * @param bytes Bytes read + written per kernel call.
+             * @param kernel Kernel to be timed.
+             */
+            void run(
+                const std::string& name,
+                nc::size_t elements,
+                double bytes,
+                const std::function<void()>& kernel)
+            {
+                if (!this->__filter.empty() &&
+                    name.find(this->__filter) == std::string::npos)
+                    return;
+
+                using clock = std::chrono::steady_clock;
+
+                // Warm-up and calibration of the batch size.
+                nc::size_t iterations = 1;
+                double elapsed = 0;
+
+                while (true)
+                {
+                    auto start = clock::now();
+                    for (nc::size_t i = 0; i < iterations; ++i)
+                        kernel();
+                    elapsed =
+                        std::chrono::duration<double>(
+                            clock::now() - start).count();
+
+                    if (elapsed >= this->__min_time / 5 ||
+                        iterations >= (1 << 30))
+                        break;
+
+                    iterations *= 2;
+                }
+
+                double best = elapsed;
+
+                for (int batch = 0; batch < 5; ++batch)
+                {
+                    auto start = clock::now();
+                    for (nc::size_t i = 0; i < iterations; ++i)
+                        kernel();
+                    best =
+                        std::min(
+                            best,
+                            std::chrono::duration<double>(
+                                clock::now() - start).count());
+                }
+
+                double seconds = best / iterations;
+
+                Result result;
+                result.name = name;
+                result.elements = elements;
+                result.iterations = iterations;
+                result.ns_per_iter = seconds * 1e9;
+                result.elements_per_sec = elements / seconds;
+                result.gb_per_sec = bytes / seconds / 1e9;
+
+                std::fprintf(
+                    stderr,
+                    "%-36s %12lld %14.1f ns %10.3f Gelem/s %8.2f GB/s\n",
+                    name.c_str(),
+                    (long long)elements,
+                    result.ns_per_iter,
+                    result.elements_per_sec / 1e9,
+                    result.gb_per_sec);
+
+                this->__results.push_back(result);
+            }
+
+            /**
+             * @brief Writes the collected results as JSON.
+             *
+             * @param out Output stream.
+             */
+            void write_json(std::ostream& out) const
+            {
+                out << "{\n  \"context\": {\n"
+                    << "    \"index_bytes\": " << sizeof(nc::size_t) << ",\n"
+                    << "    \"checked\": "
+#ifdef NUMC_UNCHECKED
+                    << "false"
+#else
+                    << "true"
+#endif
+                    << ",\n    \"min_time\": " << this->__min_time << "\n"
+                    << "  },\n  \"benchmarks\": [";
+
+                for (size_t i = 0; i < this->__results.size(); ++i)
+                {
+                    const Result& r = this->__results[i];
+
+                    out << (i ? ",\n" : "\n")
+                        << "    {\"name\": \"" << r.name << "\""
+                        << ", \"elements\": " << r.elements
+                        << ", \"iterations\": " << r.iterations
+                        << ", \"ns_per_iter\": " << r.ns_per_iter
+                        << ", \"elements_per_sec\": " << r.elements_per_sec
+                        << ", \"gb_per_sec\": " << r.gb_per_sec << "}";
+                }
+
+                out << "\n  ]\n}\n";
+            }
+
+        private:
+            double __min_time;
+            std::string __filter;
+            std::vector<Result> __results;
+    };
+
+    /// @brief Row length of the 2-D arrays used by every case.
+    const nc::size_t COLS = 256;
+
+    /// @brief Fills an array with increasing values.
+    void fill(ND_ARRAY<nc::float32>& array)
+    {
+        nc::float32 value = 0;
+
+        for (auto it = array.begin(), ite = array.end(); it != ite; ++it)
+            *it = (value += 1);
+    }
+
+    /// @brief Sums all elements through the constant iterator.
+    template<typename ArrayType>
+    nc::float64 iterate(const ArrayType& array)
+    {
+        nc::float64 sum = 0;
+
+        for (auto it = array.cbegin(), ite = array.cend(); it != ite; ++it)
+            sum += *it;
+
+        return sum;
+    }
+
+    /// @brief Runs every memory indexer lookup of a view.
+    template<typename ViewType>
+    nc::size_t index_all(const ViewType& view, nc::size_t n)
+    {
+        nc::size_t sum = 0;
+
+        for (nc::size_t i = 0; i < n; ++i)
+            sum += view(i);
+
+        return sum;
+    }
+
+    /// @brief Runs all cases for one element count.
+    void bench_size(Runner& runner, nc::size_t n, bool with_print)
+    {
+        const double f32 = sizeof(nc::float32);
+        const std::string sfx = "/" + std::to_string(n);
+
+        nc::shape_t shape = {n / COLS, COLS};
+        auto a = ND_ARRAY<nc::float32>(shape);
+        auto b = ND_ARRAY<nc::float32>(shape);
+        auto row = ND_ARRAY<nc::float32>(nc::shape_t({COLS}));
+        auto column = ND_ARRAY<nc::float32>(nc::shape_t({COLS, 1}));
+        fill(a);
+        fill(b);
+        fill(row);
+        fill(column);
+
+        nc::slices_t slices =
+            {nc::indices_t(0, -1), nc::indices_t(COLS / 4, 3 * COLS / 4)};
+        nc::shape_t new_shape = {COLS, -1};
+        auto sliced = nc::Utils::slice(a, slices);
+        auto transposed = nc::Utils::transpose(a);
+        auto reshaped = nc::Utils::reshape(a, new_shape);
+        nc::size_t n_sliced = n / 2;
+
+        // Construction.
+        runner.run("construct" + sfx, n, 0,
+            [&]
+            {
+                auto arr = ND_ARRAY<nc::float32>(shape);
+                do_not_optimize(arr);
+            });
+
+        runner.run("view_construct/sliced" + sfx, n, 0,
+            [&]
+            {
+                auto v = nc::Utils::slice(a, slices);
+                do_not_optimize(v);
+            });
+        runner.run("view_construct/transposed" + sfx, n, 0,
+            [&]
+            {
+                auto v = nc::Utils::transpose(a);
+                do_not_optimize(v);
+            });
+        runner.run("view_construct/reshaped" + sfx, n, 0,
+            [&]
+            {
+                auto v = nc::Utils::reshape(a, new_shape);
+                do_not_optimize(v);
+            });
+        // Sliced rows split in place, flattened through one copy.
+        nc::shape_t split_shape = {n / COLS, 2, COLS / 4};
+        nc::shape_t flat_shape = {-1};
+        runner.run("view_construct/reshaped_sliced" + sfx, n_sliced, 0,
+            [&]
+            {
+                auto v = nc::Utils::reshape(sliced, split_shape);
+                do_not_optimize(v);
+            });
+        runner.run("view_construct/reshaped_sliced_copy" + sfx, n_sliced,
+            2 * n_sliced * f32,
+            [&]
+            {
+                auto v = nc::Utils::reshape(sliced, flat_shape);
+                do_not_optimize(v);
+            });
+
+        // Iteration.
+        runner.run("iterate/contiguous" + sfx, n, n * f32,
+            [&] { do_not_optimize(iterate(a)); });
+        runner.run("iterate/sliced" + sfx, n_sliced, n_sliced * f32,
+            [&] { do_not_optimize(iterate(sliced)); });
+        runner.run("iterate/transposed" + sfx, n, n * f32,
+            [&] { do_not_optimize(iterate(transposed)); });
+        runner.run("iterate/reshaped" + sfx, n, n * f32,
+            [&] { do_not_optimize(iterate(reshaped)); });
+
+        // Arithmetic.
+        runner.run("arith/scalar_add" + sfx, n, 2 * n * f32,
+            [&] { auto r = a + 1.0; do_not_optimize(r); });
+        runner.run("arith/array_add" + sfx, n, 3 * n * f32,
+            [&] { auto r = a + b; do_not_optimize(r); });
+        runner.run("arith/broadcast_add" + sfx, n, 2 * n * f32,
+            [&] { auto r = a + row; do_not_optimize(r); });
+        runner.run("arith/view_add" + sfx, n, 3 * n * f32,
+            [&] { auto r = transposed + reshaped; do_not_optimize(r); });
+        runner.run("arith/view_broadcast_add" + sfx, n, 2 * n * f32,
+            [&] { auto r = transposed + column; do_not_optimize(r); });
+        runner.run("arith/view_scalar_add" + sfx, n, 2 * n * f32,
+            [&] { auto r = transposed + 1.0f; do_not_optimize(r); });
+
+        // Sparse products at 1% density.
+        COO_ARRAY<nc::float32> coo(shape);
+        for (nc::size_t i = 0; i < n; i += 100)
+            coo.push_back(i / COLS, (i * 7) % COLS, 1.5f);
+        CSR_ARRAY<nc::float32> csr(coo);
+        nc::size_t nnz = csr.nnz();
+        auto x = ND_ARRAY<nc::float32>(nc::shape_t({COLS}));
+        auto dense_rhs = ND_ARRAY<nc::float32>(nc::shape_t({COLS, 16}));
+        fill(x);
+        fill(dense_rhs);
+
+        const double entry_bytes = sizeof(nc::size_t) + 2 * f32;
+
+        runner.run("sparse/spmv" + sfx, nnz, nnz * entry_bytes,
+            [&] { auto r = csr.dot(x); do_not_optimize(r); });
+        runner.run("sparse/spmm" + sfx, nnz * 16, nnz * 16 * 2 * f32,
+            [&] { auto r = csr.dot(dense_rhs); do_not_optimize(r); });
+
+        // Int8 matmul against a (COLS, 64) per-column weight matrix.
+        auto weights = ND_ARRAY<nc::float32>(nc::shape_t({COLS, 64}));
+        fill(weights);
+        auto q_a = QUANTIZED_ARRAY<nc::uint8>::quantize(a);
+        auto q_w = QUANTIZED_ARRAY<nc::int8>::quantize(
+            weights, 1, nc::Quant::QuantScheme::Symmetric);
+        nc::size_t macs = (n / COLS) * COLS * 64;
+
+        runner.run("quant/quantize" + sfx, n, n * (f32 + 1),
+            [&]
+            {
+                auto r = QUANTIZED_ARRAY<nc::uint8>::quantize(a);
+                do_not_optimize(r);
+            });
+        runner.run("quant/matmul_int8" + sfx, macs, n + (n / COLS) * 64 * 4,
+            [&]
+            {
+                auto r = nc::Quant::matmul_int32(q_a, q_w);
+                do_not_optimize(r);
+            });
+
+        // Deep copy.
+        runner.run("copy/contiguous" + sfx, n, 2 * n * f32,
+            [&]
+            {
+                auto r = a.copy();
+                do_not_optimize(r);
+            });
+
+        // Half precision conversions.
+        auto half = a.astype<nc::float16>();
+        runner.run("astype/f32_to_f16" + sfx, n, n * (f32 + 2),
+            [&]
+            {
+                auto r = a.astype<nc::float16>();
+                do_not_optimize(r);
+            });
+        runner.run("astype/f16_to_f32" + sfx, n, n * (f32 + 2),
+            [&]
+            {
+                auto r = half.astype<nc::float32>();
+                do_not_optimize(r);
+            });
+
+        // Complex arithmetic on interleaved pairs.
+        ND_ARRAY<nc::complex64> za(shape), zb(shape);
+        for (nc::size_t i = 0; i < za.size(); ++i)
+        {
+            za.data()[i] = nc::complex64(float(i % 7), -1.5f);
+            zb.data()[i] = nc::complex64(0.5f, float(i % 5) + 1);
+        }
+        runner.run("complex/multiply" + sfx, n, 3 * n * 2 * f32,
+            [&]
+            {
+                auto r = za * zb;
+                do_not_optimize(r);
+            });
+        runner.run("complex/divide" + sfx, n, 3 * n * 2 * f32,
+            [&]
+            {
+                auto r = za / zb;
+                do_not_optimize(r);
+            });
+        runner.run("complex/abs" + sfx, n, n * 3 * f32,
+            [&]
+            {
+                auto r = nc::Utils::abs(za);
+                do_not_optimize(r);
+            });
+
+        // Integer conversions and mixed-type promotion.
+        runner.run("astype/f32_to_i32" + sfx, n, n * 2 * f32,
+            [&]
+            {
+                auto r = a.astype<nc::int32>();
+                do_not_optimize(r);
+            });
+        runner.run("astype/f32_to_u8_round" + sfx, n, n * (f32 + 1),
+            [&]
+            {
+                auto r = a.astype<nc::uint8>(nc::Core::CastMode::Round);
+                do_not_optimize(r);
+            });
+        auto ints = a.astype<nc::int32>();
+        runner.run("arith/mixed_add" + sfx, n, n * (2 * f32 + 8),
+            [&]
+            {
+                auto r = ints + b;
+                do_not_optimize(r);
+            });
+
+        // Float matmul and an einsum chain against the same weights.
+        auto proj = ND_ARRAY<nc::float32>(nc::shape_t({64, 16}));
+        fill(proj);
+
+        runner.run("linalg/matmul" + sfx, macs, (n + (n / COLS) * 64) * f32,
+            [&]
+            {
+                auto r = nc::Linalg::matmul(a, weights);
+                do_not_optimize(r);
+            });
+        runner.run("linalg/einsum_chain" + sfx, macs, n * f32,
+            [&]
+            {
+                auto r = nc::Linalg::einsum("ij,jk,kl->il", a, weights, proj);
+                do_not_optimize(r);
+            });
+
+        // Feature crossing: outer and Kronecker products writing n elements,
+        // and a tensordot over a transposed view.
+        auto col = ND_ARRAY<nc::float32>(nc::shape_t({n / COLS}));
+        auto tile = ND_ARRAY<nc::float32>(nc::shape_t({4, 4}));
+        auto quarter = ND_ARRAY<nc::float32>(
+            nc::shape_t({n / COLS / 4, COLS / 4}));
+        fill(col);
+        fill(tile);
+        fill(quarter);
+
+        runner.run("linalg/outer" + sfx, n, n * f32,
+            [&]
+            {
+                auto r = nc::Linalg::outer(col, row);
+                do_not_optimize(r);
+            });
+        runner.run("linalg/kron" + sfx, n, n * f32,
+            [&]
+            {
+                auto r = nc::Linalg::kron(tile, quarter);
+                do_not_optimize(r);
+            });
+        runner.run("linalg/tensordot_view" + sfx, macs,
+            (n + (n / COLS) * 64) * f32,
+            [&]
+            {
+                auto r = nc::Linalg::tensordot(
+                    transposed, weights, {0}, {0});
+                do_not_optimize(r);
+            });
+
+        // Batches of small regressions: 8x8 diagonally dominant systems.
+        auto systems = ND_ARRAY<nc::float32>(nc::shape_t({n / 64, 8, 8}));
+        auto rhs = ND_ARRAY<nc::float32>(nc::shape_t({n / 64, 8}));
+        fill(rhs);
+
+        for (nc::size_t i = 0; i < systems.size(); ++i)
+            systems.set(
+                i, nc::float32((i * 7919) % 13) + (i % 9 == 0 ? 64 : 0));
+
+        runner.run("linalg/solve_8x8" + sfx, n, (n + n / 8) * f32,
+            [&]
+            {
+                auto r = nc::Linalg::solve(systems, rhs);
+                do_not_optimize(r);
+            });
+        runner.run("linalg/qr_8x8" + sfx, n, 3 * n * f32,
+            [&]
+            {
+                auto r = nc::Linalg::qr(systems);
+                do_not_optimize(r);
+            });
+
+        // Factories.
+        runner.run("factory/zeros" + sfx, n, 0,
+            [&]
+            {
+                auto r = nc::Utils::zeros<nc::float32>(shape);
+                do_not_optimize(r);
+            });
+        runner.run("factory/full" + sfx, n, n * f32,
+            [&]
+            {
+                auto r = nc::Utils::full<nc::float32>(shape, 1.5f);
+                do_not_optimize(r);
+            });
+
+        // Chunked sum on the shared pool.
+        const nc::float32* a_data = a.data();
+
+        runner.run("parallel/reduce_sum" + sfx, n, n * f32,
+            [&]
+            {
+                double r = nc::Utils::parallel_reduce(0, n, 16384, 0.0,
+                    [&](nc::size_t lo, nc::size_t hi)
+                    {
+                        double t = 0;
+                        for (nc::size_t i = lo; i < hi; ++i)
+                            t += a_data[i];
+                        return t;
+                    },
+                    [](double x, double y) { return x + y; });
+                do_not_optimize(r);
+            });
+
+        // Independent array additions submitted to a task graph.
+        nc::Utils::TaskGraph graph;
+        auto add = [](const ND_ARRAY<nc::float32>& lhs,
+            const ND_ARRAY<nc::float32>& rhs) { return lhs + rhs; };
+
+        runner.run("async/array_add_x4" + sfx, 4 * n, 12 * n * f32,
+            [&]
+            {
+                for (int k = 0; k < 4; ++k)
+                    graph.async(add, a, b);
+
+                graph.wait_all();
+            });
+
+        // Memory indexers.
+        runner.run("indexer/sliced" + sfx, n_sliced, 0,
+            [&] { do_not_optimize(index_all(sliced, n_sliced)); });
+        runner.run("indexer/transposed" + sfx, n, 0,
+            [&] { do_not_optimize(index_all(transposed, n)); });
+        runner.run("indexer/reshaped" + sfx, n, 0,
+            [&] { do_not_optimize(index_all(reshaped, n)); });
+
+        // Printing. Full formatting only on the cache resident sizes, the
+        // summarized form on every size.
+        NullBuffer null_buffer;
+        std::ostream null_stream(&null_buffer);
+
+        if (with_print)
+        {
+            nc::Utils::PrintOptions full;
+            full.threshold = n;
+
+            runner.run("print_array/full" + sfx, n, n * f32,
+                [&] { nc::Utils::print_array(a, null_stream, full); });
+        }
+
+        runner.run("print_array/summary" + sfx, n, 0,
+            [&] { nc::Utils::print_array(a, null_stream); });
+
+        if (with_print)
+        {
+            nc::Utils::PrintOptions full;
+            full.threshold = n;
+
+            runner.run("print_array/complex" + sfx, n, n * 2 * f32,
+                [&] { nc::Utils::print_array(za, null_stream, full); });
+        }
+
+        // Text files, only on the cache resident sizes.
+        if (with_print)
+        {
+            const std::string path = "numc_bench_" + std::to_string(n) + ".csv";
+
+            runner.run("io/savetxt" + sfx, n, n * f32,
+                [&] { nc::Utils::savetxt(path, a); });
+            runner.run("io/loadtxt" + sfx, n, n * f32,
+                [&]
+                {
+                    auto r = nc::Utils::loadtxt<nc::float32>(path);
+                    do_not_optimize(r);
+                });
+
+            std::remove(path.c_str());
+        }
+    }
+
+    void usage(const char* prog)
+    {
+        std::fprintf(
+            stderr,
+            "Usage: %s [--quick] [--min-time SECONDS] [--filter SUBSTR] "
+            "[--json FILE]\n"
+            "  Runs the NumC kernels over sizes from L1 to DRAM resident and\n"
+            "  writes the results as JSON (stdout unless --json is given).\n",
+            prog);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double min_time = 0.2;
+    bool quick = false;
+    std::string filter, json_path;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--min-time" && i + 1 < argc)
+            min_time = std::atof(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else if (arg == "--json" && i + 1 < argc)
+            json_path = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    // 16 KB (L1), 256 KB (L2), 4 MB (L3) and 64 MB (DRAM) of float32.
+    std::vector<nc::size_t> sizes = {4096, 65536, 1048576, 16777216};
+
+    if (quick)
+        sizes = {4096, 65536};
+
+    Runner runner(min_time, filter);
+
+    for (auto n : sizes)
+        bench_size(runner, n, n <= 65536);
+
+    if (json_path.empty())
+    {
+        runner.write_json(std::cout);
+    }
+    else
+    {
+        std::ofstream out(json_path);
+        runner.write_json(out);
+    }
+
+    return 0;
+}
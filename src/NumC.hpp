@@ -1,3 +1,13 @@
 #pragma once
 
-#include <NumC/Utils/ContainerUtils.hpp>
\ No newline at end of file
+#include <NumC/Core/StaticNdArray.hpp>
+#include <NumC/Linalg/Einsum.hpp>
+#include <NumC/Linalg/Products.hpp>
+#include <NumC/Linalg/Solve.hpp>
+#include <NumC/Quant/QuantizedArray.hpp>
+#include <NumC/Sparse/CsrArray.hpp>
+#include <NumC/Utils/ComplexUtils.hpp>
+#include <NumC/Utils/ContainerUtils.hpp>
+#include <NumC/Utils/CreationUtils.hpp>
+#include <NumC/Utils/IOUtils.hpp>
+#include <NumC/Utils/TaskGraph.hpp>
\ No newline at end of file
@@ -0,0 +1,597 @@
+#pragma once
+
+#include <NumC/Core/Half.hpp>
+#include <NumC/Core/Type.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief How astype() maps values outside the integer range.
+        enum class CastMode
+        {
+            /**
+             * @brief Plain C++ conversion: fractions are truncated, integers
+             * wrap and out of range floats give unspecified values.
+             */
+            Truncate,
+
+            /**
+             * @brief Fractions are truncated, values are clamped to the
+             * destination range and NaN gives 0.
+             */
+            Saturate,
+
+            /**
+             * @brief Rounds to nearest, ties to even, then saturates.
+             */
+            Round
+        };
+
+        namespace Detail
+        {
+            template<bool C, typename A, typename B>
+            using if_t = typename std::conditional<C, A, B>::type;
+
+            /// @brief Type category: 0 integer, 1 real, 2 complex.
+            template<typename T>
+            struct Category : std::integral_constant<
+                int, std::is_integral<T>::value ? 0 : 1>
+            {};
+
+            template<typename T>
+            struct Category<std::complex<T>> : std::integral_constant<int, 2>
+            {};
+
+            /// @brief Signed integer of a byte width. 16 bytes (int64 mixed
+            /// with uint64) falls back to float64 as in NumPy.
+            template<int Bytes>
+            struct SignedOfSize;
+
+            template<> struct SignedOfSize<2> { using type = int16; };
+            template<> struct SignedOfSize<4> { using type = int32; };
+            template<> struct SignedOfSize<8> { using type = int64; };
+            template<> struct SignedOfSize<16> { using type = float64; };
+
+            /**
+             * @brief Result type of a mixed operation, following NumPy:
+             * the smallest type of the highest category that represents
+             * both operands.
+             *
+             * @tparam L Lhs element type.
+             * @tparam R Rhs element type.
+             */
+            template<
+                typename L,
+                typename R,
+                int CL = Category<L>::value,
+                int CR = Category<R>::value>
+            struct Promote;
+
+            // Integers: the wider of the same signedness, else a signed type
+            // wider than the unsigned one.
+            template<typename L, typename R>
+            struct Promote<L, R, 0, 0>
+            {
+                using S = if_t<std::is_signed<L>::value, L, R>;
+                using U = if_t<std::is_signed<L>::value, R, L>;
+
+                using type = if_t<
+                    std::is_signed<L>::value == std::is_signed<R>::value,
+                    if_t<(sizeof(L) >= sizeof(R)), L, R>,
+                    if_t<
+                        (sizeof(U) < sizeof(S)),
+                        S,
+                        typename SignedOfSize<2 * sizeof(U)>::type>>;
+            };
+
+            // Reals: the wider one. float16 with bfloat16 gives float32.
+            template<typename L, typename R>
+            struct Promote<L, R, 1, 1>
+            {
+                using type = if_t<
+                    std::is_same<L, R>::value,
+                    L,
+                    if_t<
+                        sizeof(L) == sizeof(R),
+                        float32,
+                        if_t<(sizeof(L) > sizeof(R)), L, R>>>;
+            };
+
+            // Integer with real: 8 bit integers fit any real, 16 bit ones
+            // need float32 and wider ones float64.
+            template<typename L, typename R>
+            struct Promote<L, R, 0, 1>
+            {
+                using type = if_t<
+                    sizeof(L) == 1,
+                    R,
+                    if_t<
+                        sizeof(L) == 2,
+                        typename Promote<R, float32>::type,
+                        float64>>;
+            };
+
+            template<typename L, typename R>
+            struct Promote<L, R, 1, 0>
+            {
+                using type = typename Promote<R, L>::type;
+            };
+
+            // Complex: promote the components, complex64 at least.
+            template<typename L, typename R>
+            struct Promote<std::complex<L>, R, 2, 0>
+            {
+                using real_t = typename Promote<L, R>::type;
+                using type = std::complex<
+                    if_t<(sizeof(real_t) <= 4), float32, float64>>;
+            };
+
+            template<typename L, typename R>
+            struct Promote<std::complex<L>, R, 2, 1> :
+                Promote<std::complex<L>, R, 2, 0>
+            {};
+
+            template<typename L, typename R>
+            struct Promote<std::complex<L>, std::complex<R>, 2, 2> :
+                Promote<std::complex<L>, R, 2, 0>
+            {};
+
+            template<typename L, typename R, int CL>
+            struct Promote<L, std::complex<R>, CL, 2> :
+                Promote<std::complex<R>, L, 2, CL>
+            {};
+
+            /**
+             * @brief Converts one element. Half types go through float32 and
+             * complex to real conversions keep the real part, as in NumPy.
+             *
+             * @tparam S Source element type.
+             * @tparam D Destination element type.
+             */
+            template<typename S, typename D>
+            struct Convert
+            {
+                static D apply(S x) { return static_cast<D>(x); }
+            };
+
+            template<typename D>
+            struct Convert<Float16, D>
+            {
+                static D apply(Float16 x)
+                {
+                    return Convert<float32, D>::apply(float32(x));
+                }
+            };
+
+            template<typename D>
+            struct Convert<BFloat16, D>
+            {
+                static D apply(BFloat16 x)
+                {
+                    return Convert<float32, D>::apply(float32(x));
+                }
+            };
+
+            template<typename T, typename D>
+            struct Convert<std::complex<T>, D>
+            {
+                static D apply(std::complex<T> x)
+                {
+                    return Convert<T, D>::apply(x.real());
+                }
+            };
+
+            template<typename T, typename U>
+            struct Convert<std::complex<T>, std::complex<U>>
+            {
+                static std::complex<U> apply(std::complex<T> x)
+                {
+                    return std::complex<U>(x);
+                }
+            };
+
+            /// @brief x < 0 without sign comparison warnings.
+            template<typename T>
+            bool is_negative(T x, std::true_type) { return x < T(0); }
+
+            template<typename T>
+            bool is_negative(T, std::false_type) { return false; }
+
+            /// @brief Clamps an integer into another integer type.
+            template<typename S, typename D>
+            D saturate(S x, bool, std::true_type)
+            {
+                if (is_negative(x, std::is_signed<S>()))
+                    return int64(x) < int64(std::numeric_limits<D>::min()) ?
+                        std::numeric_limits<D>::min() : D(x);
+
+                return uint64(x) > uint64(std::numeric_limits<D>::max()) ?
+                    std::numeric_limits<D>::max() : D(x);
+            }
+
+            /// @brief Rounds or truncates a non-integer, then clamps it into
+            /// an integer type. NaN gives 0.
+            template<typename S, typename D>
+            D saturate(S x, bool round, std::false_type)
+            {
+                float64 v = Convert<S, float64>::apply(x);
+
+                if (std::isnan(v))
+                    return D(0);
+
+                v = round ? std::nearbyint(v) : std::trunc(v);
+
+                // Bounds as float64 are exact powers of 2 (or 0), so values
+                // past them clamp and values inside convert exactly.
+                if (v <= float64(std::numeric_limits<D>::min()))
+                    return std::numeric_limits<D>::min();
+                if (v >= float64(std::numeric_limits<D>::max()))
+                    return std::numeric_limits<D>::max();
+
+                return D(v);
+            }
+
+            /**
+             * @brief Converts n elements with Convert. Pairs with a dedicated
+             * kernel are overloads of this function.
+             *
+             * @tparam S Source element type.
+             * @tparam D Destination element type.
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             */
+            template<typename S, typename D>
+            void cast_chunk(const S* in, D* out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = Convert<S, D>::apply(in[i]);
+            }
+
+            /**
+             * @brief Converts n elements into an integer type, clamping to
+             * its range. Pairs with a dedicated kernel are overloads of this
+             * function.
+             *
+             * @tparam S Source element type.
+             * @tparam D Integer destination element type.
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             * @param round Round to nearest rather than truncate.
+             */
+            template<typename S, typename D>
+            void saturate_chunk(const S* in, D* out, size_t n, bool round)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = saturate<S, D>(
+                        in[i], round, std::is_integral<S>());
+            }
+
+#if defined(__SSE2__)
+            inline void cast_chunk(const float32* in, int32* out, size_t n)
+            {
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        _mm_cvttps_epi32(_mm_loadu_ps(in + i)));
+
+                for (; i < n; ++i)
+                    out[i] = int32(in[i]);
+            }
+
+            inline void cast_chunk(const int32* in, float32* out, size_t n)
+            {
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(
+                        out + i,
+                        _mm_cvtepi32_ps(
+                            _mm_loadu_si128((const __m128i*)(in + i))));
+
+                for (; i < n; ++i)
+                    out[i] = float32(in[i]);
+            }
+
+            inline void cast_chunk(const float32* in, float64* out, size_t n)
+            {
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m128 v = _mm_loadu_ps(in + i);
+
+                    _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+                    _mm_storeu_pd(
+                        out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = float64(in[i]);
+            }
+
+            inline void cast_chunk(const float64* in, float32* out, size_t n)
+            {
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(
+                        out + i,
+                        _mm_movelh_ps(
+                            _mm_cvtpd_ps(_mm_loadu_pd(in + i)),
+                            _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2))));
+
+                for (; i < n; ++i)
+                    out[i] = float32(in[i]);
+            }
+
+            inline void cast_chunk(const uint8* in, float32* out, size_t n)
+            {
+                size_t i = 0;
+                const __m128i zero = _mm_setzero_si128();
+
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+                    __m128i lo = _mm_unpacklo_epi8(v, zero);
+                    __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+                    _mm_storeu_ps(
+                        out + i,
+                        _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+                    _mm_storeu_ps(
+                        out + i + 4,
+                        _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+                    _mm_storeu_ps(
+                        out + i + 8,
+                        _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+                    _mm_storeu_ps(
+                        out + i + 12,
+                        _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = float32(in[i]);
+            }
+
+            /**
+             * @brief 4 float32 to int32, rounded or truncated, NaN as 0 and
+             * clamped to the int32 range.
+             */
+            inline __m128i saturate_epi32(__m128 v, bool round)
+            {
+                // cvt gives INT32_MIN past either bound: fix the top one.
+                const __m128 top = _mm_set1_ps(2147483648.0f);
+                __m128 over = _mm_cmpge_ps(v, top);
+
+                v = _mm_and_ps(v, _mm_cmpord_ps(v, v));
+
+                __m128i r = round ? _mm_cvtps_epi32(v) : _mm_cvttps_epi32(v);
+
+                return _mm_xor_si128(r, _mm_castps_si128(over));
+            }
+
+            inline void saturate_chunk(
+                const float32* in,
+                int32* out,
+                size_t n,
+                bool round)
+            {
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        saturate_epi32(_mm_loadu_ps(in + i), round));
+
+                for (; i < n; ++i)
+                    out[i] = saturate<float32, int32>(
+                        in[i], round, std::false_type());
+            }
+
+            /**
+             * @brief 16 float32 to 8 bit integers, saturated through the 16
+             * bit packs.
+             */
+            template<typename D>
+            void saturate_bytes(
+                const float32* in,
+                D* out,
+                size_t n,
+                bool round)
+            {
+                size_t i = 0;
+
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i a = saturate_epi32(_mm_loadu_ps(in + i), round);
+                    __m128i b = saturate_epi32(_mm_loadu_ps(in + i + 4), round);
+                    __m128i c = saturate_epi32(_mm_loadu_ps(in + i + 8), round);
+                    __m128i d =
+                        saturate_epi32(_mm_loadu_ps(in + i + 12), round);
+                    __m128i lo = _mm_packs_epi32(a, b);
+                    __m128i hi = _mm_packs_epi32(c, d);
+
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        std::is_signed<D>::value ?
+                            _mm_packs_epi16(lo, hi) : _mm_packus_epi16(lo, hi));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = saturate<float32, D>(
+                        in[i], round, std::false_type());
+            }
+
+            inline void saturate_chunk(
+                const float32* in,
+                uint8* out,
+                size_t n,
+                bool round)
+            {
+                saturate_bytes(in, out, n, round);
+            }
+
+            inline void saturate_chunk(
+                const float32* in,
+                int8* out,
+                size_t n,
+                bool round)
+            {
+                saturate_bytes(in, out, n, round);
+            }
+
+            inline void saturate_chunk(
+                const int32* in,
+                int16* out,
+                size_t n,
+                bool)
+            {
+                size_t i = 0;
+
+                for (; i + 8 <= n; i += 8)
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        _mm_packs_epi32(
+                            _mm_loadu_si128((const __m128i*)(in + i)),
+                            _mm_loadu_si128((const __m128i*)(in + i + 4))));
+
+                for (; i < n; ++i)
+                    out[i] = saturate<int32, int16>(
+                        in[i], false, std::true_type());
+            }
+
+            inline void saturate_chunk(
+                const int16* in,
+                uint8* out,
+                size_t n,
+                bool)
+            {
+                size_t i = 0;
+
+                for (; i + 16 <= n; i += 16)
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        _mm_packus_epi16(
+                            _mm_loadu_si128((const __m128i*)(in + i)),
+                            _mm_loadu_si128((const __m128i*)(in + i + 8))));
+
+                for (; i < n; ++i)
+                    out[i] = saturate<int16, uint8>(
+                        in[i], false, std::true_type());
+            }
+
+            inline void saturate_chunk(
+                const int16* in,
+                int8* out,
+                size_t n,
+                bool)
+            {
+                size_t i = 0;
+
+                for (; i + 16 <= n; i += 16)
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        _mm_packs_epi16(
+                            _mm_loadu_si128((const __m128i*)(in + i)),
+                            _mm_loadu_si128((const __m128i*)(in + i + 8))));
+
+                for (; i < n; ++i)
+                    out[i] = saturate<int16, int8>(
+                        in[i], false, std::true_type());
+            }
+#endif
+
+            /**
+             * @brief Converts n elements in the given mode. Saturate and
+             * Round only differ from Truncate for integer destinations.
+             */
+            template<typename S, typename D>
+            void convert_chunk(
+                const S* in,
+                D* out,
+                size_t n,
+                CastMode mode,
+                std::true_type)
+            {
+                if (mode == CastMode::Truncate)
+                    cast_chunk(in, out, n);
+                else
+                    saturate_chunk(in, out, n, mode == CastMode::Round);
+            }
+
+            template<typename S, typename D>
+            void convert_chunk(
+                const S* in,
+                D* out,
+                size_t n,
+                CastMode,
+                std::false_type)
+            {
+                cast_chunk(in, out, n);
+            }
+        }
+
+        /**
+         * @brief Element type of a mixed operation between L and R, following
+         * NumPy's promotion rules, e.g. int32 with float32 gives float64.
+         *
+         * @tparam L Lhs element type.
+         * @tparam R Rhs element type.
+         */
+        template<typename L, typename R>
+        using promote_t = typename Detail::Promote<L, R>::type;
+
+        /// @brief Elements converted per parallel task by cast_buffer().
+        const size_t CAST_GRAIN = size_t(1) << 16;
+
+        /**
+         * @brief Converts count elements from one buffer into another of a
+         * different type, in parallel chunks of CAST_GRAIN elements.
+         *
+         * @tparam S Source element type.
+         * @tparam D Destination element type.
+         * @param in Input buffer.
+         * @param out Output buffer.
+         * @param count Number of elements.
+         * @param mode Handling of values outside an integer destination's
+         * range. Defaults to CastMode::Truncate.
+         */
+        template<typename S, typename D>
+        void cast_buffer(
+            const S* in,
+            D* out,
+            size_t count,
+            CastMode mode = CastMode::Truncate)
+        {
+            Utils::parallel_for(
+                0,
+                count,
+                CAST_GRAIN,
+                [=](size_t lo, size_t hi)
+                {
+                    Detail::convert_chunk(
+                        in + lo,
+                        out + lo,
+                        hi - lo,
+                        mode,
+                        std::is_integral<D>());
+                });
+        }
+    }
+}
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <NumC/Core/Type.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <cmath>
+#include <complex>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief Element-wise arithmetic operation.
+        enum class ElementOp
+        {
+            Add,
+            Subtract,
+            Multiply,
+            Divide
+        };
+
+        namespace Detail
+        {
+            /// @brief Elements processed per parallel task by the kernels.
+            const size_t KERNEL_GRAIN = size_t(1) << 15;
+
+            /**
+             * @brief Type a scalar operand is converted to before an
+             * element-wise operation with a T: float64 for real types, the
+             * component type for complex ones.
+             *
+             * @tparam T Array element type.
+             */
+            template<typename T>
+            struct ScalarType
+            {
+                using type = float64;
+            };
+
+            template<typename T>
+            struct ScalarType<std::complex<T>>
+            {
+                using type = T;
+            };
+
+            /**
+             * @brief Dedicated kernel for an element-wise operation between
+             * two contiguous arrays of the same shape. apply() returns false
+             * when the type triple has none.
+             *
+             * @tparam L Lhs element type.
+             * @tparam R Rhs element type.
+             * @tparam O Result element type.
+             */
+            template<typename L, typename R, typename O>
+            struct ElementKernel
+            {
+                static bool apply(ElementOp, const L*, const R*, O*, size_t)
+                {
+                    return false;
+                }
+            };
+
+            /**
+             * @brief Dedicated kernel for an element-wise operation between a
+             * contiguous array and a scalar. apply() returns false when the
+             * type has none.
+             *
+             * @tparam T Element type.
+             */
+            template<typename T>
+            struct ScalarKernel
+            {
+                using scalar_t = typename ScalarType<T>::type;
+
+                static bool apply(ElementOp, const T*, scalar_t, T*, size_t)
+                {
+                    return false;
+                }
+            };
+
+#if defined(__SSE2__)
+            // SSE2 helpers on interleaved (real, imag) pairs, overloaded
+            // for 2 complex64 or 1 complex128 per register.
+
+            inline __m128 load(const float* p) { return _mm_loadu_ps(p); }
+            inline __m128d load(const double* p) { return _mm_loadu_pd(p); }
+            inline void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+            inline void store(double* p, __m128d v) { _mm_storeu_pd(p, v); }
+
+            inline __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+            inline __m128d add(__m128d a, __m128d b)
+            {
+                return _mm_add_pd(a, b);
+            }
+
+            inline __m128 sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+            inline __m128d sub(__m128d a, __m128d b)
+            {
+                return _mm_sub_pd(a, b);
+            }
+
+            inline __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+            inline __m128d mul(__m128d a, __m128d b)
+            {
+                return _mm_mul_pd(a, b);
+            }
+
+            inline __m128 div(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+            inline __m128d div(__m128d a, __m128d b)
+            {
+                return _mm_div_pd(a, b);
+            }
+
+            inline __m128 flip(__m128 a, __m128 m) { return _mm_xor_ps(a, m); }
+            inline __m128d flip(__m128d a, __m128d m)
+            {
+                return _mm_xor_pd(a, m);
+            }
+
+            /// @brief Register of (real, imag) pairs.
+            inline __m128 pairs(float real, float imag)
+            {
+                return _mm_set_ps(imag, real, imag, real);
+            }
+            inline __m128d pairs(double real, double imag)
+            {
+                return _mm_set_pd(imag, real);
+            }
+
+            /// @brief (re, im) -> (im, re).
+            inline __m128 swap_pairs(__m128 v)
+            {
+                return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+            }
+            inline __m128d swap_pairs(__m128d v)
+            {
+                return _mm_shuffle_pd(v, v, 1);
+            }
+
+            /// @brief (re, im) -> (re, re).
+            inline __m128 dup_real(__m128 v)
+            {
+                return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+            }
+            inline __m128d dup_real(__m128d v)
+            {
+                return _mm_unpacklo_pd(v, v);
+            }
+
+            /// @brief (re, im) -> (im, im).
+            inline __m128 dup_imag(__m128 v)
+            {
+                return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+            }
+            inline __m128d dup_imag(__m128d v)
+            {
+                return _mm_unpackhi_pd(v, v);
+            }
+
+            /**
+             * @brief Complex product of interleaved pairs:
+             * (a + bi)(c + di) = (ac - bd) + (bc + ad)i.
+             */
+            template<typename V, typename T>
+            V complex_mul(V x, V y, T)
+            {
+                return add(
+                    mul(x, dup_real(y)),
+                    flip(mul(swap_pairs(x), dup_imag(y)), pairs(-T(0), T(0))));
+            }
+
+            /**
+             * @brief Complex64 quotient of 2 pairs, computed in float64 so
+             * that c^2 + d^2 cannot overflow or underflow.
+             */
+            inline __m128 complex_div(__m128 x, __m128 y)
+            {
+                const __m128d sign = pairs(0.0, -0.0);
+                __m128d r[2];
+
+                for (int half = 0; half < 2; ++half)
+                {
+                    __m128d xd = _mm_cvtps_pd(x);
+                    __m128d yd = _mm_cvtps_pd(y);
+
+                    // (ac + bd, bc - ad) / (c^2 + d^2)
+                    __m128d num = add(
+                        mul(xd, dup_real(yd)),
+                        flip(mul(swap_pairs(xd), dup_imag(yd)), sign));
+                    __m128d sq = mul(yd, yd);
+
+                    r[half] = div(num, add(sq, swap_pairs(sq)));
+                    x = _mm_movehl_ps(x, x);
+                    y = _mm_movehl_ps(y, y);
+                }
+
+                return _mm_movelh_ps(
+                    _mm_cvtpd_ps(r[0]), _mm_cvtpd_ps(r[1]));
+            }
+
+            /**
+             * @brief Complex128 quotient. Done by std::complex so that its
+             * overflow scaling is kept.
+             */
+            inline __m128d complex_div(__m128d x, __m128d y)
+            {
+                std::complex<double> a, b;
+
+                _mm_storeu_pd((double*)&a, x);
+                _mm_storeu_pd((double*)&b, y);
+                a /= b;
+
+                return _mm_loadu_pd((const double*)&a);
+            }
+#endif
+
+            /**
+             * @brief Element-wise kernels on contiguous complex64 or
+             * complex128 buffers, read as interleaved (real, imag) pairs.
+             *
+             * @note Products and quotients follow the textbook formulas: the
+             * C99 Annex G recovery of infinite results from NaN parts is not
+             * done.
+             *
+             * @tparam T Component type, float32 or float64.
+             */
+            template<typename T>
+            struct ComplexKernel
+            {
+                using complex_t = std::complex<T>;
+
+                /// @brief Complex numbers per SSE2 register.
+                static const size_t LANES = 16 / sizeof(complex_t);
+
+                static bool apply(
+                    ElementOp op,
+                    const complex_t* a,
+                    const complex_t* b,
+                    complex_t* out,
+                    size_t n)
+                {
+                    Utils::parallel_for(
+                        0,
+                        n,
+                        KERNEL_GRAIN,
+                        [=](size_t lo, size_t hi)
+                        {
+                            binary(op, a, b, out, lo, hi);
+                        });
+
+                    return true;
+                }
+
+                static bool apply(
+                    ElementOp op,
+                    const complex_t* a,
+                    T s,
+                    complex_t* out,
+                    size_t n)
+                {
+                    Utils::parallel_for(
+                        0,
+                        n,
+                        KERNEL_GRAIN,
+                        [=](size_t lo, size_t hi)
+                        {
+                            scalar(op, a, s, out, lo, hi);
+                        });
+
+                    return true;
+                }
+
+                /// @brief a[i] op b[i] for i in [lo, hi).
+                static void binary(
+                    ElementOp op,
+                    const complex_t* a,
+                    const complex_t* b,
+                    complex_t* out,
+                    size_t lo,
+                    size_t hi)
+                {
+                    size_t i = lo;
+#if defined(__SSE2__)
+                    const T* x = (const T*)a;
+                    const T* y = (const T*)b;
+                    T* z = (T*)out;
+
+                    for (; i + LANES <= hi; i += LANES)
+                    {
+                        auto vx = load(x + 2 * i);
+                        auto vy = load(y + 2 * i);
+
+                        switch (op)
+                        {
+                            case ElementOp::Add:
+                                store(z + 2 * i, add(vx, vy));
+                                break;
+                            case ElementOp::Subtract:
+                                store(z + 2 * i, sub(vx, vy));
+                                break;
+                            case ElementOp::Multiply:
+                                store(z + 2 * i, complex_mul(vx, vy, T()));
+                                break;
+                            case ElementOp::Divide:
+                                store(z + 2 * i, complex_div(vx, vy));
+                                break;
+                        }
+                    }
+#endif
+                    for (; i < hi; ++i)
+                        out[i] = scalar_op(op, a[i], b[i]);
+                }
+
+                /// @brief a[i] op s for i in [lo, hi).
+                static void scalar(
+                    ElementOp op,
+                    const complex_t* a,
+                    T s,
+                    complex_t* out,
+                    size_t lo,
+                    size_t hi)
+                {
+                    size_t i = lo;
+#if defined(__SSE2__)
+                    const T* x = (const T*)a;
+                    T* z = (T*)out;
+                    const bool additive =
+                        op == ElementOp::Add || op == ElementOp::Subtract;
+                    const T sign = op == ElementOp::Subtract ? T(-1) : T(1);
+                    const auto vs = additive ?
+                        pairs(sign * s, T(0)) : pairs(s, s);
+
+                    for (; i + LANES <= hi; i += LANES)
+                    {
+                        auto vx = load(x + 2 * i);
+
+                        store(
+                            z + 2 * i,
+                            additive ? add(vx, vs) :
+                                op == ElementOp::Multiply ?
+                                    mul(vx, vs) : div(vx, vs));
+                    }
+#endif
+                    for (; i < hi; ++i)
+                        out[i] = scalar_op(op, a[i], complex_t(s));
+                }
+
+                /// @brief One element, through std::complex.
+                static complex_t scalar_op(
+                    ElementOp op,
+                    complex_t x,
+                    complex_t y)
+                {
+                    switch (op)
+                    {
+                        case ElementOp::Add: return x + y;
+                        case ElementOp::Subtract: return x - y;
+                        case ElementOp::Multiply: return x * y;
+                        default: return x / y;
+                    }
+                }
+            };
+
+            template<>
+            struct ElementKernel<complex64, complex64, complex64> :
+                ComplexKernel<float32>
+            {};
+
+            template<>
+            struct ElementKernel<complex128, complex128, complex128> :
+                ComplexKernel<float64>
+            {};
+
+            template<>
+            struct ScalarKernel<complex64> : ComplexKernel<float32> {};
+
+            template<>
+            struct ScalarKernel<complex128> : ComplexKernel<float64> {};
+
+            /**
+             * @brief Absolute values of n contiguous complex numbers.
+             * Complex64 is computed in float64, complex128 with hypot.
+             *
+             * @tparam T Component type.
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param lo First index.
+             * @param hi Last index + 1.
+             */
+            template<typename T>
+            void complex_abs(
+                const std::complex<T>* in,
+                T* out,
+                size_t lo,
+                size_t hi)
+            {
+                for (size_t i = lo; i < hi; ++i)
+                    out[i] = std::hypot(in[i].real(), in[i].imag());
+            }
+
+            inline void complex_abs(
+                const complex64* in,
+                float32* out,
+                size_t lo,
+                size_t hi)
+            {
+                size_t i = lo;
+#if defined(__SSE2__)
+                const float32* x = (const float32*)in;
+
+                for (; i + 2 <= hi; i += 2)
+                {
+                    __m128 v = load(x + 2 * i);
+                    __m128d lo_sq = _mm_cvtps_pd(v);
+                    __m128d hi_sq = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+
+                    lo_sq = mul(lo_sq, lo_sq);
+                    hi_sq = mul(hi_sq, hi_sq);
+
+                    // Lane 0 of each sum holds re^2 + im^2.
+                    __m128d sums = _mm_unpacklo_pd(
+                        add(lo_sq, swap_pairs(lo_sq)),
+                        add(hi_sq, swap_pairs(hi_sq)));
+
+                    _mm_storel_pi(
+                        (__m64*)(out + i),
+                        _mm_cvtpd_ps(_mm_sqrt_pd(sums)));
+                }
+#endif
+                for (; i < hi; ++i)
+                {
+                    float64 re = in[i].real(), im = in[i].imag();
+
+                    out[i] = float32(std::sqrt(re * re + im * im));
+                }
+            }
+
+            /**
+             * @brief Conjugates of n contiguous complex numbers.
+             *
+             * @tparam T Component type.
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param lo First index.
+             * @param hi Last index + 1.
+             */
+            template<typename T>
+            void complex_conj(
+                const std::complex<T>* in,
+                std::complex<T>* out,
+                size_t lo,
+                size_t hi)
+            {
+                size_t i = lo;
+#if defined(__SSE2__)
+                const size_t lanes = ComplexKernel<T>::LANES;
+                const auto sign = pairs(T(0), -T(0));
+
+                for (; i + lanes <= hi; i += lanes)
+                    store(
+                        (T*)(out + i),
+                        flip(load((const T*)(in + i)), sign));
+#endif
+                for (; i < hi; ++i)
+                    out[i] = std::conj(in[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#define NUMC_ERROR NumC::Core::Error
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Validation that always runs, regardless of build mode. Used for
+ * construction-time checks (shapes, slices, axes, ...).
+ *
+ * @param condition Condition expected to hold.
+ * @param code NumC::Core::ErrorCode reported on failure.
+ * @param message Error description.
+ */
+#define NUMC_CHECK(condition, code, message) \
+    do \
+    { \
+        if (!(condition)) \
+            throw NumC::Core::Error((code), (message)); \
+    } \
+    while (0)
+
+/**
+ * @brief Per-element validation (bounds checks in get/set, iterator
+ * increments, ...). Compiled out entirely when NUMC_UNCHECKED is defined so
+ * that hot loops carry no validation branches.
+ *
+ * @param condition Condition expected to hold.
+ * @param code NumC::Core::ErrorCode reported on failure.
+ * @param message Error description.
+ */
+#ifdef NUMC_UNCHECKED
+#define NUMC_ASSERT(condition, code, message) ((void)0)
+#else
+#define NUMC_ASSERT(condition, code, message) \
+    NUMC_CHECK(condition, code, message)
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief Category of a NumC error.
+        enum class ErrorCode
+        {
+            /// @brief Empty shape or non-positive/overflowing dimensions.
+            InvalidShape = 1,
+
+            /// @brief Malformed argument (nested lists, null pointers, ...).
+            InvalidArgument,
+
+            /// @brief Element or iterator index outside the array.
+            IndexOutOfBounds,
+
+            /// @brief Shapes that cannot be broadcast together.
+            BroadcastError,
+
+            /// @brief Slice indices outside the array.
+            InvalidSlice,
+
+            /// @brief Reshape to an incompatible shape.
+            InvalidReshape,
+
+            /// @brief Transpose axes that are not a permutation.
+            InvalidAxes,
+
+            /// @brief Operation not supported on this array/view type.
+            Unsupported,
+
+            /// @brief Allocation would exceed a memory tracker limit.
+            MemoryLimitExceeded,
+
+            /// @brief The system allocator failed.
+            AllocationFailed,
+
+            /// @brief A file could not be opened, mapped, read or written.
+            IOError,
+
+            /// @brief Singular, or not positive definite, matrix.
+            SingularMatrix
+        };
+
+        /**
+         * @brief Gets the readable name of an error code.
+         *
+         * @param code Error code.
+         * @return Name of the error code.
+         */
+        inline const char* error_name(ErrorCode code)
+        {
+            switch (code)
+            {
+                case ErrorCode::InvalidShape: return "InvalidShape";
+                case ErrorCode::InvalidArgument: return "InvalidArgument";
+                case ErrorCode::IndexOutOfBounds: return "IndexOutOfBounds";
+                case ErrorCode::BroadcastError: return "BroadcastError";
+                case ErrorCode::InvalidSlice: return "InvalidSlice";
+                case ErrorCode::InvalidReshape: return "InvalidReshape";
+                case ErrorCode::InvalidAxes: return "InvalidAxes";
+                case ErrorCode::Unsupported: return "Unsupported";
+                case ErrorCode::MemoryLimitExceeded:
+                    return "MemoryLimitExceeded";
+                case ErrorCode::AllocationFailed: return "AllocationFailed";
+                case ErrorCode::IOError: return "IOError";
+                case ErrorCode::SingularMatrix: return "SingularMatrix";
+            }
+
+            return "Unknown";
+        }
+
+        /**
+         * @brief Exception thrown by NumC on invalid input.
+         *
+         * @note what() reads as "<code name>: <message>".
+         */
+        class Error : public std::runtime_error
+        {
+            public:
+                /**
+                 * @brief Construct a new Error object.
+                 *
+                 * @param code Error category.
+                 * @param message Error description.
+                 */
+                Error(ErrorCode code, const std::string& message) :
+                    std::runtime_error(
+                        std::string(error_name(code)) + ": " + message),
+                    __code(code)
+                {}
+
+                /**
+                 * @brief Gets the error category.
+                 *
+                 * @return Error code.
+                 */
+                ErrorCode code() const
+                {
+                    return this->__code;
+                }
+
+            private:
+
+                /// @brief Error category.
+                ErrorCode __code;
+        };
+    }
+}
@@ -0,0 +1,452 @@
+#pragma once
+
+#include <NumC/Core/Type.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        namespace Detail
+        {
+            /// @brief Gets the bits of a float.
+            inline std::uint32_t float_bits(float value)
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                return bits;
+            }
+
+            /// @brief Builds a float from its bits.
+            inline float bits_float(std::uint32_t bits)
+            {
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+
+                return value;
+            }
+
+            /**
+             * @brief Converts a float to IEEE binary16 bits, rounding to
+             * nearest even. Out of range values become infinities, NaNs
+             * become a quiet NaN.
+             *
+             * @param value Value to be converted.
+             * @return Binary16 bits.
+             */
+            inline std::uint16_t float_to_half(float value)
+            {
+#if defined(__F16C__)
+                return std::uint16_t(_cvtss_sh(value, 0));
+#else
+                std::uint32_t bits = float_bits(value);
+                std::uint32_t sign = (bits >> 16) & 0x8000;
+                std::uint32_t out;
+
+                bits &= 0x7fffffff;
+
+                if (bits >= (127u + 16) << 23)
+                {
+                    // Overflow, infinity or NaN.
+                    out = bits > 0x7f800000 ? 0x7e00 : 0x7c00;
+                }
+                else if (bits < 113u << 23)
+                {
+                    // Subnormal or zero: the add rounds the mantissa into
+                    // place.
+                    const std::uint32_t magic = 126u << 23;
+
+                    out = float_bits(bits_float(bits) + bits_float(magic)) -
+                        magic;
+                }
+                else
+                {
+                    std::uint32_t odd = (bits >> 13) & 1;
+
+                    bits += (std::uint32_t(15 - 127) << 23) + 0xfff + odd;
+                    out = bits >> 13;
+                }
+
+                return std::uint16_t(out | sign);
+#endif
+            }
+
+            /**
+             * @brief Converts IEEE binary16 bits to a float. Exact.
+             *
+             * @param half Binary16 bits.
+             * @return Converted value.
+             */
+            inline float half_to_float(std::uint16_t half)
+            {
+#if defined(__F16C__)
+                return _cvtsh_ss(half);
+#else
+                const std::uint32_t shifted_exp = 0x7c00u << 13;
+                std::uint32_t bits = std::uint32_t(half & 0x7fff) << 13;
+                std::uint32_t exp = bits & shifted_exp;
+
+                bits += std::uint32_t(127 - 15) << 23;
+
+                if (exp == shifted_exp)
+                {
+                    // Infinity or NaN.
+                    bits += std::uint32_t(128 - 16) << 23;
+                }
+                else if (exp == 0)
+                {
+                    // Subnormal or zero: renormalized by the float unit.
+                    bits += 1u << 23;
+                    bits = float_bits(
+                        bits_float(bits) - bits_float(113u << 23));
+                }
+
+                return bits_float(bits | (std::uint32_t(half & 0x8000) << 16));
+#endif
+            }
+
+            /**
+             * @brief Converts a float to bfloat16 bits, rounding to nearest
+             * even. NaNs stay quiet NaNs.
+             *
+             * @param value Value to be converted.
+             * @return Bfloat16 bits.
+             */
+            inline std::uint16_t float_to_bfloat(float value)
+            {
+                std::uint32_t bits = float_bits(value);
+
+                if ((bits & 0x7fffffff) > 0x7f800000)
+                    return std::uint16_t((bits >> 16) | 0x40);
+
+                bits += 0x7fff + ((bits >> 16) & 1);
+
+                return std::uint16_t(bits >> 16);
+            }
+
+            /**
+             * @brief Converts bfloat16 bits to a float. Exact.
+             *
+             * @param bfloat Bfloat16 bits.
+             * @return Converted value.
+             */
+            inline float bfloat_to_float(std::uint16_t bfloat)
+            {
+                return bits_float(std::uint32_t(bfloat) << 16);
+            }
+        }
+
+        /**
+         * @brief IEEE binary16 storage type: 1 sign, 5 exponent and 10
+         * mantissa bits.
+         *
+         * @note Only storage is 16 bits wide. Values convert implicitly to
+         * float32, so arithmetic and the array operators compute in float32
+         * and round back to nearest even when stored.
+         */
+        class Float16
+        {
+            public:
+                /// @brief Default constructor. Value initialization gives 0.
+                Float16() = default;
+
+                /**
+                 * @brief Construct a new Float16 from a float.
+                 *
+                 * @param value Value to be rounded to binary16.
+                 */
+                Float16(float value) :
+                    __bits(Detail::float_to_half(value))
+                {}
+
+                /**
+                 * @brief Builds a Float16 from its bits.
+                 *
+                 * @param bits Binary16 bits.
+                 * @return New value.
+                 */
+                static Float16 from_bits(std::uint16_t bits)
+                {
+                    Float16 value;
+                    value.__bits = bits;
+
+                    return value;
+                }
+
+                /**
+                 * @brief Gets the binary16 bits.
+                 *
+                 * @return Stored bits.
+                 */
+                std::uint16_t bits() const
+                {
+                    return this->__bits;
+                }
+
+                /// @brief Widens to float32, exactly.
+                operator float() const
+                {
+                    return Detail::half_to_float(this->__bits);
+                }
+
+                /// Compound assignments, computed in float32.
+                Float16& operator+=(float rhs)
+                {
+                    return *this = float(*this) + rhs;
+                }
+
+                Float16& operator-=(float rhs)
+                {
+                    return *this = float(*this) - rhs;
+                }
+
+                Float16& operator*=(float rhs)
+                {
+                    return *this = float(*this) * rhs;
+                }
+
+                Float16& operator/=(float rhs)
+                {
+                    return *this = float(*this) / rhs;
+                }
+
+            private:
+                std::uint16_t __bits;
+        };
+
+        /**
+         * @brief Bfloat16 storage type: the upper 16 bits of a float32, with
+         * its 8 exponent bits and 7 mantissa bits.
+         *
+         * @note Same arithmetic model as Float16: computed in float32 and
+         * rounded to nearest even when stored.
+         */
+        class BFloat16
+        {
+            public:
+                /// @brief Default constructor. Value initialization gives 0.
+                BFloat16() = default;
+
+                /**
+                 * @brief Construct a new BFloat16 from a float.
+                 *
+                 * @param value Value to be rounded to bfloat16.
+                 */
+                BFloat16(float value) :
+                    __bits(Detail::float_to_bfloat(value))
+                {}
+
+                /**
+                 * @brief Builds a BFloat16 from its bits.
+                 *
+                 * @param bits Bfloat16 bits.
+                 * @return New value.
+                 */
+                static BFloat16 from_bits(std::uint16_t bits)
+                {
+                    BFloat16 value;
+                    value.__bits = bits;
+
+                    return value;
+                }
+
+                /**
+                 * @brief Gets the bfloat16 bits.
+                 *
+                 * @return Stored bits.
+                 */
+                std::uint16_t bits() const
+                {
+                    return this->__bits;
+                }
+
+                /// @brief Widens to float32, exactly.
+                operator float() const
+                {
+                    return Detail::bfloat_to_float(this->__bits);
+                }
+
+                /// Compound assignments, computed in float32.
+                BFloat16& operator+=(float rhs)
+                {
+                    return *this = float(*this) + rhs;
+                }
+
+                BFloat16& operator-=(float rhs)
+                {
+                    return *this = float(*this) - rhs;
+                }
+
+                BFloat16& operator*=(float rhs)
+                {
+                    return *this = float(*this) * rhs;
+                }
+
+                BFloat16& operator/=(float rhs)
+                {
+                    return *this = float(*this) / rhs;
+                }
+
+            private:
+                std::uint16_t __bits;
+        };
+
+        namespace Detail
+        {
+            /**
+             * @brief Bulk float32 to Float16 conversion. Uses AVX-512F or
+             * F16C conversions when compiled in.
+             *
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             */
+            inline void cast_chunk(const float* in, Float16* out, size_t n)
+            {
+                size_t i = 0;
+                std::uint16_t* dst = (std::uint16_t*)out;
+
+#if defined(__AVX512F__)
+                for (; i + 16 <= n; i += 16)
+                    _mm256_storeu_si256(
+                        (__m256i*)(dst + i),
+                        _mm512_maskz_cvtps_ph(
+                            0xffff,
+                            _mm512_loadu_ps(in + i),
+                            _MM_FROUND_TO_NEAREST_INT));
+#endif
+#if defined(__F16C__)
+                for (; i + 8 <= n; i += 8)
+                    _mm_storeu_si128(
+                        (__m128i*)(dst + i),
+                        _mm256_cvtps_ph(
+                            _mm256_loadu_ps(in + i),
+                            _MM_FROUND_TO_NEAREST_INT));
+#endif
+                for (; i < n; ++i)
+                    dst[i] = float_to_half(in[i]);
+            }
+
+            /**
+             * @brief Bulk Float16 to float32 conversion. Uses AVX-512F or
+             * F16C conversions when compiled in.
+             *
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             */
+            inline void cast_chunk(const Float16* in, float* out, size_t n)
+            {
+                size_t i = 0;
+                const std::uint16_t* src = (const std::uint16_t*)in;
+
+#if defined(__AVX512F__)
+                for (; i + 16 <= n; i += 16)
+                    _mm512_storeu_ps(
+                        out + i,
+                        _mm512_maskz_cvtph_ps(
+                            0xffff,
+                            _mm256_loadu_si256((const __m256i*)(src + i))));
+#endif
+#if defined(__F16C__)
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(
+                        out + i,
+                        _mm256_cvtph_ps(
+                            _mm_loadu_si128((const __m128i*)(src + i))));
+#endif
+                for (; i < n; ++i)
+                    out[i] = half_to_float(src[i]);
+            }
+
+            /**
+             * @brief Bulk float32 to BFloat16 conversion, rounding 8 values
+             * at a time with SSE2 integer ops.
+             *
+             * @note AVX512-BF16 conversions are not used as they flush
+             * subnormal inputs to zero, unlike the scalar rounding.
+             *
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             */
+            inline void cast_chunk(const float* in, BFloat16* out, size_t n)
+            {
+                size_t i = 0;
+                std::uint16_t* dst = (std::uint16_t*)out;
+
+#if defined(__SSE2__)
+                const __m128i one = _mm_set1_epi32(1);
+                const __m128i bias = _mm_set1_epi32(0x7fff);
+                const __m128i quiet = _mm_set1_epi32(0x40);
+
+                // Rounds 4 floats to bfloat16 bits, sign extended to 32 so
+                // that the signed pack is exact.
+                auto to_bfloat = [&](const float* p) -> __m128i
+                {
+                    __m128 v = _mm_loadu_ps(p);
+                    __m128i b = _mm_castps_si128(v);
+                    __m128i lsb = _mm_and_si128(_mm_srli_epi32(b, 16), one);
+                    __m128i r = _mm_srai_epi32(
+                        _mm_add_epi32(b, _mm_add_epi32(bias, lsb)), 16);
+                    __m128i nan = _mm_or_si128(_mm_srai_epi32(b, 16), quiet);
+                    __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+
+                    return _mm_or_si128(
+                        _mm_and_si128(is_nan, nan),
+                        _mm_andnot_si128(is_nan, r));
+                };
+
+                for (; i + 8 <= n; i += 8)
+                    _mm_storeu_si128(
+                        (__m128i*)(dst + i),
+                        _mm_packs_epi32(
+                            to_bfloat(in + i), to_bfloat(in + i + 4)));
+#endif
+                for (; i < n; ++i)
+                    dst[i] = float_to_bfloat(in[i]);
+            }
+
+            /**
+             * @brief Bulk BFloat16 to float32 conversion, 8 values at a time
+             * with SSE2.
+             *
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             */
+            inline void cast_chunk(const BFloat16* in, float* out, size_t n)
+            {
+                size_t i = 0;
+                const std::uint16_t* src = (const std::uint16_t*)in;
+
+#if defined(__SSE2__)
+                const __m128i zero = _mm_setzero_si128();
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+
+                    _mm_storeu_ps(
+                        out + i,
+                        _mm_castsi128_ps(_mm_unpacklo_epi16(zero, h)));
+                    _mm_storeu_ps(
+                        out + i + 4,
+                        _mm_castsi128_ps(_mm_unpackhi_epi16(zero, h)));
+                }
+#endif
+                for (; i < n; ++i)
+                    out[i] = bfloat_to_float(src[i]);
+            }
+        }
+    }
+}
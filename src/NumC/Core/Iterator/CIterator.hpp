@@ -2,6 +2,7 @@
 
 #define CITERATOR NumC::Core::CIterator
 
+#include <NumC/Core/Error.hpp>
 #include <NumC/Core/Iterator/MemoryIndexer.hpp>
 
 #include <numeric>
@@ -47,18 +48,16 @@ namespace NumC
                     _nunits(nunits),
                     __memory_indexer(memory_indexer)
                 {
-                    if (start_ptr == nullptr)
-                    {
-                        std::cout << "ERROR - iter - 1" << std::endl;
-                        // throw error or add asserts.
-                    }
+                    NUMC_CHECK(
+                        start_ptr != nullptr,
+                        ErrorCode::InvalidArgument,
+                        "iter - 1: null data pointer.");
 
                     // 0 allowed for end() iterators.
-                    if (nunits < 0)
-                    {
-                        std::cout << "ERROR - iter - 2" << std::endl;
-                        // throw error or add asserts.
-                    }
+                    NUMC_CHECK(
+                        nunits >= 0,
+                        ErrorCode::InvalidArgument,
+                        "iter - 2: negative element count.");
 
                     if (memory_indexer != nullptr)
                         this->__arr_index =
@@ -94,11 +93,10 @@ namespace NumC
                 void operator++()
                 {
                     // Not equating as that would be the end() scenario.
-                    if (this->_index + 1 > this->_nunits)
-                    {
-                        std::cout << "ERROR - iter - 3" << std::endl;
-                        // throw error or add asserts.
-                    }
+                    NUMC_ASSERT(
+                        this->_index + 1 <= this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "iter - 3: increment past end.");
 
                     ++(this->_index);
 
@@ -121,9 +119,9 @@ namespace NumC
                  *
                  * @return CIterator prior to increment.
                  */
-                CIterator<dtype>& operator++(int)
+                CIterator<dtype> operator++(int)
                 {
-                    auto tmp = *this
+                    auto tmp = *this;
                     ++*this;
 
                     return tmp;
@@ -137,11 +135,10 @@ namespace NumC
                  */
                 void operator--()
                 {
-                    if (this->_index - 1 < 0)
-                    {
-                        std::cout << "ERROR - iter - 4" << std::endl;
-                        // throw error.
-                    }
+                    NUMC_ASSERT(
+                        this->_index - 1 >= 0,
+                        ErrorCode::IndexOutOfBounds,
+                        "iter - 4: decrement before begin.");
 
                     --(this->_index);
 
@@ -164,9 +161,9 @@ namespace NumC
                  *
                  * @return CIterator prior to decrement.
                  */
-                CIterator<dtype>& operator--(int)
+                CIterator<dtype> operator--(int)
                 {
-                    auto tmp = *this
+                    auto tmp = *this;
                     --*this;
 
                     return tmp;
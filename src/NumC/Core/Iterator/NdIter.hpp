@@ -0,0 +1,533 @@
+#pragma once
+
+#define ND_ITER NumC::Core::NdIter
+
+#include <NumC/Core/Error.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Core/Type.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace NumC
+{
+    namespace Core
+    {
+        template<typename T>
+        class NdArray;
+
+        namespace Detail
+        {
+            /// @brief Elements walked per parallel task by NdIter.
+            const size_t NDITER_GRAIN = size_t(1) << 15;
+        }
+
+        /**
+         * @brief Walks several arrays and views at once, broadcast against
+         * each other, handing out inner loops rather than elements.
+         *
+         * Axes of size 1 are dropped, the rest are reordered so that the
+         * smallest buffer strides are innermost, and neighbouring axes that
+         * are contiguous for every operand are merged. A transposed view is
+         * thus walked in buffer order and contiguous operands in one inner
+         * loop. Broadcast axes get a stride of 0.
+         *
+         * The callback receives one pointer per operand, in the order they
+         * were added, the byte stride of each operand along the inner loop
+         * and the inner loop length:
+         * @code
+         * ND_ITER iter;
+         * iter.add_input(a).add_input(b).add_output(out);
+         * iter.for_each(
+         *     [](char* const* ptrs, const size_t* strides, size_t count)
+         *     {
+         *         for (size_t i = 0; i < count; ++i)
+         *             *(float*)(ptrs[2] + i * strides[2]) =
+         *                 *(const float*)(ptrs[0] + i * strides[0]) +
+         *                 *(const float*)(ptrs[1] + i * strides[1]);
+         *     });
+         * @endcode
+         *
+         * @warning The operands must outlive the iterator. Elements are
+         * visited in buffer order, not in the logical order of the shape.
+         */
+        class NdIter
+        {
+            public:
+                /// @brief Default NdIter constructor, no operands.
+                NdIter() = default;
+
+                /// @brief Default NdIter destructor.
+                ~NdIter() = default;
+
+                /**
+                 * @brief Adds a read-only operand.
+                 *
+                 * @tparam T Element data type.
+                 * @param array Array or view.
+                 * @return Reference to this iterator.
+                 */
+                template<typename T>
+                NdIter& add_input(const NdArray<T>& array)
+                {
+                    const T* data = array.memory_data();
+
+                    this->__add(
+                        reinterpret_cast<char*>(const_cast<T*>(data)) +
+                            array.memory_offset() * sizeof(T),
+                        array.shape(),
+                        array.memory_strides(),
+                        sizeof(T),
+                        false);
+
+                    return *this;
+                }
+
+                /**
+                 * @brief Adds an operand written through. It must have the
+                 * broadcast shape. A shared copy-on-write buffer is copied
+                 * first.
+                 *
+                 * @tparam T Element data type.
+                 * @param array Array or view.
+                 * @return Reference to this iterator.
+                 */
+                template<typename T>
+                NdIter& add_output(NdArray<T>& array)
+                {
+                    T* data = array.mutable_memory_data();
+
+                    this->__add(
+                        reinterpret_cast<char*>(data) +
+                            array.memory_offset() * sizeof(T),
+                        array.shape(),
+                        array.memory_strides(),
+                        sizeof(T),
+                        true);
+
+                    return *this;
+                }
+
+                /**
+                 * @brief Gets the number of operands.
+                 *
+                 * @return Number of operands.
+                 */
+                size_t noperands() const
+                {
+                    return this->__origins.size();
+                }
+
+                /**
+                 * @brief Gets the broadcast shape of the operands.
+                 *
+                 * @return Broadcast shape.
+                 */
+                const shape_t& shape() const
+                {
+                    return this->_shape;
+                }
+
+                /**
+                 * @brief Gets the number of elements walked.
+                 *
+                 * @return Product of the broadcast shape.
+                 */
+                size_t size() const
+                {
+                    return this->_nunits;
+                }
+
+                /**
+                 * @brief Gets the number of loops the walk is made of, after
+                 * dropping and merging axes. 1 when every operand is walked
+                 * contiguously (or broadcast) in a single inner loop.
+                 *
+                 * @return Number of iteration axes.
+                 */
+                size_t ndims() const
+                {
+                    return this->__dims.size();
+                }
+
+                /**
+                 * @brief Gets the inner loop length, the size of the
+                 * innermost iteration axis.
+                 *
+                 * @return Inner loop length.
+                 */
+                size_t inner_size() const
+                {
+                    return this->__dims.empty() ? 0 : this->__dims.back();
+                }
+
+                /**
+                 * @brief Calls loop(ptrs, strides, count) over all elements,
+                 * on the calling thread.
+                 *
+                 * @tparam Func Callable taking (char* const*, const size_t*,
+                 * size_t).
+                 * @param loop Inner loop body.
+                 */
+                template<typename Func>
+                void for_each(const Func& loop) const
+                {
+                    NUMC_TRACE_SCOPE("nditer", "iter");
+
+                    this->__walk(0, this->_nunits, loop);
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits, this->__bytes, this->__describe());
+                }
+
+                /**
+                 * @brief Calls loop(ptrs, strides, count) over all elements,
+                 * split in ranges walked in parallel. Inner loops are cut at
+                 * range boundaries.
+                 *
+                 * @note Outputs must not overlap each other or the inputs.
+                 *
+                 * @tparam Func Callable taking (char* const*, const size_t*,
+                 * size_t).
+                 * @param loop Inner loop body.
+                 * @param grain Elements per task. 0 for NDITER_GRAIN.
+                 */
+                template<typename Func>
+                void parallel_for_each(const Func& loop, size_t grain = 0) const
+                {
+                    NUMC_TRACE_SCOPE("nditer_parallel", "iter");
+
+                    Utils::parallel_for(
+                        0,
+                        this->_nunits,
+                        grain > 0 ? grain : Detail::NDITER_GRAIN,
+                        [&](size_t lo, size_t hi)
+                        {
+                            this->__walk(lo, hi, loop);
+                        });
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits, this->__bytes, this->__describe());
+                }
+
+            protected:
+
+                /// @brief Broadcast shape of the operands.
+                shape_t _shape;
+
+                /// @brief Product of the broadcast shape.
+                size_t _nunits = 0;
+
+            private:
+
+                /// @brief Address of element 0 of each operand.
+                std::vector<char*> __origins;
+
+                /// @brief Shape of each operand.
+                std::vector<shape_t> __shapes;
+
+                /// @brief Byte strides of each operand.
+                std::vector<stride_t> __strides;
+
+                /// @brief Whether each operand is written.
+                std::vector<bool> __outputs;
+
+                /// @brief Bytes spanned by all operands, for the tracer.
+                size_t __bytes = 0;
+
+                /// @brief Iteration axes, outermost first.
+                shape_t __dims;
+
+                /// @brief Byte stride of operand k along iteration axis d
+                /// at d * noperands() + k.
+                std::vector<size_t> __loop_strides;
+
+                /**
+                 * @brief Registers an operand and plans the walk again.
+                 *
+                 * @param base Address of element 0.
+                 * @param shape Operand shape.
+                 * @param strides Buffer strides, in elements.
+                 * @param itemsize Element size in bytes.
+                 * @param output Whether the operand is written.
+                 */
+                void __add(
+                    char* base,
+                    const shape_t& shape,
+                    const stride_t& strides,
+                    size_t itemsize,
+                    bool output)
+                {
+                    stride_t bytes;
+
+                    for (auto stride: strides)
+                        bytes.push_back(stride * itemsize);
+
+                    this->__origins.push_back(base);
+                    this->__shapes.push_back(shape);
+                    this->__strides.push_back(bytes);
+                    this->__outputs.push_back(output);
+
+                    size_t count = itemsize;
+
+                    for (auto dim: shape)
+                        count *= dim;
+
+                    this->__bytes += count;
+                    this->__plan();
+                }
+
+                /**
+                 * @brief Describes the walk for trace events, e.g.
+                 * "3 operands (2, 3), 1 loops".
+                 *
+                 * @return Description string.
+                 */
+                std::string __describe() const
+                {
+                    std::string desc =
+                        std::to_string(this->noperands()) + " operands (";
+
+                    for (size_t i = 0; i < size_t(this->_shape.size()); ++i)
+                        desc += (i ? ", " : "") +
+                            std::to_string(this->_shape[i]);
+
+                    return desc + "), " + std::to_string(this->ndims()) +
+                        " loops";
+                }
+
+                /**
+                 * @brief Broadcasts the operands, then drops, reorders and
+                 * merges the iteration axes.
+                 */
+                void __plan()
+                {
+                    const size_t nop = this->__origins.size();
+                    size_t nd = 0;
+
+                    for (const auto& shape: this->__shapes)
+                        nd = std::max(nd, size_t(shape.size()));
+
+                    shape_t shape(nd, 1);
+
+                    for (const auto& op_shape: this->__shapes)
+                        for (size_t d = 0; d < size_t(op_shape.size()); ++d)
+                        {
+                            size_t& dim = shape[nd - op_shape.size() + d];
+
+                            NUMC_CHECK(
+                                op_shape[d] == dim || op_shape[d] == 1 ||
+                                dim == 1,
+                                ErrorCode::BroadcastError,
+                                "nditer - 1: operands cannot be broadcast "
+                                "together.");
+
+                            dim = std::max(dim, op_shape[d]);
+                        }
+
+                    for (size_t k = 0; k < nop; ++k)
+                        NUMC_CHECK(
+                            !this->__outputs[k] || this->__shapes[k] == shape,
+                            ErrorCode::BroadcastError,
+                            "nditer - 2: an output does not have the "
+                            "broadcast shape.");
+
+                    this->_shape = shape;
+                    this->_nunits = 1;
+
+                    for (auto dim: shape)
+                        this->_nunits *= dim;
+
+                    // Byte strides along the kept axes, 0 when broadcast.
+                    std::vector<size_t> axes;
+                    std::vector<size_t> strides;
+
+                    for (size_t axis = 0; axis < nd; ++axis)
+                    {
+                        if (shape[axis] == 1)
+                            continue;
+
+                        axes.push_back(axis);
+
+                        for (size_t k = 0; k < nop; ++k)
+                        {
+                            const auto& op_shape = this->__shapes[k];
+                            const size_t lead = nd - op_shape.size();
+
+                            strides.push_back(
+                                axis < lead || op_shape[axis - lead] == 1 ?
+                                0 : this->__strides[k][axis - lead]);
+                        }
+                    }
+
+                    // Insertion sort, larger strides outward. C order wins
+                    // where operands disagree, as in NumPy.
+                    std::vector<size_t> order;
+
+                    for (size_t i = 0; i < size_t(axes.size()); ++i)
+                    {
+                        size_t j = order.size();
+
+                        order.push_back(i);
+
+                        for (; j > 0; --j)
+                        {
+                            if (!this->__outer_of(
+                                    &strides[order[j] * nop],
+                                    &strides[order[j - 1] * nop]))
+                                break;
+
+                            std::swap(order[j], order[j - 1]);
+                        }
+                    }
+
+                    // Merge each axis into the one outside it when every
+                    // operand steps over the inner axis exactly once.
+                    this->__dims.clear();
+                    this->__loop_strides.clear();
+
+                    for (auto i: order)
+                    {
+                        const size_t dim = shape[axes[i]];
+                        const size_t* inner = &strides[i * nop];
+                        bool merge = !this->__dims.empty();
+
+                        for (size_t k = 0; merge && k < nop; ++k)
+                            merge = this->__loop_strides[
+                                this->__loop_strides.size() - nop + k] ==
+                                inner[k] * dim;
+
+                        if (merge)
+                        {
+                            this->__dims.back() *= dim;
+                            std::copy(
+                                inner, inner + nop,
+                                this->__loop_strides.end() - nop);
+
+                            continue;
+                        }
+
+                        this->__dims.push_back(dim);
+                        this->__loop_strides.insert(
+                            this->__loop_strides.end(), inner, inner + nop);
+                    }
+
+                    if (this->__dims.empty())
+                    {
+                        this->__dims.push_back(1);
+                        this->__loop_strides.assign(nop, 0);
+                    }
+                }
+
+                /**
+                 * @brief Tells if an axis should be walked outside another,
+                 * comparing the operands' strides along both.
+                 *
+                 * @param axis Strides of the axis, one per operand.
+                 * @param prev Strides of the axis now outside it.
+                 * @return True if axis should move outside prev.
+                 */
+                bool __outer_of(const size_t* axis, const size_t* prev) const
+                {
+                    bool outer = false, ambiguous = true;
+
+                    for (size_t k = 0; k < this->noperands(); ++k)
+                    {
+                        if (axis[k] == 0 || prev[k] == 0)
+                            continue;
+
+                        if (std::abs(axis[k]) <= std::abs(prev[k]))
+                            outer = false;
+                        else if (ambiguous)
+                            outer = true;
+
+                        ambiguous = false;
+                    }
+
+                    return outer;
+                }
+
+                /**
+                 * @brief Walks elements [lo, hi) of the iteration order.
+                 *
+                 * @tparam Func Inner loop body.
+                 * @param lo First element.
+                 * @param hi Last element + 1.
+                 * @param loop Inner loop body.
+                 */
+                template<typename Func>
+                void __walk(size_t lo, size_t hi, const Func& loop) const
+                {
+                    if (lo >= hi)
+                        return;
+
+                    const size_t nop = this->__origins.size();
+                    const size_t nd = this->__dims.size();
+                    const size_t inner = this->__dims.back();
+                    const size_t* inner_strides =
+                        &this->__loop_strides[(nd - 1) * nop];
+                    std::vector<char*> ptrs(this->__origins);
+                    shape_t index(nd, 0);
+
+                    for (size_t d = nd, rest = lo; d-- > 0;)
+                    {
+                        index[d] = rest % this->__dims[d];
+                        rest /= this->__dims[d];
+
+                        for (size_t k = 0; k < nop; ++k)
+                            ptrs[k] += index[d] *
+                                this->__loop_strides[d * nop + k];
+                    }
+
+                    for (size_t pos = lo; pos < hi;)
+                    {
+                        const size_t count =
+                            std::min(inner - index[nd - 1], hi - pos);
+
+                        loop(
+                            static_cast<char* const*>(ptrs.data()),
+                            inner_strides,
+                            count);
+
+                        pos += count;
+                        index[nd - 1] += count;
+
+                        if (pos >= hi)
+                            break;
+
+                        for (size_t k = 0; k < nop; ++k)
+                            ptrs[k] += count * inner_strides[k];
+
+                        if (index[nd - 1] < inner)
+                            continue;
+
+                        // Carry into the outer axes.
+                        for (size_t d = nd; d-- > 0;)
+                        {
+                            const size_t* step =
+                                &this->__loop_strides[d * nop];
+
+                            if (d + 1 < nd)
+                            {
+                                ++index[d];
+
+                                for (size_t k = 0; k < nop; ++k)
+                                    ptrs[k] += step[k];
+                            }
+
+                            if (index[d] < this->__dims[d])
+                                break;
+
+                            for (size_t k = 0; k < nop; ++k)
+                                ptrs[k] -= this->__dims[d] * step[k];
+
+                            index[d] = 0;
+                        }
+                    }
+                }
+        };
+    }
+}
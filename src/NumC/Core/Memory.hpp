@@ -0,0 +1,664 @@
+#pragma once
+
+#define MEMORY_TRACKER NumC::Core::MemoryTracker
+#define MEMORY_SCOPE NumC::Core::MemoryScope
+
+#include <NumC/Core/Error.hpp>
+#include <NumC/Core/Numa.hpp>
+#include <NumC/Core/Type.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define NUMC_STRINGIFY_IMPL(x) #x
+#define NUMC_STRINGIFY(x) NUMC_STRINGIFY_IMPL(x)
+
+/**
+ * @brief Tags the enclosing scope as an allocation call site. Large
+ * allocations made inside it are reported with this file:line.
+ */
+#define NUMC_MEMORY_SITE() \
+    NumC::Core::MemorySite __numc_memory_site( \
+        __FILE__ ":" NUMC_STRINGIFY(__LINE__))
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief Memory usage of one data type.
+        struct DtypeMemoryStats
+        {
+            /// @brief Bytes currently allocated.
+            size_t current_bytes = 0;
+
+            /// @brief Highest value current_bytes has reached.
+            size_t peak_bytes = 0;
+
+            /// @brief Number of allocations made.
+            size_t allocations = 0;
+        };
+
+        /// @brief A single allocation above the large-allocation threshold.
+        struct LargeAllocation
+        {
+            /// @brief Data type name.
+            std::string dtype;
+
+            /// @brief Size in bytes.
+            size_t bytes;
+
+            /// @brief Innermost NUMC_MEMORY_SITE tag, "unknown" if none.
+            std::string site;
+        };
+
+        /// @brief Snapshot of a tracker's counters.
+        struct MemoryStats
+        {
+            size_t current_bytes;
+            size_t peak_bytes;
+            size_t allocations;
+            size_t deallocations;
+            size_t limit_bytes;
+            std::map<std::string, DtypeMemoryStats> per_dtype;
+            std::vector<LargeAllocation> large_allocations;
+        };
+
+        namespace Detail
+        {
+            /// @brief Number of data types the trackers keep apart. Types
+            /// past the last slot but one share the last slot, "other".
+            const size_t MAX_TRACKED_DTYPES = 64;
+
+            /// @brief Names of the data types given a tracker slot.
+            struct DtypeRegistry
+            {
+                std::mutex mutex;
+                const char* names[MAX_TRACKED_DTYPES];
+                std::atomic<size_t> count{0};
+            };
+
+            /// @brief Gets the process wide data type registry.
+            inline DtypeRegistry& dtype_registry()
+            {
+                static DtypeRegistry registry;
+
+                return registry;
+            }
+
+            /**
+             * @brief Gives a data type name its tracker slot, once per type.
+             *
+             * @param name Data type name.
+             * @return Slot index below MAX_TRACKED_DTYPES.
+             */
+            inline size_t register_dtype(const char* name)
+            {
+                DtypeRegistry& registry = dtype_registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                const size_t count = registry.count.load();
+
+                for (size_t i = 0; i < count; ++i)
+                    if (std::strcmp(registry.names[i], name) == 0)
+                        return i;
+
+                if (count + 1 == MAX_TRACKED_DTYPES)
+                    name = "other";
+                else if (count == MAX_TRACKED_DTYPES)
+                    return count - 1;
+
+                registry.names[count] = name;
+                registry.count.store(count + 1);
+
+                return count;
+            }
+
+            /**
+             * @brief Gets the tracker slot of a data type.
+             *
+             * @tparam T Element data type.
+             * @return Slot index.
+             */
+            template<typename T>
+            size_t dtype_slot()
+            {
+                static const size_t slot = register_dtype(dtype_name<T>());
+
+                return slot;
+            }
+        }
+
+        /**
+         * @brief Thread-local stack of call site tags used to attribute large
+         * allocations. Use through NUMC_MEMORY_SITE().
+         */
+        class MemorySite
+        {
+            public:
+                /**
+                 * @brief Construct a new Memory Site object and pushes the
+                 * tag.
+                 *
+                 * @param site Call site tag. Must outlive the scope (a string
+                 * literal).
+                 */
+                explicit MemorySite(const char* site)
+                {
+                    stack().push_back(site);
+                }
+
+                MemorySite(const MemorySite&) = delete;
+                MemorySite& operator=(const MemorySite&) = delete;
+
+                /// @brief Pops the tag.
+                ~MemorySite()
+                {
+                    stack().pop_back();
+                }
+
+                /**
+                 * @brief Gets the innermost call site tag of this thread.
+                 *
+                 * @return Call site tag or "unknown".
+                 */
+                static const char* current()
+                {
+                    return stack().empty() ? "unknown" : stack().back();
+                }
+
+            private:
+
+                static std::vector<const char*>& stack()
+                {
+                    static thread_local std::vector<const char*> sites;
+
+                    return sites;
+                }
+        };
+
+        /**
+         * @brief Accounts the NdArray buffers allocated while it is the
+         * active tracker, optionally enforcing a hard limit.
+         *
+         * @note Trackers form a tree rooted at the global tracker. An
+         * allocation is charged to the active tracker and all its parents,
+         * and the limits of all of them apply. Use a MemoryScope to make a
+         * tracker active on the current thread, e.g. one tracker per tenant.
+         */
+        class MemoryTracker
+        {
+            public:
+                /// Aliases
+                using tracker_ptr = std::shared_ptr<MemoryTracker>;
+
+                /**
+                 * @brief Creates a tracker.
+                 *
+                 * @param name Tracker name used in reports and errors.
+                 * @param limit_bytes Hard limit, 0 for none.
+                 * @param parent Parent tracker. Defaults to the global one.
+                 * @return Pointer to the new tracker.
+                 */
+                static tracker_ptr create(
+                    const std::string& name,
+                    size_t limit_bytes = 0,
+                    tracker_ptr parent = global())
+                {
+                    return tracker_ptr(
+                        new MemoryTracker(name, limit_bytes, parent));
+                }
+
+                /**
+                 * @brief Gets the process wide root tracker.
+                 *
+                 * @return Pointer to the global tracker.
+                 */
+                static const tracker_ptr& global()
+                {
+                    static tracker_ptr tracker(
+                        new MemoryTracker("global", 0, nullptr));
+
+                    return tracker;
+                }
+
+                /**
+                 * @brief Gets the tracker allocations on this thread are
+                 * charged to.
+                 *
+                 * @return Innermost MemoryScope tracker, else the global one.
+                 */
+                static const tracker_ptr& active()
+                {
+                    auto& scopes = scope_stack();
+
+                    return scopes.empty() ? global() : scopes.back();
+                }
+
+                /**
+                 * @brief Gets the tracker name.
+                 *
+                 * @return Tracker name.
+                 */
+                const std::string& name() const
+                {
+                    return this->__name;
+                }
+
+                /**
+                 * @brief Sets the hard limit. Allocations that would go past
+                 * it throw ErrorCode::MemoryLimitExceeded.
+                 *
+                 * @param limit_bytes Limit in bytes, 0 for none.
+                 */
+                void set_limit(size_t limit_bytes)
+                {
+                    this->__limit = limit_bytes;
+                }
+
+                /**
+                 * @brief Sets the size from which allocations are recorded
+                 * with their call site.
+                 *
+                 * @param threshold_bytes Threshold in bytes.
+                 */
+                void set_large_threshold(size_t threshold_bytes)
+                {
+                    this->__large_threshold = threshold_bytes;
+                }
+
+                /**
+                 * @brief Gets the currently allocated bytes.
+                 *
+                 * @return Live bytes.
+                 */
+                size_t current_bytes() const
+                {
+                    return this->__current.load();
+                }
+
+                /**
+                 * @brief Gets the highest number of live bytes seen.
+                 *
+                 * @return Peak bytes.
+                 */
+                size_t peak_bytes() const
+                {
+                    return this->__peak.load();
+                }
+
+                /**
+                 * @brief Takes a snapshot of all the counters.
+                 *
+                 * @return Memory statistics.
+                 */
+                MemoryStats stats() const
+                {
+                    MemoryStats stats;
+                    stats.current_bytes = this->__current.load();
+                    stats.peak_bytes = this->__peak.load();
+                    stats.allocations = this->__allocations.load();
+                    stats.deallocations = this->__deallocations.load();
+                    stats.limit_bytes = this->__limit.load();
+
+                    const Detail::DtypeRegistry& registry =
+                        Detail::dtype_registry();
+                    const size_t count = registry.count.load();
+
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const DtypeCounters& counters = this->__per_dtype[i];
+                        DtypeMemoryStats dtype_stats;
+
+                        dtype_stats.allocations = counters.allocations.load();
+
+                        if (dtype_stats.allocations == 0)
+                            continue;
+
+                        dtype_stats.current_bytes = counters.current.load();
+                        dtype_stats.peak_bytes = counters.peak.load();
+                        stats.per_dtype[registry.names[i]] = dtype_stats;
+                    }
+
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+                    stats.large_allocations = this->__large;
+
+                    return stats;
+                }
+
+                /// @brief Resets the peak to the current usage.
+                void reset_peak()
+                {
+                    this->__peak.store(this->__current.load());
+
+                    for (auto& counters : this->__per_dtype)
+                        counters.peak.store(counters.current.load());
+                }
+
+                /**
+                 * @brief Charges an allocation to this tracker and its
+                 * parents. Lock free, except for allocations above the
+                 * large-allocation threshold.
+                 *
+                 * @param bytes Allocation size.
+                 * @param dtype Data type slot, see Detail::dtype_slot().
+                 */
+                void charge(size_t bytes, size_t dtype)
+                {
+                    for (MemoryTracker* t = this; t != nullptr;
+                        t = t->__parent.get())
+                    {
+                        size_t now = t->__current.fetch_add(bytes) + bytes;
+                        size_t limit = t->__limit.load();
+
+                        if (limit > 0 && now > limit)
+                        {
+                            // Roll back everything charged so far.
+                            for (MemoryTracker* u = this; u != t;
+                                u = u->__parent.get())
+                                u->__current.fetch_sub(bytes);
+                            t->__current.fetch_sub(bytes);
+
+                            throw Error(
+                                ErrorCode::MemoryLimitExceeded,
+                                "memory - 1: allocating " +
+                                std::to_string(bytes) + " bytes exceeds the "
+                                "limit of tracker '" + t->__name + "' (" +
+                                std::to_string(now - bytes) + " of " +
+                                std::to_string(limit) + " bytes in use).");
+                        }
+                    }
+
+                    for (MemoryTracker* t = this; t != nullptr;
+                        t = t->__parent.get())
+                        t->__account(bytes, dtype);
+                }
+
+                /**
+                 * @brief Releases an allocation previously charged.
+                 *
+                 * @param bytes Allocation size.
+                 * @param dtype Data type slot, see Detail::dtype_slot().
+                 */
+                void release(size_t bytes, size_t dtype)
+                {
+                    for (MemoryTracker* t = this; t != nullptr;
+                        t = t->__parent.get())
+                    {
+                        t->__current.fetch_sub(bytes);
+                        t->__deallocations.fetch_add(1);
+                        t->__per_dtype[dtype].current.fetch_sub(bytes);
+                    }
+                }
+
+            private:
+
+                MemoryTracker(
+                    const std::string& name,
+                    size_t limit_bytes,
+                    tracker_ptr parent) :
+                    __name(name),
+                    __parent(parent),
+                    __limit(limit_bytes),
+                    __large_threshold(size_t(64) << 20),
+                    __current(0),
+                    __peak(0),
+                    __allocations(0),
+                    __deallocations(0)
+                {
+                    for (auto& counters : this->__per_dtype)
+                    {
+                        counters.current.store(0);
+                        counters.peak.store(0);
+                        counters.allocations.store(0);
+                    }
+                }
+
+                /// @brief Live counters of one data type.
+                struct DtypeCounters
+                {
+                    std::atomic<size_t> current;
+                    std::atomic<size_t> peak;
+                    std::atomic<size_t> allocations;
+                };
+
+                /**
+                 * @brief Raises a peak counter to now if it is below.
+                 *
+                 * @param peak Peak counter.
+                 * @param now Current value.
+                 */
+                static void raise_peak(std::atomic<size_t>& peak, size_t now)
+                {
+                    size_t seen = peak.load();
+
+                    while (now > seen && !peak.compare_exchange_weak(seen, now))
+                        ;
+                }
+
+                friend class MemoryScope;
+
+                /// @brief Thread-local stack of active trackers.
+                static std::vector<tracker_ptr>& scope_stack()
+                {
+                    static thread_local std::vector<tracker_ptr> scopes;
+
+                    return scopes;
+                }
+
+                /**
+                 * @brief Updates the peak, counts and per-dtype stats after
+                 * a successful charge.
+                 */
+                void __account(size_t bytes, size_t dtype)
+                {
+                    DtypeCounters& counters = this->__per_dtype[dtype];
+
+                    raise_peak(this->__peak, this->__current.load());
+                    this->__allocations.fetch_add(1);
+
+                    raise_peak(
+                        counters.peak,
+                        counters.current.fetch_add(bytes) + bytes);
+                    counters.allocations.fetch_add(1);
+
+                    if (bytes < this->__large_threshold.load())
+                        return;
+
+                    LargeAllocation large;
+                    large.dtype = Detail::dtype_registry().names[dtype];
+                    large.bytes = bytes;
+                    large.site = MemorySite::current();
+
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    // Keeps the most recent ones only.
+                    if (this->__large.size() >= 256)
+                        this->__large.erase(this->__large.begin());
+
+                    this->__large.push_back(large);
+                }
+
+                /// @brief Tracker name.
+                std::string __name;
+
+                /// @brief Parent tracker, null for the global one.
+                tracker_ptr __parent;
+
+                /// @brief Hard limit in bytes, 0 for none.
+                std::atomic<size_t> __limit;
+
+                /// @brief Size from which allocations are recorded.
+                std::atomic<size_t> __large_threshold;
+
+                std::atomic<size_t> __current;
+                std::atomic<size_t> __peak;
+                std::atomic<size_t> __allocations;
+                std::atomic<size_t> __deallocations;
+
+                /// @brief Counters per data type slot.
+                DtypeCounters __per_dtype[Detail::MAX_TRACKED_DTYPES];
+
+                /// @brief Guards the large allocations.
+                mutable std::mutex __mutex;
+
+                std::vector<LargeAllocation> __large;
+        };
+
+        /**
+         * @brief Makes a tracker the active one on the current thread for
+         * the lifetime of the scope.
+         */
+        class MemoryScope
+        {
+            public:
+                /**
+                 * @brief Construct a new Memory Scope object.
+                 *
+                 * @param tracker Tracker to charge allocations to.
+                 */
+                explicit MemoryScope(const MemoryTracker::tracker_ptr& tracker)
+                {
+                    MemoryTracker::scope_stack().push_back(tracker);
+                }
+
+                MemoryScope(const MemoryScope&) = delete;
+                MemoryScope& operator=(const MemoryScope&) = delete;
+
+                /// @brief Restores the previously active tracker.
+                ~MemoryScope()
+                {
+                    MemoryTracker::scope_stack().pop_back();
+                }
+        };
+
+        /**
+         * @brief Deleter of tracked buffers. Frees the memory and releases it
+         * from the tracker it was charged to.
+         */
+        struct BufferDeleter
+        {
+            /// @brief Tracker the buffer was charged to.
+            MemoryTracker::tracker_ptr tracker;
+
+            /// @brief Buffer size in bytes.
+            size_t bytes;
+
+            /// @brief Data type slot.
+            size_t dtype;
+
+            /// @brief How the buffer was obtained.
+            BufferKind kind = BufferKind::Heap;
+
+            void operator()(void* ptr) const
+            {
+                if (this->kind == BufferKind::Heap)
+                    std::free(ptr);
+                else
+                    Detail::unmap(ptr, this->bytes, this->kind);
+
+                this->tracker->release(this->bytes, this->dtype);
+            }
+        };
+
+        /**
+         * @brief Allocates a tracked buffer for count elements. The buffer
+         * is charged to the active tracker, then backed and placed as the
+         * active PlacementPolicy says.
+         *
+         * @note Zeroed buffers come from calloc() or fresh mappings, so
+         * large ones are backed by zero pages until written.
+         *
+         * @tparam T Element data type.
+         * @param count Number of elements.
+         * @param zeroed Zero the buffer.
+         * @return Shared pointer owning the buffer.
+         */
+        template<typename T>
+        std::shared_ptr<T> allocate_buffer(size_t count, bool zeroed = false)
+        {
+            const MemoryTracker::tracker_ptr& tracker =
+                MemoryTracker::active();
+            size_t bytes = count * sizeof(T);
+            const size_t dtype = Detail::dtype_slot<T>();
+
+            tracker->charge(bytes, dtype);
+
+            PlacementPolicy placement = PlacementScope::active();
+            BufferKind kind = BufferKind::Heap;
+            T* ptr = nullptr;
+
+            if (Detail::needs_mapping(bytes, placement))
+                ptr = (T*)Detail::map_buffer(bytes, placement, kind);
+
+            if (ptr == nullptr)
+            {
+                kind = BufferKind::Heap;
+                ptr = zeroed ?
+                    (T*)std::calloc(count, sizeof(T)) :
+                    (T*)std::malloc(bytes);
+            }
+
+            if (ptr == nullptr)
+            {
+                tracker->release(bytes, dtype);
+
+                throw Error(
+                    ErrorCode::AllocationFailed,
+                    "memory - 2: failed to allocate " +
+                    std::to_string(bytes) + " bytes.");
+            }
+
+            BufferDeleter deleter;
+            deleter.tracker = tracker;
+            deleter.bytes = bytes;
+            deleter.dtype = dtype;
+            deleter.kind = kind;
+
+            return std::shared_ptr<T>(ptr, deleter);
+        }
+
+        /// @brief Bytes copied per parallel task by copy_buffer().
+        const size_t COPY_GRAIN_BYTES = size_t(1) << 20;
+
+        /**
+         * @brief Copies count elements between two buffers that do not
+         * overlap. Trivially copyable types are copied with memcpy() in
+         * parallel chunks of COPY_GRAIN_BYTES, so each thread runs the
+         * vectorized libc copy and, for large chunks, its non-temporal
+         * stores.
+         *
+         * @tparam T Element data type.
+         * @param dst Destination buffer.
+         * @param src Source buffer.
+         * @param count Number of elements.
+         */
+        template<typename T>
+        void copy_buffer(T* dst, const T* src, size_t count)
+        {
+            const size_t grain =
+                std::max<size_t>(1, COPY_GRAIN_BYTES / sizeof(T));
+
+            Utils::parallel_for(
+                0,
+                count,
+                grain,
+                [=](size_t lo, size_t hi)
+                {
+                    if (std::is_trivially_copyable<T>::value)
+                        std::memcpy(
+                            (void*)(dst + lo),
+                            (const void*)(src + lo),
+                            (hi - lo) * sizeof(T));
+                    else
+                        std::copy(src + lo, src + hi, dst + lo);
+                });
+        }
+    }
+}
@@ -2,16 +2,33 @@
 
 #define ND_ARRAY NumC::Core::NdArray
 
+#include <NumC/Core/Cast.hpp>
+#include <NumC/Core/Complex.hpp>
+#include <NumC/Core/Error.hpp>
 #include <NumC/Core/Iterator/Iterator.hpp>
 #include <NumC/Core/Iterator/CIterator.hpp>
+#include <NumC/Core/Iterator/NdIter.hpp>
+#include <NumC/Core/Memory.hpp>
+#include <NumC/Core/Trace.hpp>
 
-#include <memory>
 #include <functional>
+#include <limits>
+#include <memory>
 
 namespace NumC
 {
     namespace Core
     {
+        /// @brief Initial contents of a newly allocated array.
+        enum class ArrayInit
+        {
+            /// @brief Left as allocated.
+            Uninitialized,
+
+            /// @brief All zero bits, taken from zeroed pages when possible.
+            Zeros
+        };
+
         /**
          * @brief The basic N-D array class that defines the way data is stored
          * and traversed.
@@ -25,6 +42,7 @@ namespace NumC
                 /// Aliases
                 using dtype = T;
                 using dtype_ptr = dtype*;
+                using scalar_t = typename Detail::ScalarType<dtype>::type;
                 using dtype_ref = dtype&;
                 using dtype_shrd_ptr = std::shared_ptr<dtype>;
                 using const_dtype_ref = const dtype&;
@@ -44,29 +62,50 @@ namespace NumC
                  *
                  * @param shape The shape/dimensions of array to be created.
                  */
-                NdArray(const shape_t& shape)
+                NdArray(const shape_t& shape) :
+                    NdArray(shape, ArrayInit::Uninitialized)
+                {}
+
+                /**
+                 * @brief Construct a new Nd Array object based on the shape
+                 * provided.
+                 *
+                 * @param shape The shape/dimensions of array to be created.
+                 * @param init Initial contents.
+                 */
+                NdArray(const shape_t& shape, ArrayInit init)
                 {
-                    if (shape.empty())
+                    NUMC_CHECK(
+                        !shape.empty(),
+                        ErrorCode::InvalidShape,
+                        "nd - 1: shape cannot be empty.");
+
+                    // Validation.
+                    for (auto s : shape)
                     {
-                        std::cout << "ERROR - nd - 1" << std::endl;
-                        // throw error
+                        NUMC_CHECK(
+                            s > 0,
+                            ErrorCode::InvalidShape,
+                            "nd - 2: dimensions must be positive.");
                     }
 
-                    // Validation.
+                    // Element count must be representable by the index type.
+                    size_t max_units = 1;
                     for (auto s : shape)
                     {
-                        if (s <= 0)
-                        {
-                            std::cout << "ERROR - nd - 2" << std::endl;
-                            // throw error
-                        }
+                        NUMC_CHECK(
+                            max_units <= std::numeric_limits<size_t>::max() / s,
+                            ErrorCode::InvalidShape,
+                            "nd - 7: element count overflows the index type.");
+
+                        max_units *= s;
                     }
 
                     this->_nunits =
                         std::accumulate(
                             shape.begin(),
                             shape.end(),
-                            1,
+                            size_t(1),
                             std::multiplies<size_t>());
 
                     for (size_t i = 0, prev_dims = 1; i < shape.size(); ++i)
@@ -79,9 +118,7 @@ namespace NumC
                         this->_indices.push_back(indices_t(0, shape[i]));
                     }
 
-                    this->__data =
-                        dtype_shrd_ptr(
-                            (dtype_ptr)malloc(sizeof(dtype) * this->_nunits));
+                    this->__allocate(init == ArrayInit::Zeros);
                 }
 
                 /**
@@ -95,9 +132,7 @@ namespace NumC
                     this->_dims.push_back(list.size());
                     this->_strides.push_back(1);
                     this->_indices.push_back(indices_t(0, list.size()));
-                    this->__data =
-                        dtype_shrd_ptr(
-                            (dtype_ptr)malloc(sizeof(dtype) * this->_nunits));
+                    this->__allocate();
                     this->__copy_data(list);
                 }
 
@@ -108,22 +143,21 @@ namespace NumC
                  */
                 NdArray(init_2d list_2d)
                 {
-                    if (list_2d.size() == 0)
-                    {
-                        std::cout << "ERROR - nd - 3" << std::endl;
-                        // throw error
-                    }
+                    NUMC_CHECK(
+                        list_2d.size() != 0,
+                        ErrorCode::InvalidShape,
+                        "nd - 3: 2D list cannot be empty.");
 
                     auto list_1d_ptr = list_2d.begin();
 
                     for (size_t i = 0; i < list_2d.size() - 1; ++i)
                     {
-                        if (list_1d_ptr[i].size() == 0 ||
-                            (list_1d_ptr[i].size() != list_1d_ptr[i + 1].size()))
-                        {
-                            std::cout << "ERROR - nd - 4" << std::endl;
-                            // throw error
-                        }
+                        NUMC_CHECK(
+                            list_1d_ptr[i].size() != 0 &&
+                            list_1d_ptr[i].size() == list_1d_ptr[i + 1].size(),
+                            ErrorCode::InvalidShape,
+                            "nd - 4: rows must be non-empty and of equal "
+                            "size.");
                     }
 
                     size_t m = list_2d.size(), n = list_1d_ptr[0].size();
@@ -139,9 +173,7 @@ namespace NumC
                     this->_indices.push_back(indices_t(0, m));
                     this->_indices.push_back(indices_t(0, n));
 
-                    this->__data =
-                        dtype_shrd_ptr(
-                            (dtype_ptr)malloc(sizeof(dtype) * this->_nunits));
+                    this->__allocate();
 
                     // Copying data.
                     for (size_t i = 0, r = 0; i < m; ++i, r = r + n)
@@ -155,35 +187,34 @@ namespace NumC
                  */
                 NdArray(init_3d list_3d)
                 {
-                    if (list_3d.size() == 0)
-                    {
-                        std::cout << "ERROR - nd - 4" << std::endl;
-                        // throw error
-                    }
+                    NUMC_CHECK(
+                        list_3d.size() != 0,
+                        ErrorCode::InvalidShape,
+                        "nd - 4: 3D list cannot be empty.");
 
                     auto list_2d_ptr = list_3d.begin();
                     size_t n = list_2d_ptr[0].size();
 
                     for (size_t i = 0; i < list_3d.size(); ++i)
                     {
-                        if (list_2d_ptr[i].size() == 0 ||
-                            (list_2d_ptr[i].size() != n))
-                        {
-                            std::cout << "ERROR - nd - 5" << std::endl;
-                            // throw error
-                        }
+                        NUMC_CHECK(
+                            list_2d_ptr[i].size() != 0 &&
+                            list_2d_ptr[i].size() == n,
+                            ErrorCode::InvalidShape,
+                            "nd - 5: matrices must be non-empty and of equal "
+                            "size.");
 
                         auto list_1d_ptr = list_2d_ptr[i].begin();
 
                         for (size_t j = 0; j < n - 1; ++j)
                         {
-                            if (list_1d_ptr[j].size() == 0||
-                                (list_1d_ptr[j].size() !=
-                                    list_1d_ptr[j + 1].size()))
-                            {
-                                std::cout << "ERROR - nd - 6" << std::endl;
-                                // throw error
-                            }
+                            NUMC_CHECK(
+                                list_1d_ptr[j].size() != 0 &&
+                                list_1d_ptr[j].size() ==
+                                    list_1d_ptr[j + 1].size(),
+                                ErrorCode::InvalidShape,
+                                "nd - 6: rows must be non-empty and of equal "
+                                "size.");
                         }
                     }
 
@@ -204,9 +235,7 @@ namespace NumC
                     this->_indices.push_back(indices_t(0, n));
                     this->_indices.push_back(indices_t(0, o));
 
-                    this->__data =
-                        dtype_shrd_ptr(
-                            (dtype_ptr)malloc(sizeof(dtype) * this->_nunits));
+                    this->__allocate();
 
                     for (size_t i = 0, r = 0; i < m; ++i)
                     {
@@ -217,6 +246,16 @@ namespace NumC
                     }
                 }
 
+                /**
+                 * @brief Default copy constructor. The data is shared: writes
+                 * through one array show in the other, unless copy-on-write
+                 * is enabled. Use copy() for an independent buffer.
+                 */
+                NdArray(const NdArray<dtype>& other) = default;
+
+                /// @brief Default move constructor.
+                NdArray(NdArray<dtype>&& other) = default;
+
                 /// @brief Destroy the Nd Array object.
                 ~NdArray() = default;
 
@@ -240,6 +279,52 @@ namespace NumC
                     return this->_strides;
                 }
 
+                /**
+                 * @brief Gets the step, in elements of the underlying data
+                 * buffer, along each dimension. Unlike strides(), these
+                 * describe where a view's elements actually are, so that
+                 * kernels can walk arrays and views alike without copies.
+                 *
+                 * @return List of buffer strides along each dimension.
+                 */
+                virtual stride_t memory_strides() const
+                {
+                    return this->_strides;
+                }
+
+                /**
+                 * @brief Gets the position of the first element in the
+                 * underlying data buffer.
+                 *
+                 * @return Buffer offset of element 0.
+                 */
+                virtual size_t memory_offset() const
+                {
+                    return 0;
+                }
+
+                /**
+                 * @brief Gets the read-only pointer to the underlying data
+                 * buffer, which for views is the viewed array's.
+                 *
+                 * @return Pointer to the underlying data buffer.
+                 */
+                virtual const dtype* memory_data() const
+                {
+                    return this->__data.get();
+                }
+
+                /**
+                 * @brief Gets the pointer to the underlying data buffer for
+                 * writing. A shared copy-on-write buffer is copied first.
+                 *
+                 * @return Pointer to the underlying data buffer.
+                 */
+                virtual dtype* mutable_memory_data()
+                {
+                    return this->data();
+                }
+
                 /**
                  * @brief Gets the pair of start and end indices along each
                  * dimension.
@@ -251,6 +336,16 @@ namespace NumC
                     return this->_indices;
                 }
 
+                /**
+                 * @brief Gets the total number of elements in the array/view.
+                 *
+                 * @return Number of elements.
+                 */
+                size_t size() const
+                {
+                    return this->_nunits;
+                }
+
                 /**
                  * @brief Gets the array element from memory.
                  *
@@ -261,11 +356,10 @@ namespace NumC
                  */
                 virtual dtype get(size_t index) const
                 {
-                    if (index < 0 && index >= this->_nunits)
-                    {
-                        std::cout << "ERROR - nd - 5" << std::endl;
-                        // throw error
-                    }
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "nd - 8: get index out of bounds.");
 
                     return this->__data.get()[index];
                 }
@@ -280,12 +374,12 @@ namespace NumC
                  */
                 virtual void set(size_t index, dtype value)
                 {
-                    if (index < 0 && index >= this->_nunits)
-                    {
-                        std::cout << "ERROR - nd - 6" << std::endl;
-                        // throw error
-                    }
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "nd - 9: set index out of bounds.");
 
+                    this->__detach();
                     this->__data.get()[index] = value;
                 }
 
@@ -296,6 +390,8 @@ namespace NumC
                  */
                 virtual Iterator<dtype> begin()
                 {
+                    this->__detach();
+
                     return Iterator<dtype>(
                         this->__data.get(),
                         0,
@@ -309,6 +405,8 @@ namespace NumC
                  */
                 virtual Iterator<dtype> end()
                 {
+                    this->__detach();
+
                     return Iterator<dtype>(this->__data.get(), this->_nunits);
                 }
 
@@ -336,11 +434,132 @@ namespace NumC
                 }
 
                 /**
-                 * @brief Gets the pointer to the data array.
+                 * @brief Gets the pointer to the data array. A shared
+                 * copy-on-write buffer is copied first, as the pointer may be
+                 * written through.
                  *
                  * @return Pointer to the data array.
                  */
                 dtype_ptr data()
+                {
+                    this->__detach();
+
+                    return this->__data.get();
+                }
+
+                /**
+                 * @brief Gets the read-only pointer to the data array.
+                 *
+                 * @return Read-only pointer to the data array.
+                 */
+                const dtype* data() const
+                {
+                    return this->__data.get();
+                }
+
+                /**
+                 * @brief Deep copies the array into a new buffer. The copy
+                 * runs in parallel chunks on the shared pool. Views are
+                 * copied into a contiguous array of their own shape.
+                 *
+                 * @note The copy does not inherit copy-on-write.
+                 *
+                 * @return New array owning its data.
+                 */
+                virtual NdArray<dtype> copy() const
+                {
+                    NUMC_TRACE_SCOPE("copy", "memory");
+
+                    NdArray<dtype> result(this->shape());
+
+                    copy_buffer(
+                        result.__data.get(),
+                        (const dtype*)this->__data.get(),
+                        this->_nunits);
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits,
+                        this->_nunits * sizeof(dtype),
+                        trace_describe(result));
+
+                    return result;
+                }
+
+                /**
+                 * @brief Converts the array into a new array of another
+                 * element type, in bulk and in parallel. Views are converted
+                 * into a contiguous array of their own shape.
+                 *
+                 * @tparam U Element type of the result.
+                 * @param mode Handling of values outside an integer
+                 * result's range. Defaults to CastMode::Truncate, the plain
+                 * C++ conversion.
+                 * @return New array of type U.
+                 */
+                template<typename U>
+                NdArray<U> astype(CastMode mode = CastMode::Truncate) const
+                {
+                    NUMC_TRACE_SCOPE("astype", "memory");
+
+                    // Views have no buffer of their own: gather them first.
+                    NdArray<dtype> gathered;
+                    const dtype* in = this->__data.get();
+
+                    if (in == nullptr)
+                    {
+                        gathered = this->copy();
+                        in = gathered.__data.get();
+                    }
+
+                    NdArray<U> result(this->shape());
+
+                    cast_buffer(in, result.data(), this->_nunits, mode);
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits,
+                        this->_nunits * (sizeof(dtype) + sizeof(U)),
+                        trace_describe(result));
+
+                    return result;
+                }
+
+                /**
+                 * @brief Enables or disables copy-on-write. When enabled,
+                 * copies made from this array share its buffer until one of
+                 * them is written through set(), begin()/end() or data(),
+                 * which then moves the writer to a private copy.
+                 *
+                 * @note Copies inherit the setting. Disabling it does not
+                 * split a buffer already shared: later writes show in every
+                 * array sharing it.
+                 *
+                 * @warning Pointers and iterators taken before a write that
+                 * splits the buffer keep pointing to the shared one.
+                 *
+                 * @param enable True to enable.
+                 */
+                void set_copy_on_write(bool enable)
+                {
+                    this->__cow = enable;
+                }
+
+                /**
+                 * @brief Checks if copy-on-write is enabled.
+                 *
+                 * @return True if enabled.
+                 */
+                bool copy_on_write() const
+                {
+                    return this->__cow;
+                }
+
+                /**
+                 * @brief Identifies the buffer the array reads from. Views
+                 * report the buffer of the array they are based on.
+                 *
+                 * @return Address of the data buffer.
+                 */
+                virtual const void* buffer_id() const
                 {
                     return this->__data.get();
                 }
@@ -349,23 +568,39 @@ namespace NumC
                 NdArray<dtype>&
                 operator=(NdArray<dtype> const& other) = default;
 
+                /// @brief Default move assignment operator.
+                NdArray<dtype>&
+                operator=(NdArray<dtype>&& other) = default;
+
                 /**
                  * @brief Element-wise addition operator overload.
                  * Performs the operation on 2 arrays if their shape is same and
                  * returns a new array containing the result.
                  *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>,
+                 * as in NumPy. Operands of another type are converted once,
+                 * in bulk, before the operation.
+                 *
                  * @tparam rhs_t RHS array element type. Allows operation on
                  * arrays of 2 different types.
                  * @param rhs Rhs array reference.
                  * @return New array containing the result.
                  */
                 template<typename rhs_t>
-                NdArray<dtype> operator+(const NdArray<rhs_t>& rhs) const
+                NdArray<promote_t<dtype, rhs_t>>
+                operator+(const NdArray<rhs_t>& rhs) const
                 {
-                    std::function<dtype(dtype, rhs_t)> func =
-                        [] (dtype x, rhs_t y) -> dtype { return x + y; };
-
-                    return array_broadcast(*this, rhs, func);
+                    using res_t = promote_t<dtype, rhs_t>;
+                    std::function<res_t(res_t, res_t)> func =
+                        [] (res_t x, res_t y) -> res_t { return x + y; };
+                    NdArray<res_t> lhs_buf, rhs_buf;
+
+                    return array_broadcast(
+                        promoted(*this, lhs_buf),
+                        promoted(rhs, rhs_buf),
+                        func,
+                        ElementOp::Add,
+                        "add");
                 }
 
                 /**
@@ -373,18 +608,30 @@ namespace NumC
                  * Performs the operation on 2 arrays if their shape is same and
                  * returns a new array containing the result.
                  *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>,
+                 * as in NumPy. Operands of another type are converted once,
+                 * in bulk, before the operation.
+                 *
                  * @tparam rhs_t RHS array element type. Allows operation on
                  * arrays of 2 different types.
                  * @param rhs Rhs array reference.
                  * @return New array containing the result.
                  */
                 template<typename rhs_t>
-                NdArray<dtype> operator-(const NdArray<rhs_t>& rhs) const
+                NdArray<promote_t<dtype, rhs_t>>
+                operator-(const NdArray<rhs_t>& rhs) const
                 {
-                    std::function<dtype(dtype, rhs_t)> func =
-                        [] (dtype x, rhs_t y) -> dtype { return x - y; };
-
-                    return array_broadcast(*this, rhs, func);
+                    using res_t = promote_t<dtype, rhs_t>;
+                    std::function<res_t(res_t, res_t)> func =
+                        [] (res_t x, res_t y) -> res_t { return x - y; };
+                    NdArray<res_t> lhs_buf, rhs_buf;
+
+                    return array_broadcast(
+                        promoted(*this, lhs_buf),
+                        promoted(rhs, rhs_buf),
+                        func,
+                        ElementOp::Subtract,
+                        "subtract");
                 }
 
                 /**
@@ -392,18 +639,30 @@ namespace NumC
                  * Performs the operation on 2 arrays if their shape is same and
                  * returns a new array containing the result.
                  *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>,
+                 * as in NumPy. Operands of another type are converted once,
+                 * in bulk, before the operation.
+                 *
                  * @tparam rhs_t RHS array element type. Allows operation on
                  * arrays of 2 different types.
                  * @param rhs Rhs array reference.
                  * @return New array containing the result.
                  */
                 template<typename rhs_t>
-                NdArray<dtype> operator*(const NdArray<rhs_t>& rhs) const
+                NdArray<promote_t<dtype, rhs_t>>
+                operator*(const NdArray<rhs_t>& rhs) const
                 {
-                    std::function<dtype(dtype, rhs_t)> func =
-                        [] (dtype x, rhs_t y) -> dtype { return x * y; };
-
-                    return array_broadcast(*this, rhs, func);
+                    using res_t = promote_t<dtype, rhs_t>;
+                    std::function<res_t(res_t, res_t)> func =
+                        [] (res_t x, res_t y) -> res_t { return x * y; };
+                    NdArray<res_t> lhs_buf, rhs_buf;
+
+                    return array_broadcast(
+                        promoted(*this, lhs_buf),
+                        promoted(rhs, rhs_buf),
+                        func,
+                        ElementOp::Multiply,
+                        "multiply");
                 }
 
                 /**
@@ -413,25 +672,38 @@ namespace NumC
                  *
                  * @note A 0 element divisor results in +- inf.
                  *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>,
+                 * as in NumPy. Operands of another type are converted once,
+                 * in bulk, before the operation.
+                 *
                  * @tparam rhs_t RHS array element type. Allows operation on
                  * arrays of 2 different types.
                  * @param rhs Rhs array reference.
                  * @return New array containing the result.
                  */
                 template<typename rhs_t>
-                NdArray<dtype> operator/(const NdArray<rhs_t>& rhs) const
+                NdArray<promote_t<dtype, rhs_t>>
+                operator/(const NdArray<rhs_t>& rhs) const
                 {
-                    std::function<dtype(dtype, rhs_t)> func =
-                        [] (dtype x, rhs_t y) -> dtype { return x / y; };
-
-                    return array_broadcast(*this, rhs, func);
+                    using res_t = promote_t<dtype, rhs_t>;
+                    std::function<res_t(res_t, res_t)> func =
+                        [] (res_t x, res_t y) -> res_t { return x / y; };
+                    NdArray<res_t> lhs_buf, rhs_buf;
+
+                    return array_broadcast(
+                        promoted(*this, lhs_buf),
+                        promoted(rhs, rhs_buf),
+                        func,
+                        ElementOp::Divide,
+                        "divide");
                 }
 
                 /**
                  * @brief Element-wise addition scalar operator overload.
                  * Performs the operation on an array and any scalar.
                  *
-                 * @note Scalar value passed is typecast to a Float64.
+                 * @note Scalar value passed is typecast to a Float64, or to
+                 * the component type of a complex array.
                  *
                  * @param rhs Rhs scalar value.
                  * @return New array containing the result.
@@ -439,16 +711,25 @@ namespace NumC
                 NdArray<dtype> operator+(const float64& rhs) const
                 {
                     std::function<dtype(dtype, float64)> func =
-                        [] (dtype x, float64 y) -> dtype { return x + y; };
+                        [] (dtype x, float64 y) -> dtype
+                        {
+                            return x + scalar_t(y);
+                        };
 
-                    return scalar_broadcast(*this, rhs, func);
+                    return scalar_broadcast(
+                        *this,
+                        rhs,
+                        func,
+                        ElementOp::Add,
+                        "scalar_add");
                 }
 
                 /**
                  * @brief Element-wise subtraction scalar operator overload.
                  * Performs the operation on an array and any scalar.
                  *
-                 * @note Scalar value passed is typecast to a Float64.
+                 * @note Scalar value passed is typecast to a Float64, or to
+                 * the component type of a complex array.
                  *
                  * @param rhs Rhs scalar value.
                  * @return New array containing the result.
@@ -456,16 +737,25 @@ namespace NumC
                 NdArray<dtype> operator-(const float64& rhs) const
                 {
                     std::function<dtype(dtype, float64)> func =
-                        [] (dtype x, float64 y) -> dtype { return x - y; };
+                        [] (dtype x, float64 y) -> dtype
+                        {
+                            return x - scalar_t(y);
+                        };
 
-                    return scalar_broadcast(*this, rhs, func);
+                    return scalar_broadcast(
+                        *this,
+                        rhs,
+                        func,
+                        ElementOp::Subtract,
+                        "scalar_subtract");
                 }
 
                 /**
                  * @brief Element-wise multiplication scalar operator overload.
                  * Performs the operation on an array and any scalar.
                  *
-                 * @note Scalar value passed is typecast to a Float64.
+                 * @note Scalar value passed is typecast to a Float64, or to
+                 * the component type of a complex array.
                  *
                  * @param rhs Rhs scalar value.
                  * @return New array containing the result.
@@ -473,16 +763,25 @@ namespace NumC
                 NdArray<dtype> operator*(const float64& rhs) const
                 {
                     std::function<dtype(dtype, float64)> func =
-                        [] (dtype x, float64 y) -> dtype { return x * y; };
+                        [] (dtype x, float64 y) -> dtype
+                        {
+                            return x * scalar_t(y);
+                        };
 
-                    return scalar_broadcast(*this, rhs, func);
+                    return scalar_broadcast(
+                        *this,
+                        rhs,
+                        func,
+                        ElementOp::Multiply,
+                        "scalar_multiply");
                 }
 
                 /**
                  * @brief Element-wise division scalar operator overload.
                  * Performs the operation on an array and any scalar.
                  *
-                 * @note Scalar value passed is typecast to a Float64.
+                 * @note Scalar value passed is typecast to a Float64, or to
+                 * the component type of a complex array.
                  *
                  * @warning A 0 element divisor results in +- inf.
                  *
@@ -492,9 +791,17 @@ namespace NumC
                 NdArray<dtype> operator/(const float64& rhs) const
                 {
                     std::function<dtype(dtype, float64)> func =
-                        [] (dtype x, float64 y) -> dtype { return x / y; };
+                        [] (dtype x, float64 y) -> dtype
+                        {
+                            return x / scalar_t(y);
+                        };
 
-                    return scalar_broadcast(*this, rhs, func);
+                    return scalar_broadcast(
+                        *this,
+                        rhs,
+                        func,
+                        ElementOp::Divide,
+                        "scalar_divide");
                 }
 
             protected:
@@ -519,6 +826,50 @@ namespace NumC
                 /// @brief 1-D array storing the actual data.
                 dtype_shrd_ptr __data;
 
+                /// @brief Copies share __data until written.
+                bool __cow = false;
+
+                /**
+                 * @brief Internal helper method moving this array to a
+                 * private copy of its buffer before a write, if copy-on-write
+                 * is enabled and the buffer is shared.
+                 */
+                void __detach()
+                {
+                    if (!this->__cow || this->__data.use_count() <= 1)
+                        return;
+
+                    NUMC_TRACE_SCOPE("NdArray::detach", "memory");
+
+                    dtype_shrd_ptr shared = this->__data;
+
+                    this->__allocate();
+                    copy_buffer(
+                        this->__data.get(),
+                        (const dtype*)shared.get(),
+                        this->_nunits);
+                }
+
+                /**
+                 * @brief Internal helper method allocating the data array for
+                 * _nunits elements. The buffer is charged to the active
+                 * memory tracker.
+                 *
+                 * @param zeroed Zero the buffer.
+                 */
+                void __allocate(bool zeroed = false)
+                {
+                    NUMC_TRACE_SCOPE("NdArray::allocate", "memory");
+
+                    this->__data =
+                        allocate_buffer<dtype>(this->_nunits, zeroed);
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits,
+                        this->_nunits * sizeof(dtype),
+                        trace_describe(*this));
+                }
+
                 /**
                  * @brief Internal helper method to copy data from 1D
                  * initializer list to the data array.
@@ -557,25 +908,58 @@ namespace NumC
                         return validate_broadcast(rhs, lhs);
 
                     shape_t result_shape(lhs.size());
-                    size_t l = lhs.size();
+                    size_t l = lhs.size() - 1;
 
-                    for (size_t r = rhs.size(); r >= 0; --r, --l)
+                    for (size_t r = rhs.size() - 1; r >= 0; --r, --l)
                     {
-                        if (rhs[r] != lhs[l] && rhs[r] > 1 && lhs[l] > 1)
-                        {
-                            std::cout << "ERROR - broadcast - 1" << std::endl;
-                            // throw error.
-                        }
+                        NUMC_CHECK(
+                            rhs[r] == lhs[l] || rhs[r] == 1 || lhs[l] == 1,
+                            ErrorCode::BroadcastError,
+                            "broadcast - 1: shapes cannot be broadcast "
+                            "together.");
 
                         result_shape[l] = std::max(rhs[r], lhs[l]);
                     }
 
-                    while (l >= 0)
-                        result_shape[l--] = lhs[l];
+                    for (; l >= 0; --l)
+                        result_shape[l] = lhs[l];
 
                     return result_shape;
                 }
 
+                /**
+                 * @brief Gets an operand as an array of U: the array itself
+                 * when it already is one.
+                 *
+                 * @tparam U Element type of the operation.
+                 * @param array Reference to the operand.
+                 * @return Reference to the operand.
+                 */
+                template<typename U>
+                static const NdArray<U>&
+                promoted(const NdArray<U>& array, NdArray<U>&)
+                {
+                    return array;
+                }
+
+                /**
+                 * @brief Gets an operand as an array of U, converted in bulk.
+                 *
+                 * @tparam U Element type of the operation.
+                 * @tparam S Element type of the operand.
+                 * @param array Reference to the operand.
+                 * @param storage Array receiving the converted operand.
+                 * @return Reference to storage.
+                 */
+                template<typename U, typename S>
+                static const NdArray<U>&
+                promoted(const NdArray<S>& array, NdArray<U>& storage)
+                {
+                    storage = array.template astype<U>();
+
+                    return storage;
+                }
+
                 /**
                  * @brief Static helper method that performs an element level
                  * operation on two arrays that need not have the same shape.
@@ -601,6 +985,9 @@ namespace NumC
                  * @param rhs Reference to the RHS array.
                  * @param element_op Reference to the operation function to be
                  * performed between elements of the 2 arrays.
+                 * @param op Operation, used to pick a dedicated kernel for
+                 * contiguous arrays of the same shape.
+                 * @param op_name Operation name reported to the tracer.
                  * @return New array of the broadcasted shape containing the
                  * result.
                  */
@@ -609,89 +996,66 @@ namespace NumC
                 array_broadcast(
                     const NdArray<lhs_t>& lhs,
                     const NdArray<rhs_t>& rhs,
-                    std::function<res_t(lhs_t, rhs_t)>& element_op)
+                    std::function<res_t(lhs_t, rhs_t)>& element_op,
+                    ElementOp op,
+                    const char* op_name)
                 {
+                    NUMC_TRACE_SCOPE(op_name, "op");
+
                     auto result_shape =
                         validate_broadcast(lhs.shape(), rhs.shape());
                     auto result = NdArray<res_t>(result_shape);
 
-                    auto lhs_shape = lhs.shape();
-                    auto rhs_shape = rhs.shape();
-                    auto n_lhs = lhs_shape.size();
-                    auto n_rhs = rhs_shape.size();
-                    auto n_res = result_shape.size();
-
-                    /**
-                     * @brief Internal helper lambda that's not generic enough
-                     * to be exposed. Helps recursively go through each element
-                     * in a broadcasted method and perform the required
-                     * operation.
-                     */
-                    std::function<void(size_t, size_t, size_t, size_t)>
-                    broadcast_helper =
-                        [&](size_t axis,size_t lhs_i, size_t rhs_i, size_t res_i)
-                        {
-                            size_t lhs_pre = lhs_i;
-                            size_t rhs_pre = rhs_i;
-                            size_t res_pre = res_i;
-
-                            for (size_t i = 0; i < result_shape[axis]; ++i)
+                    // Contiguous operands of the same shape go through a
+                    // dedicated kernel when the types have one.
+                    const bool kernel =
+                        lhs.data() != nullptr &&
+                        rhs.data() != nullptr &&
+                        lhs.shape() == rhs.shape() &&
+                        Detail::ElementKernel<lhs_t, rhs_t, res_t>::apply(
+                            op,
+                            lhs.data(),
+                            rhs.data(),
+                            result.data(),
+                            result.size());
+
+                    // Otherwise all three are walked in buffer order, with
+                    // broadcast axes at stride 0 and contiguous axes merged
+                    // into long inner loops.
+                    if (!kernel)
+                    {
+                        NdIter iter;
+
+                        iter.add_input(lhs).add_input(rhs).add_output(result);
+                        iter.parallel_for_each(
+                            [&](
+                                char* const* ptrs,
+                                const size_t* strides,
+                                size_t count)
                             {
-                                // Ensures that index is not updated in case the
-                                // right- based shape vector hasn't begun yet.
-                                // Indices would begin once n_res - axis is
-                                // equal to n_l.
-                                // Correspondin index 0 would be given by
-                                // n_l - (n_res - axis) or n_l + axis - n_res.
-                                // The reason this is checked for both is
-                                // because either could be the smaller array.
-                                if (n_lhs + axis >= n_res)
-                                {
-                                    // The above condition would always be true
-                                    // for the larger array.
-                                    // Thus, the following ternary to ensure
-                                    // that the index formular is used only if
-                                    // array is smaller.
-                                    auto axis_l =
-                                        n_res > n_lhs ?
-                                        n_lhs + axis - n_res : axis;
-                                    lhs_i =
-                                        lhs_pre +
-                                        (i % lhs_shape[axis_l]) *
-                                            lhs.strides()[axis_l];
-                                }
+                                char* l = ptrs[0];
+                                char* r = ptrs[1];
+                                char* o = ptrs[2];
 
-                                if (n_rhs + axis >= n_res)
+                                for (size_t i = 0; i < count; ++i)
                                 {
-                                    auto axis_r =
-                                        n_res > n_rhs ?
-                                        n_rhs + axis - n_res : axis;
-                                    rhs_i =
-                                        rhs_pre +
-                                        (i % rhs_shape[axis_r]) *
-                                            rhs.strides()[axis_r];
-                                }
+                                    *reinterpret_cast<res_t*>(o) = element_op(
+                                        *reinterpret_cast<const lhs_t*>(l),
+                                        *reinterpret_cast<const rhs_t*>(r));
 
-                                res_i = res_pre + i * result.strides()[axis];
-
-                                // Recurse until the final axis is reached.
-                                // Perform the element operation then.
-                                if (n_res - 1 > axis)
-                                    broadcast_helper(
-                                        axis + 1,
-                                        lhs_i,
-                                        rhs_i,
-                                        res_i);
-                                else
-                                    result.set(
-                                        res_i,
-                                        element_op(
-                                            lhs.get(lhs_i),
-                                            rhs.get(rhs_i)));
-                            }
-                        };
+                                    l += strides[0];
+                                    r += strides[1];
+                                    o += strides[2];
+                                }
+                            });
+                    }
 
-                    broadcast_helper(0, 0, 0, 0);
+                    NUMC_TRACE_INFO(
+                        result.size(),
+                        lhs.size() * sizeof(lhs_t) +
+                            rhs.size() * sizeof(rhs_t) +
+                            result.size() * sizeof(res_t),
+                        trace_describe(lhs) + ", " + trace_describe(rhs));
 
                     return result;
                 }
@@ -707,6 +1071,9 @@ namespace NumC
                  * @param rhs Scalar value.
                  * @param element_op Reference to the operation function to be
                  * performed between the array element and scalar value.
+                 * @param op Operation, used to pick a dedicated kernel for
+                 * contiguous arrays.
+                 * @param op_name Operation name reported to the tracer.
                  * @return New array of the broadcasted shape containing the
                  * result.
                  */
@@ -715,14 +1082,50 @@ namespace NumC
                 scalar_broadcast(
                     const NdArray<lhs_t>& lhs,
                     const rhs_t rhs,
-                    std::function<res_t(lhs_t, rhs_t)>& element_op)
+                    std::function<res_t(lhs_t, rhs_t)>& element_op,
+                    ElementOp op,
+                    const char* op_name)
                 {
+                    NUMC_TRACE_SCOPE(op_name, "op");
+
                     auto result = NdArray<res_t>(lhs.shape());
-                    auto it_res = result.begin();
-                    auto it_lhs = lhs.cbegin(), ite_lhs = lhs.cend();
 
-                    for (; it_lhs != ite_lhs; ++it_lhs, ++it_res)
-                        *it_res = element_op(*it_lhs, rhs);
+                    const bool kernel =
+                        lhs.data() != nullptr &&
+                        Detail::ScalarKernel<lhs_t>::apply(
+                            op, lhs.data(), rhs, result.data(), result.size());
+
+                    if (!kernel)
+                    {
+                        NdIter iter;
+
+                        iter.add_input(lhs).add_output(result);
+                        iter.parallel_for_each(
+                            [&](
+                                char* const* ptrs,
+                                const size_t* strides,
+                                size_t count)
+                            {
+                                char* l = ptrs[0];
+                                char* o = ptrs[1];
+
+                                for (size_t i = 0; i < count; ++i)
+                                {
+                                    *reinterpret_cast<res_t*>(o) = element_op(
+                                        *reinterpret_cast<const lhs_t*>(l),
+                                        rhs);
+
+                                    l += strides[0];
+                                    o += strides[1];
+                                }
+                            });
+                    }
+
+                    NUMC_TRACE_INFO(
+                        result.size(),
+                        lhs.size() * sizeof(lhs_t) +
+                            result.size() * sizeof(res_t),
+                        trace_describe(lhs));
 
                     return result;
                 }
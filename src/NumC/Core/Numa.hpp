@@ -0,0 +1,589 @@
+#pragma once
+
+#define PLACEMENT_SCOPE NumC::Core::PlacementScope
+
+#include <NumC/Core/Type.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief Where the pages of a large buffer are placed.
+        enum class Placement
+        {
+            /// @brief Plain heap allocation, pages land where first written.
+            Default,
+
+            /// @brief Pages are faulted in by the pool workers, one
+            /// contiguous block each, block i always on worker i.
+            FirstTouch,
+
+            /// @brief Pages are spread round-robin over the allowed nodes.
+            Interleave,
+
+            /// @brief Pages are bound to one node.
+            Bind
+        };
+
+        /// @brief Huge page backing of a large buffer.
+        enum class HugePages
+        {
+            /// @brief Regular pages.
+            None,
+
+            /// @brief 2 MB aligned mapping advised with MADV_HUGEPAGE.
+            Transparent,
+
+            /// @brief MAP_HUGETLB from the hugetlbfs pool, Transparent if
+            /// the pool is exhausted.
+            Explicit
+        };
+
+        /// @brief Placement of the buffers allocated on a thread.
+        struct PlacementPolicy
+        {
+            /// @brief Placement mode.
+            Placement mode = Placement::Default;
+
+            /// @brief Node used by Placement::Bind.
+            int node = 0;
+
+            /// @brief Smaller buffers are not placed.
+            size_t min_bytes = size_t(1) << 20;
+
+            /// @brief Huge page backing.
+            HugePages huge_pages = HugePages::None;
+
+            /// @brief Smaller buffers use regular pages.
+            size_t huge_page_min_bytes = size_t(8) << 20;
+        };
+
+        /// @brief How a tracked buffer was obtained.
+        enum class BufferKind
+        {
+            /// @brief std::malloc().
+            Heap,
+
+            /// @brief Page aligned mapping.
+            Mapped,
+
+            /// @brief 2 MB aligned mapping advised with MADV_HUGEPAGE.
+            HugeMapped,
+
+            /// @brief MAP_HUGETLB mapping.
+            HugeTlb
+        };
+
+        /// @brief Huge page size assumed for alignment.
+        const size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+        /// @brief Range of a buffer placed on one node.
+        struct NodeRange
+        {
+            /// @brief Offset from the buffer start in bytes.
+            size_t offset;
+
+            /// @brief Length in bytes.
+            size_t bytes;
+
+            /// @brief Node owning the range, -1 if not faulted in yet or
+            /// unknown.
+            int node;
+        };
+
+        namespace Detail
+        {
+            /// @brief Mempolicy constants (linux/mempolicy.h).
+            enum
+            {
+                MPOL_BIND_MODE = 2,
+                MPOL_INTERLEAVE_MODE = 3,
+                MPOL_F_MEMS_ALLOWED_FLAG = 4
+            };
+
+            /// @brief Node mask size in bits.
+            const size_t NODE_MASK_BITS = 1024;
+
+            using node_mask_t = std::vector<unsigned long>;
+
+            /// @brief Gets the nodes the process may allocate on.
+            inline node_mask_t allowed_nodes()
+            {
+                const size_t word_bits = 8 * sizeof(unsigned long);
+                node_mask_t mask(NODE_MASK_BITS / word_bits, 0);
+#ifdef __linux__
+                int mode = 0;
+
+                if (syscall(
+                        SYS_get_mempolicy,
+                        &mode,
+                        mask.data(),
+                        NODE_MASK_BITS + 1,
+                        nullptr,
+                        MPOL_F_MEMS_ALLOWED_FLAG) == 0)
+                    return mask;
+#endif
+                mask[0] = 1;
+
+                return mask;
+            }
+        }
+
+        /**
+         * @brief Gets the number of NUMA nodes the process may allocate on.
+         *
+         * @return Number of nodes, 1 without NUMA support.
+         */
+        inline size_t numa_node_count()
+        {
+            size_t count = 0;
+
+            for (unsigned long word : Detail::allowed_nodes())
+                for (; word != 0; word &= word - 1)
+                    ++count;
+
+            return std::max<size_t>(count, 1);
+        }
+
+        /**
+         * @brief Makes a placement policy the active one on the current
+         * thread for the lifetime of the scope.
+         */
+        class PlacementScope
+        {
+            public:
+                /**
+                 * @brief Construct a new Placement Scope object.
+                 *
+                 * @param policy Placement of the buffers allocated in the
+                 * scope.
+                 */
+                explicit PlacementScope(const PlacementPolicy& policy)
+                {
+                    stack().push_back(policy);
+                }
+
+                PlacementScope(const PlacementScope&) = delete;
+                PlacementScope& operator=(const PlacementScope&) = delete;
+
+                /// @brief Restores the previously active policy.
+                ~PlacementScope()
+                {
+                    stack().pop_back();
+                }
+
+                /**
+                 * @brief Gets the policy buffers allocated on this thread
+                 * use.
+                 *
+                 * @return Innermost scope policy, else the process default.
+                 */
+                static PlacementPolicy active()
+                {
+                    if (!stack().empty())
+                        return stack().back();
+
+                    if (!customized())
+                        return PlacementPolicy();
+
+                    return default_policy();
+                }
+
+                /**
+                 * @brief Gets the process default policy.
+                 *
+                 * @return Policy used outside any PlacementScope.
+                 */
+                static PlacementPolicy default_policy()
+                {
+                    std::lock_guard<std::mutex> lock(mutex());
+
+                    return shared();
+                }
+
+                /**
+                 * @brief Sets the process default policy.
+                 *
+                 * @param policy Policy used outside any PlacementScope.
+                 */
+                static void set_default_policy(const PlacementPolicy& policy)
+                {
+                    std::lock_guard<std::mutex> lock(mutex());
+
+                    shared() = policy;
+                    customized() = true;
+                }
+
+            private:
+
+                static std::vector<PlacementPolicy>& stack()
+                {
+                    static thread_local std::vector<PlacementPolicy> scopes;
+
+                    return scopes;
+                }
+
+                static PlacementPolicy& shared()
+                {
+                    static PlacementPolicy policy;
+
+                    return policy;
+                }
+
+                /// @brief Set once a default policy was given, so that
+                /// allocations skip the lock until then.
+                static std::atomic<bool>& customized()
+                {
+                    static std::atomic<bool> flag(false);
+
+                    return flag;
+                }
+
+                static std::mutex& mutex()
+                {
+                    static std::mutex m;
+
+                    return m;
+                }
+        };
+
+        /**
+         * @brief Gets the node owning each page of a buffer, merged into
+         * ranges.
+         *
+         * @param ptr Buffer start.
+         * @param bytes Buffer size.
+         * @return Ranges covering the buffer in order. A single range with
+         * node -1 without NUMA support.
+         */
+        inline std::vector<NodeRange> memory_nodes(
+            const void* ptr,
+            size_t bytes)
+        {
+            std::vector<NodeRange> ranges;
+
+            if (ptr == nullptr || bytes <= 0)
+                return ranges;
+#ifdef __linux__
+            const size_t page = sysconf(_SC_PAGESIZE);
+            const uintptr_t start = uintptr_t(ptr);
+            const uintptr_t first = start & ~uintptr_t(page - 1);
+            const size_t n_pages = (start + bytes - first + page - 1) / page;
+            const size_t batch = 4096;
+
+            std::vector<void*> pages(batch);
+            std::vector<int> status(batch);
+
+            for (size_t p = 0; p < n_pages; p += batch)
+            {
+                size_t count = std::min(batch, n_pages - p);
+
+                for (size_t i = 0; i < count; ++i)
+                    pages[i] = (void*)(first + (p + i) * page);
+
+                if (syscall(
+                        SYS_move_pages, 0, count, pages.data(), nullptr,
+                        status.data(), 0) != 0)
+                {
+                    ranges.clear();
+                    break;
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    int node = status[i] >= 0 ? status[i] : -1;
+                    uintptr_t lo = std::max(first + (p + i) * page, start);
+                    uintptr_t hi = std::min(
+                        first + (p + i + 1) * page, start + bytes);
+
+                    if (!ranges.empty() && ranges.back().node == node)
+                        ranges.back().bytes += hi - lo;
+                    else
+                        ranges.push_back(NodeRange{
+                            size_t(lo - start), size_t(hi - lo), node});
+                }
+            }
+
+            if (!ranges.empty())
+                return ranges;
+#endif
+            ranges.push_back(NodeRange{0, bytes, -1});
+
+            return ranges;
+        }
+
+        /**
+         * @brief Gets how much of the mapping holding a buffer is backed by
+         * huge pages.
+         *
+         * @param ptr Pointer into the buffer.
+         * @return Bytes on huge pages, 0 if none or unknown.
+         */
+        inline size_t huge_page_bytes(const void* ptr)
+        {
+#ifdef __linux__
+            std::FILE* file = std::fopen("/proc/self/smaps", "r");
+
+            if (file == nullptr)
+                return 0;
+
+            const uintptr_t address = uintptr_t(ptr);
+            bool found = false;
+            size_t size_kb = 0, page_kb = 0, anon_huge_kb = 0;
+            char line[256];
+
+            while (std::fgets(line, sizeof(line), file) != nullptr)
+            {
+                char* end = nullptr;
+                unsigned long long lo = std::strtoull(line, &end, 16);
+
+                // Mapping header: "lo-hi perms ...".
+                if (end != line && *end == '-')
+                {
+                    if (found)
+                        break;
+
+                    unsigned long long hi = std::strtoull(end + 1, nullptr, 16);
+                    found = address >= lo && address < hi;
+                    continue;
+                }
+
+                if (!found)
+                    continue;
+
+                unsigned long long kb = 0;
+
+                if (std::sscanf(line, "Size: %llu kB", &kb) == 1)
+                    size_kb = kb;
+                else if (std::sscanf(line, "KernelPageSize: %llu kB", &kb) == 1)
+                    page_kb = kb;
+                else if (std::sscanf(line, "AnonHugePages: %llu kB", &kb) == 1)
+                    anon_huge_kb = kb;
+            }
+
+            std::fclose(file);
+
+            if (page_kb >= HUGE_PAGE_BYTES / 1024)
+                return size_kb * 1024;
+
+            return anon_huge_kb * 1024;
+#else
+            (void)ptr;
+
+            return 0;
+#endif
+        }
+
+        namespace Detail
+        {
+            /**
+             * @brief Checks if a buffer goes through map_buffer() rather
+             * than the heap.
+             *
+             * @param bytes Buffer size.
+             * @param policy Placement policy.
+             * @return True to map it.
+             */
+            inline bool needs_mapping(
+                size_t bytes,
+                const PlacementPolicy& policy)
+            {
+                return bytes > 0 &&
+                    ((policy.mode != Placement::Default &&
+                        bytes >= policy.min_bytes) ||
+                    (policy.huge_pages != HugePages::None &&
+                        bytes >= policy.huge_page_min_bytes));
+            }
+
+            /**
+             * @brief Gets the length of the mapping holding a buffer.
+             *
+             * @param bytes Buffer size.
+             * @param kind How the buffer was obtained.
+             * @return Mapping length.
+             */
+            inline size_t mapped_length(size_t bytes, BufferKind kind)
+            {
+                size_t unit = kind == BufferKind::Mapped ?
+                    1 : HUGE_PAGE_BYTES;
+
+                return (bytes + unit - 1) / unit * unit;
+            }
+
+#ifdef __linux__
+            /// @brief Maps length bytes aligned on alignment bytes.
+            inline void* map_aligned(size_t length, size_t alignment)
+            {
+                size_t padded = length + alignment;
+                void* raw = mmap(
+                    nullptr, padded, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (raw == MAP_FAILED)
+                    return nullptr;
+
+                uintptr_t start = uintptr_t(raw);
+                uintptr_t aligned =
+                    (start + alignment - 1) / alignment * alignment;
+
+                // Gives back the unaligned head and the tail.
+                if (aligned > start)
+                    munmap(raw, aligned - start);
+
+                if (start + padded > aligned + length)
+                    munmap(
+                        (void*)(aligned + length),
+                        start + padded - aligned - length);
+
+                return (void*)aligned;
+            }
+#endif
+
+            /**
+             * @brief Maps a buffer backed and placed as the policy says.
+             *
+             * @param bytes Buffer size.
+             * @param policy Placement policy, needs_mapping() must hold.
+             * @param kind Set to how the buffer was obtained.
+             * @return Buffer start, null if mapping is unsupported or failed.
+             */
+            inline void* map_buffer(
+                size_t bytes,
+                const PlacementPolicy& policy,
+                BufferKind& kind)
+            {
+#ifdef __linux__
+                void* ptr = nullptr;
+                bool huge = policy.huge_pages != HugePages::None &&
+                    bytes >= policy.huge_page_min_bytes;
+
+#ifdef MAP_HUGETLB
+                if (huge && policy.huge_pages == HugePages::Explicit)
+                {
+                    kind = BufferKind::HugeTlb;
+                    ptr = mmap(
+                        nullptr, mapped_length(bytes, kind),
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+                    if (ptr == MAP_FAILED)
+                        ptr = nullptr;
+                }
+#endif
+
+                if (ptr == nullptr && huge)
+                {
+                    kind = BufferKind::HugeMapped;
+                    ptr = map_aligned(
+                        mapped_length(bytes, kind), HUGE_PAGE_BYTES);
+#ifdef MADV_HUGEPAGE
+                    // Advisory: regular pages are used if THP is disabled.
+                    if (ptr != nullptr)
+                        madvise(ptr, mapped_length(bytes, kind), MADV_HUGEPAGE);
+#endif
+                }
+
+                if (ptr == nullptr)
+                {
+                    kind = BufferKind::Mapped;
+                    ptr = mmap(
+                        nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                    if (ptr == MAP_FAILED)
+                        return nullptr;
+                }
+
+                if (bytes < policy.min_bytes)
+                    return ptr;
+
+                if (policy.mode == Placement::FirstTouch)
+                {
+                    // One contiguous block per pool worker, block i on
+                    // worker i, the same on every allocation.
+                    const size_t page = sysconf(_SC_PAGESIZE);
+                    const size_t n_pages = (bytes + page - 1) / page;
+                    volatile char* data = static_cast<char*>(ptr);
+
+                    Utils::parallel_for_static(
+                        0,
+                        n_pages,
+                        1,
+                        [&](size_t lo, size_t hi)
+                        {
+                            for (size_t i = lo; i < hi; ++i)
+                                data[i * page] = 0;
+                        });
+                }
+                else if (policy.mode != Placement::Default)
+                {
+                    const size_t word_bits = 8 * sizeof(unsigned long);
+                    node_mask_t mask(NODE_MASK_BITS / word_bits, 0);
+                    int mode = MPOL_INTERLEAVE_MODE;
+
+                    if (policy.mode == Placement::Bind)
+                    {
+                        size_t node = size_t(std::max(policy.node, 0));
+
+                        if (node < NODE_MASK_BITS)
+                            mask[node / word_bits] |=
+                                1ul << (node % word_bits);
+
+                        mode = MPOL_BIND_MODE;
+                    }
+                    else
+                    {
+                        mask = allowed_nodes();
+                    }
+
+                    // Advisory: the pages still get allocated if it fails.
+                    syscall(
+                        SYS_mbind, ptr, mapped_length(bytes, kind), mode,
+                        mask.data(), NODE_MASK_BITS + 1, 0);
+                }
+
+                return ptr;
+#else
+                (void)bytes;
+                (void)policy;
+                (void)kind;
+
+                return nullptr;
+#endif
+            }
+
+            /**
+             * @brief Unmaps a buffer from map_buffer().
+             *
+             * @param ptr Buffer start.
+             * @param bytes Buffer size.
+             * @param kind How the buffer was obtained.
+             */
+            inline void unmap(void* ptr, size_t bytes, BufferKind kind)
+            {
+#ifdef __linux__
+                munmap(ptr, mapped_length(bytes, kind));
+#else
+                (void)ptr;
+                (void)bytes;
+                (void)kind;
+#endif
+            }
+        }
+    }
+}
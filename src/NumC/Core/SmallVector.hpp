@@ -0,0 +1,421 @@
+#pragma once
+
+#define SMALL_VECTOR NumC::Core::SmallVector
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+/**
+ * @brief Number of elements a SmallVector holds inline by default. Shape,
+ * stride and slice metadata of arrays with up to these many dimensions never
+ * touches the heap.
+ */
+#ifndef NUMC_SMALL_VECTOR_SIZE
+#define NUMC_SMALL_VECTOR_SIZE 8
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /**
+         * @brief Vector-like container that stores up to N elements inline
+         * and only falls back to heap storage when it grows beyond that.
+         *
+         * @note Used for array metadata (shape, strides, indices), which is
+         * almost always tiny but gets created for every array and view.
+         *
+         * @tparam T Element data type. Must be default constructible.
+         * @tparam N Inline capacity.
+         */
+        template<typename T, std::size_t N = NUMC_SMALL_VECTOR_SIZE>
+        class SmallVector
+        {
+            public:
+                /// Aliases
+                using value_type = T;
+                using size_type = std::size_t;
+                using difference_type = std::ptrdiff_t;
+                using reference = T&;
+                using const_reference = const T&;
+                using pointer = T*;
+                using const_pointer = const T*;
+                using iterator = T*;
+                using const_iterator = const T*;
+                using reverse_iterator = std::reverse_iterator<iterator>;
+                using const_reverse_iterator =
+                    std::reverse_iterator<const_iterator>;
+
+                /// @brief Default SmallVector constructor.
+                SmallVector() :
+                    __ptr(__buffer),
+                    __size(0),
+                    __capacity(N)
+                {}
+
+                /**
+                 * @brief Construct a new SmallVector object with count copies
+                 * of a value.
+                 *
+                 * @param count Number of elements.
+                 * @param value Value of each element. Defaults to T().
+                 */
+                explicit SmallVector(size_type count, const T& value = T()) :
+                    SmallVector()
+                {
+                    this->resize(count, value);
+                }
+
+                /**
+                 * @brief Construct a new SmallVector object from a list.
+                 *
+                 * @param list Initializer list to be copied.
+                 */
+                SmallVector(std::initializer_list<T> list) :
+                    SmallVector()
+                {
+                    this->assign(list.begin(), list.end());
+                }
+
+                /**
+                 * @brief Construct a new SmallVector object from an iterator
+                 * range.
+                 *
+                 * @param first Iterator to the first element.
+                 * @param last Iterator past the last element.
+                 */
+                template<
+                    typename InputIt,
+                    typename = typename std::iterator_traits<
+                        InputIt>::iterator_category>
+                SmallVector(InputIt first, InputIt last) :
+                    SmallVector()
+                {
+                    this->assign(first, last);
+                }
+
+                /**
+                 * @brief Copy constructor.
+                 *
+                 * @param other SmallVector to be copied.
+                 */
+                SmallVector(const SmallVector& other) :
+                    SmallVector()
+                {
+                    this->assign(other.begin(), other.end());
+                }
+
+                /**
+                 * @brief Move constructor. Heap storage is taken over, inline
+                 * storage is copied.
+                 *
+                 * @param other SmallVector to be moved.
+                 */
+                SmallVector(SmallVector&& other) :
+                    SmallVector()
+                {
+                    this->__take(other);
+                }
+
+                /// @brief Destroy the SmallVector object.
+                ~SmallVector()
+                {
+                    this->__release();
+                }
+
+                /**
+                 * @brief Copy assignment operator.
+                 *
+                 * @param other SmallVector to be copied.
+                 * @return Reference to this.
+                 */
+                SmallVector& operator=(const SmallVector& other)
+                {
+                    if (this != &other)
+                        this->assign(other.begin(), other.end());
+
+                    return *this;
+                }
+
+                /**
+                 * @brief Move assignment operator.
+                 *
+                 * @param other SmallVector to be moved.
+                 * @return Reference to this.
+                 */
+                SmallVector& operator=(SmallVector&& other)
+                {
+                    if (this != &other)
+                    {
+                        this->__release();
+                        this->__take(other);
+                    }
+
+                    return *this;
+                }
+
+                /**
+                 * @brief Replaces the contents with a copy of a range.
+                 *
+                 * @param first Iterator to the first element.
+                 * @param last Iterator past the last element.
+                 */
+                template<typename InputIt>
+                void assign(InputIt first, InputIt last)
+                {
+                    this->__size = 0;
+
+                    for (; first != last; ++first)
+                        this->push_back(*first);
+                }
+
+                /// Element access.
+                reference operator[](size_type i) { return this->__ptr[i]; }
+                const_reference operator[](size_type i) const
+                {
+                    return this->__ptr[i];
+                }
+
+                reference front() { return this->__ptr[0]; }
+                const_reference front() const { return this->__ptr[0]; }
+                reference back() { return this->__ptr[this->__size - 1]; }
+                const_reference back() const
+                {
+                    return this->__ptr[this->__size - 1];
+                }
+
+                pointer data() { return this->__ptr; }
+                const_pointer data() const { return this->__ptr; }
+
+                /// Iterators.
+                iterator begin() { return this->__ptr; }
+                iterator end() { return this->__ptr + this->__size; }
+                const_iterator begin() const { return this->__ptr; }
+                const_iterator end() const
+                {
+                    return this->__ptr + this->__size;
+                }
+                const_iterator cbegin() const { return this->begin(); }
+                const_iterator cend() const { return this->end(); }
+
+                reverse_iterator rbegin()
+                {
+                    return reverse_iterator(this->end());
+                }
+                reverse_iterator rend()
+                {
+                    return reverse_iterator(this->begin());
+                }
+                const_reverse_iterator rbegin() const
+                {
+                    return const_reverse_iterator(this->end());
+                }
+                const_reverse_iterator rend() const
+                {
+                    return const_reverse_iterator(this->begin());
+                }
+
+                /// Capacity.
+                bool empty() const { return this->__size == 0; }
+                size_type size() const { return this->__size; }
+                size_type capacity() const { return this->__capacity; }
+
+                /**
+                 * @brief Checks if the elements are held in the inline
+                 * buffer.
+                 *
+                 * @return Value indicating if no heap storage is used.
+                 */
+                bool is_inline() const
+                {
+                    return this->__ptr == this->__buffer;
+                }
+
+                /**
+                 * @brief Ensures capacity for at least new_cap elements.
+                 *
+                 * @param new_cap Required capacity.
+                 */
+                void reserve(size_type new_cap)
+                {
+                    if (new_cap <= this->__capacity)
+                        return;
+
+                    T* heap = new T[new_cap];
+                    std::move(this->__ptr, this->__ptr + this->__size, heap);
+
+                    if (!this->is_inline())
+                        delete[] this->__ptr;
+
+                    this->__ptr = heap;
+                    this->__capacity = new_cap;
+                }
+
+                /**
+                 * @brief Resizes the container. New elements are set to the
+                 * value passed.
+                 *
+                 * @param count New size.
+                 * @param value Value of any appended element. Defaults to T().
+                 */
+                void resize(size_type count, const T& value = T())
+                {
+                    this->reserve(count);
+
+                    for (size_type i = this->__size; i < count; ++i)
+                        this->__ptr[i] = value;
+
+                    this->__size = count;
+                }
+
+                /// @brief Removes all elements. Capacity is kept.
+                void clear()
+                {
+                    this->__size = 0;
+                }
+
+                /**
+                 * @brief Appends an element.
+                 *
+                 * @param value Element to be appended.
+                 */
+                void push_back(const T& value)
+                {
+                    if (this->__size == this->__capacity)
+                        this->reserve(2 * this->__capacity);
+
+                    this->__ptr[this->__size++] = value;
+                }
+
+                /**
+                 * @brief Appends an element constructed from the arguments.
+                 *
+                 * @param args Arguments forwarded to the T constructor.
+                 */
+                template<typename... Args>
+                void emplace_back(Args&&... args)
+                {
+                    this->push_back(T(std::forward<Args>(args)...));
+                }
+
+                /// @brief Removes the last element.
+                void pop_back()
+                {
+                    --(this->__size);
+                }
+
+                /**
+                 * @brief Inserts an element before pos.
+                 *
+                 * @param pos Iterator to the insert position.
+                 * @param value Element to be inserted.
+                 * @return Iterator to the inserted element.
+                 */
+                iterator insert(const_iterator pos, const T& value)
+                {
+                    size_type index = pos - this->begin();
+                    this->push_back(value);
+                    std::rotate(
+                        this->begin() + index,
+                        this->end() - 1,
+                        this->end());
+
+                    return this->begin() + index;
+                }
+
+                /**
+                 * @brief Removes the element at pos.
+                 *
+                 * @param pos Iterator to the element to be removed.
+                 * @return Iterator following the removed element.
+                 */
+                iterator erase(const_iterator pos)
+                {
+                    size_type index = pos - this->begin();
+                    std::move(
+                        this->begin() + index + 1,
+                        this->end(),
+                        this->begin() + index);
+                    --(this->__size);
+
+                    return this->begin() + index;
+                }
+
+                /**
+                 * @brief Equality operator.
+                 *
+                 * @param other SmallVector being compared.
+                 * @return Value indicating if both hold the same elements.
+                 */
+                bool operator==(const SmallVector& other) const
+                {
+                    return this->__size == other.__size &&
+                        std::equal(this->begin(), this->end(), other.begin());
+                }
+
+                /**
+                 * @brief Inequality operator.
+                 *
+                 * @param other SmallVector being compared.
+                 * @return Value indicating if the elements differ.
+                 */
+                bool operator!=(const SmallVector& other) const
+                {
+                    return !((*this) == other);
+                }
+
+            private:
+
+                /// @brief Inline storage.
+                T __buffer[N];
+
+                /// @brief Pointer to the active storage (inline or heap).
+                T* __ptr;
+
+                /// @brief Number of elements.
+                size_type __size;
+
+                /// @brief Number of elements the active storage can hold.
+                size_type __capacity;
+
+                /// @brief Frees heap storage if any and resets to inline.
+                void __release()
+                {
+                    if (!this->is_inline())
+                        delete[] this->__ptr;
+
+                    this->__ptr = this->__buffer;
+                    this->__size = 0;
+                    this->__capacity = N;
+                }
+
+                /**
+                 * @brief Takes over the contents of other and leaves it
+                 * empty.
+                 *
+                 * @param other SmallVector to be moved from.
+                 */
+                void __take(SmallVector& other)
+                {
+                    if (other.is_inline())
+                    {
+                        this->assign(other.begin(), other.end());
+                        other.__size = 0;
+
+                        return;
+                    }
+
+                    this->__ptr = other.__ptr;
+                    this->__size = other.__size;
+                    this->__capacity = other.__capacity;
+
+                    other.__ptr = other.__buffer;
+                    other.__size = 0;
+                    other.__capacity = N;
+                }
+        };
+    }
+}
@@ -0,0 +1,725 @@
+#pragma once
+
+#define STATIC_ND_ARRAY NumC::Core::StaticNdArray
+
+#include <NumC/Core/NdArray.hpp>
+
+#include <type_traits>
+
+/**
+ * @brief Static arrays with at most these many elements have their element
+ * loops fully unrolled at compile time. Bigger ones fall back to plain loops
+ * to keep code size in check.
+ */
+#ifndef NUMC_STATIC_UNROLL_LIMIT
+#define NUMC_STATIC_UNROLL_LIMIT 64
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /**
+         * @brief Compile-time description of a fixed array shape.
+         *
+         * @tparam Dims Dimensions of the array.
+         */
+        template<size_t... Dims>
+        struct StaticShape;
+
+        /// @brief Shape recursion terminator - a 0-D shape has 1 element.
+        template<>
+        struct StaticShape<>
+        {
+            static constexpr size_t ndims = 0;
+            static constexpr size_t nunits = 1;
+
+            static constexpr size_t dim(size_t) { return 1; }
+            static constexpr size_t stride(size_t) { return 1; }
+            static constexpr size_t offset() { return 0; }
+        };
+
+        template<size_t D, size_t... Rest>
+        struct StaticShape<D, Rest...>
+        {
+            static_assert(D > 0, "Static array dimensions must be positive.");
+
+            /// @brief Number of dimensions.
+            static constexpr size_t ndims = 1 + sizeof...(Rest);
+
+            /// @brief Total number of elements.
+            static constexpr size_t nunits = D * StaticShape<Rest...>::nunits;
+
+            /**
+             * @brief Gets the dimension along an axis.
+             *
+             * @param axis Axis to be queried.
+             * @return Dimension along the axis.
+             */
+            static constexpr size_t dim(size_t axis)
+            {
+                return axis == 0 ? D : StaticShape<Rest...>::dim(axis - 1);
+            }
+
+            /**
+             * @brief Gets the row-major stride along an axis.
+             *
+             * @param axis Axis to be queried.
+             * @return Stride along the axis.
+             */
+            static constexpr size_t stride(size_t axis)
+            {
+                return axis == 0 ?
+                    StaticShape<Rest...>::nunits :
+                    StaticShape<Rest...>::stride(axis - 1);
+            }
+
+            /**
+             * @brief Calculates the flat index of an element from its
+             * coordinates.
+             *
+             * @return Flat index.
+             */
+            template<typename... Indices>
+            static constexpr size_t offset(size_t index, Indices... rest)
+            {
+                return index * StaticShape<Rest...>::nunits +
+                    StaticShape<Rest...>::offset(rest...);
+            }
+        };
+
+        namespace Detail
+        {
+            /**
+             * @brief Compile-time loop over [Begin, End). The range is split
+             * in halves so that the template recursion depth stays
+             * logarithmic.
+             */
+            template<size_t Begin, size_t End, bool Single = (End - Begin == 1)>
+            struct Unroll
+            {
+                template<typename Func>
+                static inline void apply(Func& func)
+                {
+                    Unroll<Begin, Begin + (End - Begin) / 2>::apply(func);
+                    Unroll<Begin + (End - Begin) / 2, End>::apply(func);
+                }
+            };
+
+            template<size_t Begin, size_t End>
+            struct Unroll<Begin, End, true>
+            {
+                template<typename Func>
+                static inline void apply(Func& func)
+                {
+                    func(Begin);
+                }
+            };
+
+            /// @brief Unrolled loop for small element counts.
+            template<size_t N, typename Func>
+            inline void static_for(Func& func, std::true_type)
+            {
+                Unroll<0, N>::apply(func);
+            }
+
+            /// @brief Plain loop for element counts above the unroll limit.
+            template<size_t N, typename Func>
+            inline void static_for(Func& func, std::false_type)
+            {
+                for (size_t i = 0; i < N; ++i)
+                    func(i);
+            }
+
+            /**
+             * @brief Calls func(i) for every i in [0, N), unrolled when N is
+             * within NUMC_STATIC_UNROLL_LIMIT.
+             */
+            template<size_t N, typename Func>
+            inline void static_for(Func& func)
+            {
+                static_for<N>(
+                    func,
+                    std::integral_constant<
+                        bool, (N <= NUMC_STATIC_UNROLL_LIMIT)>());
+            }
+        }
+
+        /**
+         * @brief N-D array with a compile-time shape.
+         *
+         * Shape and strides are constant expressions and the elements are
+         * stored inline, so creating one never touches the heap. Element-wise
+         * operations are unrolled for small shapes (see
+         * NUMC_STATIC_UNROLL_LIMIT).
+         *
+         * @note Can be built from, and converted to, a dynamic NdArray or any
+         * view of matching shape.
+         *
+         * @tparam T The data type to be stored.
+         * @tparam Dims Array dimensions.
+         */
+        template<typename T, size_t... Dims>
+        class StaticNdArray
+        {
+            public:
+                /// Aliases
+                using dtype = T;
+                using dtype_ptr = dtype*;
+                using dtype_ref = dtype&;
+                using const_dtype_ref = const dtype&;
+                using static_shape = StaticShape<Dims...>;
+
+                static_assert(
+                    sizeof...(Dims) > 0,
+                    "Static array needs at least one dimension.");
+
+                /**
+                 * @brief Default Static Nd Array constructor. Elements are
+                 * left uninitialized, as with NdArray(shape).
+                 */
+                StaticNdArray() = default;
+
+                /**
+                 * @brief Construct a new Static Nd Array object with all
+                 * elements set to the same value.
+                 *
+                 * @param value Fill value.
+                 */
+                explicit StaticNdArray(const_dtype_ref value)
+                {
+                    auto op = [&](size_t i) { this->__data[i] = value; };
+                    Detail::static_for<static_shape::nunits>(op);
+                }
+
+                /**
+                 * @brief Construct a new Static Nd Array object from a flat
+                 * list of elements in row-major order.
+                 *
+                 * @param list Elements list. Missing trailing elements are
+                 * zero-initialized.
+                 */
+                StaticNdArray(std::initializer_list<dtype> list)
+                {
+                    NUMC_CHECK(
+                        list.size() <= static_shape::nunits,
+                        ErrorCode::InvalidShape,
+                        "static - 1: too many elements for the shape.");
+
+                    auto it = list.begin();
+
+                    for (size_t i = 0; i < static_shape::nunits; ++i)
+                        this->__data[i] = it != list.end() ? *(it++) : dtype();
+                }
+
+                /**
+                 * @brief Construct a new Static Nd Array object by copying
+                 * the elements of a dynamic array or view.
+                 *
+                 * @param array Reference to the array/view. Must have the
+                 * same shape.
+                 */
+                explicit StaticNdArray(const NdArray<dtype>& array)
+                {
+                    NUMC_CHECK(
+                        same_shape(array.shape()),
+                        ErrorCode::InvalidShape,
+                        "static - 2: array shape differs from the static "
+                        "shape.");
+
+                    auto it = array.cbegin(), ite = array.cend();
+
+                    for (size_t i = 0; it != ite; ++it, ++i)
+                        this->__data[i] = *it;
+                }
+
+                /// @brief Default copy constructor.
+                StaticNdArray(const StaticNdArray& other) = default;
+
+                /// @brief Destroy the Static Nd Array object.
+                ~StaticNdArray() = default;
+
+                /// @brief Default assignment operator.
+                StaticNdArray& operator=(const StaticNdArray& other) = default;
+
+                /**
+                 * @brief Gets the number of dimensions.
+                 *
+                 * @return Number of dimensions.
+                 */
+                static constexpr size_t ndims()
+                {
+                    return static_shape::ndims;
+                }
+
+                /**
+                 * @brief Gets the total number of elements.
+                 *
+                 * @return Number of elements.
+                 */
+                static constexpr size_t size()
+                {
+                    return static_shape::nunits;
+                }
+
+                /**
+                 * @brief Gets the dimension along an axis.
+                 *
+                 * @param axis Axis to be queried.
+                 * @return Dimension along the axis.
+                 */
+                static constexpr size_t dim(size_t axis)
+                {
+                    return static_shape::dim(axis);
+                }
+
+                /**
+                 * @brief Gets the stride along an axis.
+                 *
+                 * @param axis Axis to be queried.
+                 * @return Stride along the axis.
+                 */
+                static constexpr size_t stride(size_t axis)
+                {
+                    return static_shape::stride(axis);
+                }
+
+                /**
+                 * @brief Gets the dimensions/shape of the array as a runtime
+                 * list.
+                 *
+                 * @return List of shape/dimensions.
+                 */
+                static shape_t shape()
+                {
+                    return shape_t({Dims...});
+                }
+
+                /**
+                 * @brief Gets the strides along each dimension as a runtime
+                 * list.
+                 *
+                 * @return List of strides along each dimensions.
+                 */
+                static stride_t strides()
+                {
+                    stride_t strides;
+
+                    for (size_t i = 0; i < static_shape::ndims; ++i)
+                        strides.push_back(static_shape::stride(i));
+
+                    return strides;
+                }
+
+                /**
+                 * @brief Element access by coordinates. The flat offset is
+                 * computed from the constant strides.
+                 *
+                 * @param indices One index per dimension.
+                 * @return Reference to the element.
+                 */
+                template<typename... Indices>
+                dtype_ref operator()(Indices... indices)
+                {
+                    static_assert(
+                        sizeof...(Indices) == sizeof...(Dims),
+                        "Expected one index per dimension.");
+
+                    return this->__data[static_shape::offset(indices...)];
+                }
+
+                /**
+                 * @brief Constant element access by coordinates.
+                 *
+                 * @param indices One index per dimension.
+                 * @return Constant reference to the element.
+                 */
+                template<typename... Indices>
+                const_dtype_ref operator()(Indices... indices) const
+                {
+                    static_assert(
+                        sizeof...(Indices) == sizeof...(Dims),
+                        "Expected one index per dimension.");
+
+                    return this->__data[static_shape::offset(indices...)];
+                }
+
+                /**
+                 * @brief Gets the array element.
+                 *
+                 * @warning Index passed is used on a flattened array.
+                 *
+                 * @param index Index of element to be read.
+                 * @return Value at the index.
+                 */
+                dtype get(size_t index) const
+                {
+                    NUMC_ASSERT(
+                        index >= 0 && index < static_shape::nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "static - 3: get index out of bounds.");
+
+                    return this->__data[index];
+                }
+
+                /**
+                 * @brief Updates the array element value.
+                 *
+                 * @warning Index passed is used on a flattened array.
+                 *
+                 * @param index Index of element to be updated.
+                 * @param value Value to be set.
+                 */
+                void set(size_t index, dtype value)
+                {
+                    NUMC_ASSERT(
+                        index >= 0 && index < static_shape::nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "static - 4: set index out of bounds.");
+
+                    this->__data[index] = value;
+                }
+
+                /**
+                 * @brief Gets the pointer to the data array.
+                 *
+                 * @return Pointer to the data array.
+                 */
+                dtype_ptr data()
+                {
+                    return this->__data;
+                }
+
+                /**
+                 * @brief Gets the read-only pointer to the data array.
+                 *
+                 * @return Read-only pointer to the data array.
+                 */
+                const dtype* data() const
+                {
+                    return this->__data;
+                }
+
+                /**
+                 * @brief Iterator pointing to the first element.
+                 *
+                 * @note Storage is always contiguous, so plain pointers are
+                 * used as iterators.
+                 *
+                 * @return Pointer to the first element.
+                 */
+                dtype_ptr begin()
+                {
+                    return this->__data;
+                }
+
+                /**
+                 * @brief Iterator pointing to last element + 1.
+                 *
+                 * @return Pointer past the last element.
+                 */
+                dtype_ptr end()
+                {
+                    return this->__data + static_shape::nunits;
+                }
+
+                /**
+                 * @brief Constant iterator pointing to the first element.
+                 *
+                 * @return Read-only pointer to the first element.
+                 */
+                const dtype* cbegin() const
+                {
+                    return this->__data;
+                }
+
+                /**
+                 * @brief Constant iterator pointing to last element + 1.
+                 *
+                 * @return Read-only pointer past the last element.
+                 */
+                const dtype* cend() const
+                {
+                    return this->__data + static_shape::nunits;
+                }
+
+                /**
+                 * @brief Copies the elements into a new dynamic array.
+                 *
+                 * @return New array of the same shape.
+                 */
+                NdArray<dtype> to_ndarray() const
+                {
+                    auto result = NdArray<dtype>(shape());
+                    auto it = result.begin();
+
+                    for (size_t i = 0; i < static_shape::nunits; ++i, ++it)
+                        *it = this->__data[i];
+
+                    return result;
+                }
+
+                /**
+                 * @brief Element-wise addition operator overload.
+                 *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Rhs array reference.
+                 * @return New array containing the result.
+                 */
+                template<typename rhs_t>
+                StaticNdArray<promote_t<dtype, rhs_t>, Dims...>
+                operator+(const StaticNdArray<rhs_t, Dims...>& rhs) const
+                {
+                    using res_t = promote_t<dtype, rhs_t>;
+
+                    return this->__array_op(
+                        rhs, [] (res_t x, res_t y) -> res_t { return x + y; });
+                }
+
+                /**
+                 * @brief Element-wise subtraction operator overload.
+                 *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Rhs array reference.
+                 * @return New array containing the result.
+                 */
+                template<typename rhs_t>
+                StaticNdArray<promote_t<dtype, rhs_t>, Dims...>
+                operator-(const StaticNdArray<rhs_t, Dims...>& rhs) const
+                {
+                    using res_t = promote_t<dtype, rhs_t>;
+
+                    return this->__array_op(
+                        rhs, [] (res_t x, res_t y) -> res_t { return x - y; });
+                }
+
+                /**
+                 * @brief Element-wise multiplication operator overload.
+                 *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Rhs array reference.
+                 * @return New array containing the result.
+                 */
+                template<typename rhs_t>
+                StaticNdArray<promote_t<dtype, rhs_t>, Dims...>
+                operator*(const StaticNdArray<rhs_t, Dims...>& rhs) const
+                {
+                    using res_t = promote_t<dtype, rhs_t>;
+
+                    return this->__array_op(
+                        rhs, [] (res_t x, res_t y) -> res_t { return x * y; });
+                }
+
+                /**
+                 * @brief Element-wise division operator overload.
+                 *
+                 * @note A 0 element divisor results in +- inf.
+                 *
+                 * @note Mixed element types give promote_t<dtype, rhs_t>.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Rhs array reference.
+                 * @return New array containing the result.
+                 */
+                template<typename rhs_t>
+                StaticNdArray<promote_t<dtype, rhs_t>, Dims...>
+                operator/(const StaticNdArray<rhs_t, Dims...>& rhs) const
+                {
+                    using res_t = promote_t<dtype, rhs_t>;
+
+                    return this->__array_op(
+                        rhs, [] (res_t x, res_t y) -> res_t { return x / y; });
+                }
+
+                /**
+                 * @brief Element-wise addition scalar operator overload.
+                 *
+                 * @note Scalar value passed is typecast to a Float64.
+                 *
+                 * @param rhs Rhs scalar value.
+                 * @return New array containing the result.
+                 */
+                StaticNdArray operator+(const float64& rhs) const
+                {
+                    return this->__scalar_op(
+                        rhs,
+                        [] (dtype x, float64 y) -> dtype { return x + y; });
+                }
+
+                /**
+                 * @brief Element-wise subtraction scalar operator overload.
+                 *
+                 * @note Scalar value passed is typecast to a Float64.
+                 *
+                 * @param rhs Rhs scalar value.
+                 * @return New array containing the result.
+                 */
+                StaticNdArray operator-(const float64& rhs) const
+                {
+                    return this->__scalar_op(
+                        rhs,
+                        [] (dtype x, float64 y) -> dtype { return x - y; });
+                }
+
+                /**
+                 * @brief Element-wise multiplication scalar operator overload.
+                 *
+                 * @note Scalar value passed is typecast to a Float64.
+                 *
+                 * @param rhs Rhs scalar value.
+                 * @return New array containing the result.
+                 */
+                StaticNdArray operator*(const float64& rhs) const
+                {
+                    return this->__scalar_op(
+                        rhs,
+                        [] (dtype x, float64 y) -> dtype { return x * y; });
+                }
+
+                /**
+                 * @brief Element-wise division scalar operator overload.
+                 *
+                 * @note Scalar value passed is typecast to a Float64.
+                 *
+                 * @warning A 0 element divisor results in +- inf.
+                 *
+                 * @param rhs Rhs scalar value.
+                 * @return New array containing the result.
+                 */
+                StaticNdArray operator/(const float64& rhs) const
+                {
+                    return this->__scalar_op(
+                        rhs,
+                        [] (dtype x, float64 y) -> dtype { return x / y; });
+                }
+
+            private:
+
+                /// @brief Inline storage of the elements.
+                dtype __data[static_shape::nunits];
+
+                /**
+                 * @brief Internal helper applying an element operation
+                 * between this and another array of the same shape.
+                 *
+                 * @param rhs Rhs array reference.
+                 * @param element_op Operation to be performed per element.
+                 * @return New array containing the result.
+                 */
+                template<typename rhs_t, typename Func>
+                StaticNdArray<promote_t<dtype, rhs_t>, Dims...> __array_op(
+                    const StaticNdArray<rhs_t, Dims...>& rhs,
+                    Func element_op) const
+                {
+                    using res_t = promote_t<dtype, rhs_t>;
+
+                    StaticNdArray<res_t, Dims...> result;
+                    res_t* res_data = result.data();
+                    const rhs_t* rhs_data = rhs.data();
+
+                    auto op =
+                        [&](size_t i)
+                        {
+                            res_data[i] = element_op(
+                                Detail::Convert<dtype, res_t>::apply(
+                                    this->__data[i]),
+                                Detail::Convert<rhs_t, res_t>::apply(
+                                    rhs_data[i]));
+                        };
+                    Detail::static_for<static_shape::nunits>(op);
+
+                    return result;
+                }
+
+                /**
+                 * @brief Internal helper applying an element operation
+                 * between this and a scalar.
+                 *
+                 * @param rhs Scalar value.
+                 * @param element_op Operation to be performed per element.
+                 * @return New array containing the result.
+                 */
+                template<typename Func>
+                StaticNdArray
+                __scalar_op(const float64 rhs, Func element_op) const
+                {
+                    StaticNdArray result;
+
+                    auto op =
+                        [&](size_t i)
+                        {
+                            result.__data[i] = element_op(this->__data[i], rhs);
+                        };
+                    Detail::static_for<static_shape::nunits>(op);
+
+                    return result;
+                }
+
+                /**
+                 * @brief Checks if a runtime shape matches the static one.
+                 *
+                 * @param shape Reference to the shape to be compared.
+                 * @return Value indicating if both shapes are same.
+                 */
+                static bool same_shape(const shape_t& shape)
+                {
+                    if (shape.size() != static_shape::ndims)
+                        return false;
+
+                    for (size_t i = 0; i < static_shape::ndims; ++i)
+                    {
+                        if (shape[i] != static_shape::dim(i))
+                            return false;
+                    }
+
+                    return true;
+                }
+        };
+
+        /**
+         * @brief Matrix product of two static 2-D arrays. The loops are fully
+         * unrolled for small matrices, which makes 3x3/4x4 transforms free of
+         * any bookkeeping.
+         *
+         * @tparam T Array element data type.
+         * @tparam M Rows of the LHS matrix.
+         * @tparam N Columns of LHS and rows of RHS matrix.
+         * @tparam K Columns of the RHS matrix.
+         * @param lhs Reference to the LHS matrix.
+         * @param rhs Reference to the RHS matrix.
+         * @return New (M, K) matrix.
+         */
+        template<typename T, size_t M, size_t N, size_t K>
+        StaticNdArray<T, M, K> matmul(
+            const StaticNdArray<T, M, N>& lhs,
+            const StaticNdArray<T, N, K>& rhs)
+        {
+            StaticNdArray<T, M, K> result;
+            const T* a = lhs.data();
+            const T* b = rhs.data();
+            T* c = result.data();
+
+            auto op =
+                [&](size_t index)
+                {
+                    size_t i = index / K, j = index % K;
+                    T sum = T();
+
+                    auto dot =
+                        [&](size_t k) { sum += a[i * N + k] * b[k * K + j]; };
+                    Detail::static_for<N>(dot);
+
+                    c[index] = sum;
+                };
+            Detail::static_for<M * K>(op);
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,425 @@
+#pragma once
+
+#define TRACER NumC::Core::Tracer
+
+#include <NumC/Core/Type.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef NUMC_ENABLE_TRACING
+/**
+ * @brief Opens a trace scope that records the wall time of the enclosing
+ * block under the given name and category. Expands to nothing unless
+ * NUMC_ENABLE_TRACING is defined.
+ *
+ * @param name Operation name (string literal).
+ * @param category Operation category (string literal).
+ */
+#define NUMC_TRACE_SCOPE(name, category) \
+    NumC::Core::TraceScope __numc_trace_scope((name), (category))
+
+/**
+ * @brief Attaches the work done to the current trace scope. The arguments are
+ * only evaluated when tracing is compiled in and enabled at runtime.
+ *
+ * @param elements Number of elements processed.
+ * @param bytes Number of bytes read + written.
+ * @param args Readable description (shapes, dtypes).
+ */
+#define NUMC_TRACE_INFO(elements, bytes, args) \
+    do \
+    { \
+        if (__numc_trace_scope.active()) \
+            __numc_trace_scope.set_info((elements), (bytes), (args)); \
+    } \
+    while (0)
+#else
+// The arguments are still consumed so that names passed in do not become
+// unused parameters.
+#define NUMC_TRACE_SCOPE(name, category) ((void)(name), (void)(category))
+#define NUMC_TRACE_INFO(elements, bytes, args) ((void)0)
+#endif
+
+namespace NumC
+{
+    namespace Core
+    {
+        /// @brief Aggregated counters of one traced operation.
+        struct TraceCounter
+        {
+            /// @brief Number of recorded calls.
+            size_t calls = 0;
+
+            /// @brief Total elements processed.
+            size_t elements = 0;
+
+            /// @brief Total bytes read + written.
+            size_t bytes = 0;
+
+            /// @brief Total wall time in nanoseconds.
+            int64 total_ns = 0;
+
+            /// @brief Slowest call in nanoseconds.
+            int64 max_ns = 0;
+        };
+
+        /// @brief A single recorded operation.
+        struct TraceEvent
+        {
+            const char* name;
+            const char* category;
+            std::string args;
+            size_t elements;
+            size_t bytes;
+            int64 start_ns;
+            int64 duration_ns;
+            int tid;
+        };
+
+        /**
+         * @brief Process wide collector of trace events and per-operation
+         * counters.
+         *
+         * @note Events are only produced when the library is built with
+         * NUMC_ENABLE_TRACING (CMake option NUMC_TRACING). Otherwise the
+         * tracer stays empty and the instrumentation compiles to nothing.
+         */
+        class Tracer
+        {
+            public:
+
+                /**
+                 * @brief Gets the process wide tracer.
+                 *
+                 * @return Reference to the tracer.
+                 */
+                static Tracer& instance()
+                {
+                    static Tracer tracer;
+
+                    return tracer;
+                }
+
+                /**
+                 * @brief Checks if tracing is compiled in.
+                 *
+                 * @return Value indicating if NUMC_ENABLE_TRACING is set.
+                 */
+                static constexpr bool compiled_in()
+                {
+#ifdef NUMC_ENABLE_TRACING
+                    return true;
+#else
+                    return false;
+#endif
+                }
+
+                /**
+                 * @brief Pauses or resumes recording at runtime.
+                 *
+                 * @param enabled Value indicating if events are recorded.
+                 */
+                void set_enabled(bool enabled)
+                {
+                    this->__enabled.store(enabled, std::memory_order_relaxed);
+                }
+
+                /**
+                 * @brief Checks if events are being recorded.
+                 *
+                 * @return Value indicating if recording is on.
+                 */
+                bool enabled() const
+                {
+                    return compiled_in() &&
+                        this->__enabled.load(std::memory_order_relaxed);
+                }
+
+                /**
+                 * @brief Sets the maximum number of events kept for the
+                 * Chrome trace. Counters keep aggregating past this limit.
+                 *
+                 * @param max_events Maximum number of stored events.
+                 */
+                void set_max_events(size_t max_events)
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+                    this->__max_events = max_events;
+                }
+
+                /**
+                 * @brief Gets the current time on the tracer clock.
+                 *
+                 * @return Nanoseconds since the tracer was created.
+                 */
+                int64 now_ns() const
+                {
+                    using namespace std::chrono;
+
+                    return duration_cast<nanoseconds>(
+                        steady_clock::now() - this->__epoch).count();
+                }
+
+                /**
+                 * @brief Records a finished operation.
+                 *
+                 * @param event Event to be recorded. The tid is filled in.
+                 */
+                void record(TraceEvent& event)
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    auto tid = this->__tids.find(std::this_thread::get_id());
+                    if (tid == this->__tids.end())
+                    {
+                        tid = this->__tids.insert(
+                            std::make_pair(
+                                std::this_thread::get_id(),
+                                (int)this->__tids.size() + 1)).first;
+                    }
+
+                    event.tid = tid->second;
+
+                    TraceCounter& counter = this->__counters[event.name];
+                    counter.calls += 1;
+                    counter.elements += event.elements;
+                    counter.bytes += event.bytes;
+                    counter.total_ns += event.duration_ns;
+                    counter.max_ns =
+                        std::max(counter.max_ns, event.duration_ns);
+
+                    if ((size_t)this->__events.size() < this->__max_events)
+                        this->__events.push_back(event);
+                }
+
+                /**
+                 * @brief Gets a snapshot of the per-operation counters.
+                 *
+                 * @return Counters keyed by operation name.
+                 */
+                std::map<std::string, TraceCounter> counters() const
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    return this->__counters;
+                }
+
+                /**
+                 * @brief Gets a snapshot of the recorded events.
+                 *
+                 * @return List of events in recording order.
+                 */
+                std::vector<TraceEvent> events() const
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    return this->__events;
+                }
+
+                /// @brief Drops all recorded events and counters.
+                void reset()
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    this->__events.clear();
+                    this->__counters.clear();
+                }
+
+                /**
+                 * @brief Writes the recorded events in the Chrome
+                 * trace_event JSON format (chrome://tracing, Perfetto).
+                 *
+                 * @param out Output stream.
+                 */
+                void dump_chrome_trace(std::ostream& out) const
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    out << "{\"traceEvents\":[";
+
+                    for (size_t i = 0; i < (size_t)this->__events.size(); ++i)
+                    {
+                        const TraceEvent& e = this->__events[i];
+
+                        out << (i ? ",\n" : "\n")
+                            << "{\"name\":\"" << e.name
+                            << "\",\"cat\":\"" << e.category
+                            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+                            << ",\"ts\":" << e.start_ns / 1000.0
+                            << ",\"dur\":" << e.duration_ns / 1000.0
+                            << ",\"args\":{\"desc\":\"";
+                        escape(out, e.args);
+                        out << "\",\"elements\":" << e.elements
+                            << ",\"bytes\":" << e.bytes << "}}";
+                    }
+
+                    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+                }
+
+                /**
+                 * @brief Writes the Chrome trace to a file.
+                 *
+                 * @param path Output file path.
+                 * @return Value indicating if the file could be written.
+                 */
+                bool dump_chrome_trace(const std::string& path) const
+                {
+                    std::ofstream out(path);
+
+                    if (!out)
+                        return false;
+
+                    this->dump_chrome_trace(out);
+
+                    return (bool)out;
+                }
+
+            private:
+
+                Tracer() :
+                    __enabled(true),
+                    __max_events(1 << 20),
+                    __epoch(std::chrono::steady_clock::now())
+                {}
+
+                /// @brief Runtime recording switch, read by every thread.
+                std::atomic<bool> __enabled;
+
+                /// @brief Maximum number of stored events.
+                size_t __max_events;
+
+                /// @brief Start of the tracer clock.
+                std::chrono::steady_clock::time_point __epoch;
+
+                /// @brief Guards all the containers below.
+                mutable std::mutex __mutex;
+
+                /// @brief Recorded events.
+                std::vector<TraceEvent> __events;
+
+                /// @brief Per-operation counters.
+                std::map<std::string, TraceCounter> __counters;
+
+                /// @brief Small sequential ids for the recording threads.
+                std::map<std::thread::id, int> __tids;
+
+                /// @brief Writes a JSON escaped string.
+                static void escape(std::ostream& out, const std::string& s)
+                {
+                    for (char c : s)
+                    {
+                        if (c == '"' || c == '\\')
+                            out << '\\';
+
+                        out << c;
+                    }
+                }
+        };
+
+        /**
+         * @brief RAII helper timing the enclosing scope. Use through the
+         * NUMC_TRACE_SCOPE and NUMC_TRACE_INFO macros.
+         */
+        class TraceScope
+        {
+            public:
+
+                /**
+                 * @brief Construct a new Trace Scope object and starts the
+                 * timer.
+                 *
+                 * @param name Operation name. Must outlive the tracer (a
+                 * string literal).
+                 * @param category Operation category. Must outlive the
+                 * tracer.
+                 */
+                TraceScope(const char* name, const char* category) :
+                    __active(Tracer::instance().enabled())
+                {
+                    if (!this->__active)
+                        return;
+
+                    this->__event.name = name;
+                    this->__event.category = category;
+                    this->__event.elements = 0;
+                    this->__event.bytes = 0;
+                    this->__event.start_ns = Tracer::instance().now_ns();
+                }
+
+                TraceScope(const TraceScope&) = delete;
+                TraceScope& operator=(const TraceScope&) = delete;
+
+                /// @brief Stops the timer and records the event.
+                ~TraceScope()
+                {
+                    if (!this->__active)
+                        return;
+
+                    auto& tracer = Tracer::instance();
+                    this->__event.duration_ns =
+                        tracer.now_ns() - this->__event.start_ns;
+                    tracer.record(this->__event);
+                }
+
+                /**
+                 * @brief Checks if the scope is being recorded.
+                 *
+                 * @return Value indicating if tracing was enabled on entry.
+                 */
+                bool active() const
+                {
+                    return this->__active;
+                }
+
+                /**
+                 * @brief Attaches the work done to the event.
+                 *
+                 * @param elements Number of elements processed.
+                 * @param bytes Number of bytes read + written.
+                 * @param args Readable description (shapes, dtypes).
+                 */
+                void set_info(size_t elements, size_t bytes, std::string args)
+                {
+                    this->__event.elements = elements;
+                    this->__event.bytes = bytes;
+                    this->__event.args = std::move(args);
+                }
+
+            private:
+
+                /// @brief Value indicating if the event is recorded.
+                bool __active;
+
+                /// @brief Event being built.
+                TraceEvent __event;
+        };
+
+        /**
+         * @brief Describes an array for trace events, e.g. "float32(3, 3)".
+         *
+         * @tparam ArrayType Array/view type.
+         * @param array Reference to the array.
+         * @return Description string.
+         */
+        template<typename ArrayType>
+        std::string trace_describe(const ArrayType& array)
+        {
+            std::string desc =
+                dtype_name<typename ArrayType::dtype>() + std::string("(");
+            const auto& shape = array.shape();
+
+            for (size_t i = 0; i < (size_t)shape.size(); ++i)
+                desc += (i ? ", " : "") + std::to_string(shape[i]);
+
+            return desc + ")";
+        }
+    }
+}
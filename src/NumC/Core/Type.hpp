@@ -2,6 +2,10 @@
 
 #define TYPENAME(TYPE) #TYPE;
 
+#include <NumC/Core/SmallVector.hpp>
+
+#include <complex>
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <string>
@@ -9,6 +13,12 @@
 
 namespace NumC
 {
+    namespace Core
+    {
+        class Float16;
+        class BFloat16;
+    }
+
     /// Familiar names for fundamental data types.
     using float32 = float;
     using float64 = double;
@@ -21,12 +31,61 @@ namespace NumC
     using uint32 = std::uint32_t;
     using uint64 = std::uint64_t;
 
+    /// 16-bit floating point storage types, computing in float32. Defined in
+    /// Core/Half.hpp.
+    using float16 = Core::Float16;
+    using bfloat16 = Core::BFloat16;
+
+    /// Complex types, stored as interleaved (real, imag) pairs.
+    using complex64 = std::complex<float32>;
+    using complex128 = std::complex<float64>;
+
     /// Aliases for types common across lib.
-    using size_t = int;
-    using size_t_v = std::vector<size_t>;
+    /// Indices, strides and element counts are 64-bit unless NUMC_INDEX_32 is
+    /// defined, which keeps the narrower index math for builds that only deal
+    /// with arrays below 2^31 elements.
+    /// Shape, stride and slice lists hold up to NUMC_SMALL_VECTOR_SIZE
+    /// dimensions inline so that creating arrays/views does not allocate.
+#ifdef NUMC_INDEX_32
+    using size_t = std::int32_t;
+#else
+    using size_t = std::int64_t;
+#endif
+    using size_t_v = Core::SmallVector<size_t>;
     using shape_t = size_t_v;
     using stride_t = size_t_v;
     using indices_t = std::pair<size_t, size_t>;
-    using indices_t_v = std::vector<indices_t>;
+    using indices_t_v = Core::SmallVector<indices_t>;
     using slices_t = indices_t_v;
+
+    /**
+     * @brief Gets the familiar name of a data type, e.g. "float32". Used by
+     * tracing and memory accounting.
+     *
+     * @tparam T Data type.
+     * @return Data type name.
+     */
+    template<typename T>
+    inline const char* dtype_name() { return "unknown"; }
+
+    template<> inline const char* dtype_name<float32>() { return "float32"; }
+    template<> inline const char* dtype_name<float64>() { return "float64"; }
+    template<> inline const char* dtype_name<int8>() { return "int8"; }
+    template<> inline const char* dtype_name<int16>() { return "int16"; }
+    template<> inline const char* dtype_name<int32>() { return "int32"; }
+    template<> inline const char* dtype_name<int64>() { return "int64"; }
+    template<> inline const char* dtype_name<uint8>() { return "uint8"; }
+    template<> inline const char* dtype_name<uint16>() { return "uint16"; }
+    template<> inline const char* dtype_name<uint32>() { return "uint32"; }
+    template<> inline const char* dtype_name<uint64>() { return "uint64"; }
+    template<> inline const char* dtype_name<float16>() { return "float16"; }
+    template<> inline const char* dtype_name<bfloat16>() { return "bfloat16"; }
+    template<> inline const char* dtype_name<complex64>()
+    {
+        return "complex64";
+    }
+    template<> inline const char* dtype_name<complex128>()
+    {
+        return "complex128";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#pragma once
+
+#define COMPONENT_VIEW NumC::Core::ComponentView
+
+#include <NumC/Core/View/View.hpp>
+
+#include <complex>
+
+namespace NumC
+{
+    namespace Core
+    {
+        /**
+         * @brief Real or imaginary part of a complex array, viewed in place.
+         *
+         * Complex elements are stored as interleaved (real, imag) pairs, so
+         * either part is a stride 2 walk over the base buffer reinterpreted
+         * as T. Writes go straight to the complex array.
+         *
+         * @warning The viewed array (and the view it was taken from, if any)
+         * must outlive this view.
+         *
+         * @tparam T Component type, float32 or float64.
+         */
+        template<typename T>
+        class ComponentView : public View<T>
+        {
+            public:
+                /// Aliases
+                using dtype = T;
+                using dtype_ptr = dtype*;
+                using dtype_ref = dtype&;
+                using complex_t = std::complex<T>;
+
+                /**
+                 * @brief Construct a new Component View object.
+                 *
+                 * @param array Pointer to the complex array or view.
+                 * @param component 0 for the real part, 1 for the imaginary
+                 * part.
+                 */
+                ComponentView(NdArray<complex_t>* array, size_t component)
+                {
+                    NUMC_TRACE_SCOPE("ComponentView", "view");
+
+                    NUMC_CHECK(
+                        component == 0 || component == 1,
+                        ErrorCode::InvalidArgument,
+                        "component - 1: component must be 0 (real) or 1 "
+                        "(imag).");
+
+                    this->_arr = nullptr;
+                    this->__base = array;
+                    this->__indexer = nullptr;
+                    this->__component = component;
+
+                    auto view = dynamic_cast<View<complex_t>*>(array);
+
+                    // Complex element k spans 2k and 2k + 1 in units of T.
+                    for (auto stride: array->memory_strides())
+                        this->__mem_strides.push_back(2 * stride);
+
+                    this->__mem_offset =
+                        2 * array->memory_offset() + component;
+
+                    if (view != nullptr)
+                    {
+                        this->__base = view->get_arr();
+                        this->__indexer = view->cmemory_indexer();
+                    }
+
+                    this->_nunits = array->size();
+                    this->_dims = array->shape();
+
+                    size_t prev_dims = 1;
+
+                    for (auto element: this->_dims)
+                    {
+                        prev_dims *= element;
+
+                        this->_strides.push_back(this->_nunits / prev_dims);
+                        this->_indices.push_back(indices_t(0, element));
+                    }
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits, 0, trace_describe(*array));
+                }
+
+                /// @brief Default Component View destructor.
+                ~ComponentView() = default;
+
+                /**
+                 * @copydoc MemoryIndexer::operator()()
+                 *
+                 * Overridden function.
+                 *
+                 * @note Indexes the base buffer read as T, where complex
+                 * element k spans 2k and 2k + 1.
+                 */
+                size_t operator()(const size_t index) const override
+                {
+                    size_t pos = this->__indexer != nullptr ?
+                        (*this->__indexer)(index) : index;
+
+                    return 2 * pos + this->__component;
+                }
+
+                /**
+                 * @copydoc NdArray::buffer_id()
+                 *
+                 * Overridden function.
+                 */
+                const void* buffer_id() const override
+                {
+                    return this->__base->buffer_id();
+                }
+
+                /**
+                 * @copydoc NdArray::get()
+                 *
+                 * Overridden function.
+                 */
+                dtype get(size_t index) const override
+                {
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "view - 1: get index out of bounds.");
+
+                    return this->__cdata()[(*this)(index)];
+                }
+
+                /**
+                 * @copydoc NdArray::set()
+                 *
+                 * Overridden function.
+                 */
+                void set(size_t index, dtype value) override
+                {
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "view - 2: set index out of bounds.");
+
+                    this->__mdata()[(*this)(index)] = value;
+                }
+
+                /**
+                 * @copydoc NdArray::begin()
+                 *
+                 * Overridden function.
+                 */
+                Iterator<dtype> begin() override
+                {
+                    return Iterator<dtype>(
+                        this->__mdata(), 0, this->_nunits, this);
+                }
+
+                /**
+                 * @copydoc NdArray::end()
+                 *
+                 * Overridden function.
+                 */
+                Iterator<dtype> end() override
+                {
+                    return Iterator<dtype>(this->__mdata(), this->_nunits);
+                }
+
+                /**
+                 * @copydoc NdArray::cbegin()
+                 *
+                 * Overridden function.
+                 */
+                CIterator<dtype> cbegin() const override
+                {
+                    return CIterator<dtype>(
+                        this->__cdata(), 0, this->_nunits, this);
+                }
+
+                /**
+                 * @copydoc NdArray::cend()
+                 *
+                 * Overridden function.
+                 */
+                CIterator<dtype> cend() const override
+                {
+                    return CIterator<dtype>(this->__cdata(), this->_nunits);
+                }
+
+                /**
+                 * @copydoc NdArray::memory_strides()
+                 *
+                 * Overridden function.
+                 */
+                stride_t memory_strides() const override
+                {
+                    return this->__mem_strides;
+                }
+
+                /**
+                 * @copydoc NdArray::memory_offset()
+                 *
+                 * Overridden function.
+                 */
+                size_t memory_offset() const override
+                {
+                    return this->__mem_offset;
+                }
+
+                /**
+                 * @copydoc NdArray::memory_data()
+                 *
+                 * Overridden function.
+                 */
+                const dtype* memory_data() const override
+                {
+                    return this->__cdata();
+                }
+
+                /**
+                 * @copydoc NdArray::mutable_memory_data()
+                 *
+                 * Overridden function.
+                 */
+                dtype* mutable_memory_data() override
+                {
+                    return this->__mdata();
+                }
+
+                /**
+                 * @copydoc View::copy()
+                 *
+                 * Overridden function.
+                 */
+                NdArray<dtype> copy() const override
+                {
+                    NUMC_TRACE_SCOPE("copy", "view");
+
+                    NdArray<dtype> result(this->shape());
+                    dtype* out = result.data();
+                    const dtype* in = this->__cdata();
+                    const ComponentView<dtype>* self = this;
+                    const size_t grain =
+                        std::max<size_t>(1, COPY_GRAIN_BYTES / sizeof(dtype));
+
+                    Utils::parallel_for(
+                        0,
+                        this->_nunits,
+                        grain,
+                        [=](size_t lo, size_t hi)
+                        {
+                            for (size_t i = lo; i < hi; ++i)
+                                out[i] = in[(*self)(i)];
+                        });
+
+                    return result;
+                }
+
+            private:
+
+                /// @brief Complex array owning the buffer.
+                NdArray<complex_t>* __base;
+
+                /// @brief Indexer of the complex view, or null for arrays.
+                const MemoryIndexer* __indexer;
+
+                /// @brief 0 for the real part, 1 for the imaginary part.
+                size_t __component;
+
+                /// @brief Buffer strides, in units of T.
+                stride_t __mem_strides;
+
+                /// @brief Buffer offset of element 0, in units of T.
+                size_t __mem_offset;
+
+                /**
+                 * @brief Gets the base buffer as T for writing. A shared
+                 * copy-on-write buffer is copied first.
+                 *
+                 * @return Pointer to the base data array.
+                 */
+                dtype* __mdata()
+                {
+                    return reinterpret_cast<dtype*>(this->__base->data());
+                }
+
+                /**
+                 * @brief Gets the base buffer as T for reading.
+                 *
+                 * @return Pointer to the base data array.
+                 */
+                dtype* __cdata() const
+                {
+                    const NdArray<complex_t>* base = this->__base;
+
+                    return const_cast<dtype*>(
+                        reinterpret_cast<const dtype*>(base->data()));
+                }
+        };
+    }
+}
@@ -4,6 +4,8 @@
 
 #include <NumC/Core/View/View.hpp>
 
+#include <memory>
+
 namespace NumC
 {
     namespace Core
@@ -14,6 +16,13 @@ namespace NumC
          * A reshape can potentially change the number of dimensions and the
          * dimensions themselves. This would lead to change in the strides
          * as well. However, it cannot change the total number of units.
+         *
+         * Any array or view can be reshaped. When the new shape can be
+         * expressed with the source's buffer strides, as for contiguous runs
+         * of a sliced or transposed view, the view reads the source buffer
+         * in place. Otherwise the source is copied once into a contiguous
+         * buffer that the view owns, and writes through the view no longer
+         * reach the source. is_copy() tells which happened.
          */
         template<typename T>
         class ReshapedView : public View<T>
@@ -32,10 +41,8 @@ namespace NumC
                  * number of elements/units can't differ from that of the
                  * array being reshaped.
                  *
-                 * @warning Reshaping of other type of Views @b not
-                 * @b supported.
-                 * Reshaping is only allowed upon memory containers or other
-                 * Reshaped Views.
+                 * @warning A view that needs a copy (see is_copy()) is a
+                 * snapshot of the source.
                  *
                  * @param array Pointer to the array object.
                  * @param newShape The new shape/dims to reshape the array to.
@@ -45,51 +52,40 @@ namespace NumC
                  */
                 ReshapedView(NdArray<dtype>* array, const shape_t& newShape)
                 {
-                    // Reshaping only works directly on memory containers or on
-                    // other reshaped views.
-                    // Reshape of other views not supported at the moment.
-                    if (dynamic_cast<View<dtype>*>(array) != nullptr &&
-                        dynamic_cast<ReshapedView<dtype>*>(array) == nullptr)
-                    {
-                        std::cout << "ERROR - reshape - 1" << std::endl;
-                        // throw error.
-                    }
+                    NUMC_TRACE_SCOPE("ReshapedView", "view");
 
-                    if (newShape.empty())
-                    {
-                        std::cout << "ERROR - reshape - 2" << std::endl;
-                        // throw error
-                    }
+                    NUMC_CHECK(
+                        !newShape.empty(),
+                        ErrorCode::InvalidReshape,
+                        "reshape - 2: new shape cannot be empty.");
 
-                    auto arr_shape = array->shape();
+                    const auto& arr_shape = array->shape();
                     size_t arr_nunits =
                         std::accumulate(
                             arr_shape.begin(),
                             arr_shape.end(),
-                            1,
+                            size_t(1),
                             std::multiplies<size_t>());
 
                     size_t n_pos_units = 1;
                     size_t negative_index = -1;
 
-                    for (size_t i = 0; i < newShape.size(); ++i)
+                    for (size_t i = 0; i < size_t(newShape.size()); ++i)
                     {
-                        if (newShape[i] == 0)
-                        {
-                            std::cout << "ERROR - reshape - 3" << std::endl;
-                            // throw error.
-                        }
-                        else if (newShape[i] < 0)
+                        NUMC_CHECK(
+                            newShape[i] != 0,
+                            ErrorCode::InvalidReshape,
+                            "reshape - 3: dimensions cannot be 0.");
+
+                        if (newShape[i] < 0)
                         {
-                            if (negative_index == -1)
-                            {
-                                negative_index = i;
-                            }
-                            else
-                            {
-                                std::cout << "ERROR - reshape - 5" << std::endl;
-                                // throw error.
-                            }
+                            NUMC_CHECK(
+                                negative_index == -1,
+                                ErrorCode::InvalidReshape,
+                                "reshape - 5: only one dimension can be "
+                                "inferred.");
+
+                            negative_index = i;
                         }
                         else
                         {
@@ -97,13 +93,13 @@ namespace NumC
                         }
                     }
 
-                    if (negative_index == -1 && arr_nunits != n_pos_units)
-                    {
-                        std::cout << "ERROR - reshape - 4" << std::endl;
-                        // throw error.
-                    }
+                    NUMC_CHECK(
+                        negative_index == -1 ?
+                            arr_nunits == n_pos_units :
+                            arr_nunits % n_pos_units == 0,
+                        ErrorCode::InvalidReshape,
+                        "reshape - 4: element count differs from the array.");
 
-                    size_t other_dims = 1;
                     this->_nunits = n_pos_units;
 
                     // Copying shape as is.
@@ -130,11 +126,52 @@ namespace NumC
                     }
 
                     this->_arr = array;
-                    if (dynamic_cast<View<dtype>*>(array) != nullptr)
+                    auto view = dynamic_cast<View<dtype>*>(array);
+
+                    if (view != nullptr)
+                    {
+                        auto reshaped =
+                            dynamic_cast<ReshapedView<dtype>*>(array);
+
+                        // A copy made by the source view stays alive.
+                        if (reshaped != nullptr)
+                            this->__buffer = reshaped->__buffer;
+
+                        this->_arr = view->get_arr();
+                    }
+
+                    // Views not backed by an array of this type, such as
+                    // component views, are always copied.
+                    const bool strided =
+                        this->_arr != nullptr &&
+                        this->__map_strides(
+                            array->shape(), array->memory_strides());
+
+                    if (strided)
+                    {
+                        this->__offset = array->memory_offset();
+                    }
+                    else
                     {
-                        this->_arr =
-                            dynamic_cast<View<dtype>*>(array)->get_arr();
+                        this->__buffer =
+                            std::make_shared<NdArray<dtype>>(array->copy());
+                        this->_arr = this->__buffer.get();
+                        this->__mem_strides = this->_strides;
+                        this->__offset = 0;
                     }
+
+                    this->__copied = !strided;
+                    this->__contiguous = true;
+
+                    for (size_t i = 0; i < size_t(this->_dims.size()); ++i)
+                        if (this->_dims[i] != 1 &&
+                            this->__mem_strides[i] != this->_strides[i])
+                            this->__contiguous = false;
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits,
+                        this->__copied ? this->_nunits * sizeof(dtype) : 0,
+                        trace_describe(*array));
                 }
 
                 /// @brief Default Reshaped View destructor.
@@ -145,17 +182,159 @@ namespace NumC
                  *
                  * Overridden function.
                  *
-                 * @note Since slicing or other views are not allowed
-                 * for reshape, the number of units are same for the
-                 * reshaped view and the container.
-                 * Therefor the index can be directly interpreted as the
-                 * memory container index.
-                 * Calculations will need to be done if we are to
-                 * support reshape of other views.
+                 * @note When the view walks its buffer contiguously, as for
+                 * a reshaped array or a copy, the index is just shifted by
+                 * the buffer offset. Otherwise the coordinates of the index
+                 * are multiplied by the buffer strides.
                  */
                 size_t operator()(const size_t index) const override
                 {
-                    return index;
+                    if (this->__contiguous)
+                        return this->__offset + index;
+
+                    size_t pos = this->__offset, c_index = index;
+
+                    for (size_t i = 0; i < size_t(this->_dims.size()); ++i)
+                    {
+                        pos +=
+                            c_index / this->_strides[i] *
+                            this->__mem_strides[i];
+                        c_index %= this->_strides[i];
+                    }
+
+                    return pos;
+                }
+
+                /**
+                 * @copydoc NdArray::memory_strides()
+                 *
+                 * Overridden function.
+                 */
+                stride_t memory_strides() const override
+                {
+                    return this->__mem_strides;
+                }
+
+                /**
+                 * @copydoc NdArray::memory_offset()
+                 *
+                 * Overridden function.
+                 */
+                size_t memory_offset() const override
+                {
+                    return this->__offset;
+                }
+
+                /**
+                 * @brief Tells if the source had to be copied because the
+                 * new shape cannot be laid over its buffer strides.
+                 *
+                 * @return True if the view reads its own copy, false if it
+                 * reads the source buffer in place.
+                 */
+                bool is_copy() const
+                {
+                    return this->__copied;
+                }
+
+            private:
+
+                /// @brief Buffer strides along each dimension.
+                stride_t __mem_strides;
+
+                /// @brief Buffer position of element 0.
+                size_t __offset = 0;
+
+                /// @brief Whether the view reads a copy of the source.
+                bool __copied = false;
+
+                /// @brief Whether element i is at buffer position offset + i.
+                bool __contiguous = true;
+
+                /// @brief Contiguous copy of the source, when one was needed.
+                /// Shared by the views reshaped from this one.
+                std::shared_ptr<NdArray<dtype>> __buffer;
+
+                /**
+                 * @brief Lays the view's shape over the source's buffer
+                 * strides, filling __mem_strides. Groups of source axes are
+                 * matched with groups of new axes of the same size; each
+                 * group of source axes must be contiguous with respect to
+                 * itself, then the new axes split it in row-major order.
+                 *
+                 * @htmlonly
+                 * Example, the (4, 6) slice of columns 0 to 6 of an (4, 8)
+                 * array has buffer strides (8, 1).
+                 * <br>Reshaped to (2, 2, 3, 2) - strides (16, 8, 2, 1).
+                 * <br>Reshaped to (24) - impossible, rows are 8 apart
+                 * but hold 6 elements.
+                 * @endhtmlonly
+                 *
+                 * @param shape Source shape.
+                 * @param strides Source buffer strides.
+                 * @return True if the strides were found.
+                 */
+                bool __map_strides(
+                    const shape_t& shape, const stride_t& strides)
+                {
+                    shape_t old_dims;
+                    stride_t old_strides;
+                    const auto& dims = this->_dims;
+                    const size_t nd = dims.size();
+
+                    // Size 1 axes can take any stride.
+                    for (size_t i = 0; i < size_t(shape.size()); ++i)
+                        if (shape[i] != 1)
+                        {
+                            old_dims.push_back(shape[i]);
+                            old_strides.push_back(strides[i]);
+                        }
+
+                    this->__mem_strides = stride_t(nd, 1);
+
+                    if (this->_nunits == 0)
+                    {
+                        this->__mem_strides = this->_strides;
+
+                        return true;
+                    }
+
+                    const size_t old_nd = old_dims.size();
+                    size_t ni = 0, nj = 1, oi = 0, oj = 1;
+
+                    while (ni < nd && oi < old_nd)
+                    {
+                        size_t n_prod = dims[ni], o_prod = old_dims[oi];
+
+                        while (n_prod != o_prod)
+                        {
+                            if (n_prod < o_prod)
+                                n_prod *= dims[nj++];
+                            else
+                                o_prod *= old_dims[oj++];
+                        }
+
+                        for (size_t k = oi; k + 1 < oj; ++k)
+                            if (old_strides[k] !=
+                                old_dims[k + 1] * old_strides[k + 1])
+                                return false;
+
+                        this->__mem_strides[nj - 1] = old_strides[oj - 1];
+
+                        for (size_t k = nj - 1; k > ni; --k)
+                            this->__mem_strides[k - 1] =
+                                this->__mem_strides[k] * dims[k];
+
+                        ni = nj++;
+                        oi = oj++;
+                    }
+
+                    // Trailing size 1 axes.
+                    for (size_t k = ni; k < nd; ++k)
+                        this->__mem_strides[k] =
+                            ni > 0 ? this->__mem_strides[ni - 1] : 1;
+
+                    return true;
                 }
         };
     }
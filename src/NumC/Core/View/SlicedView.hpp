@@ -49,41 +49,43 @@ namespace NumC
                  */
                 SlicedView(NdArray<dtype>* array, const slices_t& slices)
                 {
+                    NUMC_TRACE_SCOPE("SlicedView", "view");
+
                     // Slicing only works directly on memory containers or on
                     // other sliced views.
                     // Slicing of other view types not supported at the moment.
-                    if (dynamic_cast<View<dtype>*>(array) != nullptr &&
-                        dynamic_cast<SlicedView<dtype>*>(array) == nullptr)
-                    {
-                        std::cout << "ERROR - sliced - 4" << std::endl;
-                        // throw error.
-                    }
-
-                    if (slices.empty() || slices.size() > array->shape().size())
-                    {
-                        std::cout << "ERROR - sliced - 1" << std::endl;
-                        // throw error.
-                    }
+                    NUMC_CHECK(
+                        dynamic_cast<View<dtype>*>(array) == nullptr ||
+                        dynamic_cast<SlicedView<dtype>*>(array) != nullptr,
+                        ErrorCode::Unsupported,
+                        "sliced - 4: only arrays and sliced views can be "
+                        "sliced.");
+
+                    NUMC_CHECK(
+                        !slices.empty() &&
+                        slices.size() <= array->shape().size(),
+                        ErrorCode::InvalidSlice,
+                        "sliced - 1: expected 1 to ndims slices.");
 
                     auto it = slices.begin(), ite = slices.end();
-                    auto arr_shape = array->shape();
+                    const auto& arr_shape = array->shape();
 
                     for (size_t i = 0; it != ite; ++i, ++it)
                     {
                         // Verifies that each start index is between 0 and
                         // corresponding dims/shape count. Also, verifies that
                         // end index is greater than start index or -1.
-                        if ((*it).first < 0 || (*it).first >= arr_shape[i] ||
-                            ((*it).second != -1 && (*it).second < (*it).first) ||
-                            (*it).second > arr_shape[i])
-                        {
-                            std::cout << "ERROR - sliced - 2" << std::endl;
-                            // throw error
-                        }
+                        NUMC_CHECK(
+                            (*it).first >= 0 && (*it).first < arr_shape[i] &&
+                            ((*it).second == -1 ||
+                                (*it).second >= (*it).first) &&
+                            (*it).second <= arr_shape[i],
+                            ErrorCode::InvalidSlice,
+                            "sliced - 2: slice indices out of bounds.");
                     }
 
                     size_t arr_ndims = arr_shape.size(), nslices = slices.size();
-                    auto indices = array->indices();
+                    const auto& indices = array->indices();
 
                     for (size_t i = 0; i < arr_ndims; ++i)
                     {
@@ -120,7 +122,7 @@ namespace NumC
                         std::accumulate(
                             this->_dims.begin(),
                             this->_dims.end(),
-                            1,
+                            size_t(1),
                             std::multiplies<size_t>());
                     // Populating strides based on the new dimensions.
                     for (size_t i = 0, prev_dims = 1; i < arr_ndims; ++i)
@@ -135,6 +137,9 @@ namespace NumC
                         this->_arr =
                             dynamic_cast<View<dtype>*>(array)->get_arr();
                     }
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits, 0, trace_describe(*array));
                 }
 
                 /**
@@ -164,6 +169,32 @@ namespace NumC
 
                     return pos;
                 }
+
+                /**
+                 * @copydoc NdArray::memory_strides()
+                 *
+                 * Overridden function.
+                 */
+                stride_t memory_strides() const override
+                {
+                    return this->_arr->strides();
+                }
+
+                /**
+                 * @copydoc NdArray::memory_offset()
+                 *
+                 * Overridden function.
+                 */
+                size_t memory_offset() const override
+                {
+                    size_t pos = 0;
+
+                    for (size_t i = 0; i < size_t(this->_dims.size()); ++i)
+                        pos += this->_indices[i].first *
+                            this->_arr->strides()[i];
+
+                    return pos;
+                }
         };
     }
 }
\ No newline at end of file
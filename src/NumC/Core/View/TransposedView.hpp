@@ -40,17 +40,19 @@ namespace NumC
                     NdArray<dtype>* array,
                     const size_t_v& axes = size_t_v())
                 {
+                    NUMC_TRACE_SCOPE("TransposedView", "view");
+
                     // Transposing only works directly on memory containers or
                     // on other transposed views.
                     // Transpose of other views not supported at the moment.
-                    if (dynamic_cast<View<dtype>*>(array) != nullptr &&
-                        dynamic_cast<TransposedView<dtype>*>(array) == nullptr)
-                    {
-                        std::cout << "ERROR - transpose - 1" << std::endl;
-                        // throw error.
-                    }
+                    NUMC_CHECK(
+                        dynamic_cast<View<dtype>*>(array) == nullptr ||
+                        dynamic_cast<TransposedView<dtype>*>(array) != nullptr,
+                        ErrorCode::Unsupported,
+                        "transpose - 1: only arrays and transposed views can "
+                        "be transposed.");
 
-                    auto arr_shape = array->shape();
+                    const auto& arr_shape = array->shape();
 
                     // Copying axes.
                     for (auto axis: axes)
@@ -66,33 +68,32 @@ namespace NumC
                             this->__axes.rend(),
                             0);
                     }
-                    else if (this->__axes.size() != arr_shape.size())
-                    {
-                        std::cout << "ERROR - transpose - 2" << std::endl;
-                        // throw error.
-                    }
                     else
                     {
+                        NUMC_CHECK(
+                            this->__axes.size() == arr_shape.size(),
+                            ErrorCode::InvalidAxes,
+                            "transpose - 2: expected one axis per dimension.");
+
                         size_t_v orig_axes(this->__axes.size());
                         std::iota(orig_axes.begin(), orig_axes.end(), 0);
 
-                        if (!std::is_permutation(
-                            this->__axes.begin(),
-                            this->__axes.end(),
-                            orig_axes.begin()))
-                        {
-                            std::cout << "ERROR - transpose - 3" << std::endl;
-                            // throw error.
-                        }
+                        NUMC_CHECK(
+                            std::is_permutation(
+                                this->__axes.begin(),
+                                this->__axes.end(),
+                                orig_axes.begin()),
+                            ErrorCode::InvalidAxes,
+                            "transpose - 3: axes must be a permutation.");
                     }
 
-                    auto arr_indices = array->indices();
+                    const auto& arr_indices = array->indices();
                     size_t prev_dims = 1;
                     this->_nunits =
                         std::accumulate(
                             arr_shape.begin(),
                             arr_shape.end(),
-                            1,
+                            size_t(1),
                             std::multiplies<size_t>());
 
                     // Copying shape and indices in the new order.
@@ -108,9 +109,19 @@ namespace NumC
                     this->_arr = array;
                     if (dynamic_cast<View<dtype>*>(array) != nullptr)
                     {
-                        this->_arr =
-                            dynamic_cast<View<dtype>*>(array)->get_arr();
+                        auto view =
+                            dynamic_cast<TransposedView<dtype>*>(array);
+
+                        // Axes are relative to the transposed view: map them
+                        // onto the base array's axes.
+                        for (auto& axis: this->__axes)
+                            axis = view->__axes[axis];
+
+                        this->_arr = view->get_arr();
                     }
+
+                    NUMC_TRACE_INFO(
+                        this->_nunits, 0, trace_describe(*array));
                 }
 
                 /**
@@ -170,6 +181,37 @@ namespace NumC
                     return pos;
                 }
 
+                /**
+                 * @copydoc NdArray::memory_strides()
+                 *
+                 * Overridden function.
+                 */
+                stride_t memory_strides() const override
+                {
+                    stride_t strides;
+
+                    for (auto axis: this->__axes)
+                        strides.push_back(this->_arr->strides()[axis]);
+
+                    return strides;
+                }
+
+                /**
+                 * @copydoc NdArray::memory_offset()
+                 *
+                 * Overridden function.
+                 */
+                size_t memory_offset() const override
+                {
+                    size_t pos = 0;
+
+                    for (size_t i = 0; i < size_t(this->_dims.size()); ++i)
+                        pos += this->_indices[i].first *
+                            this->_arr->strides()[this->__axes[i]];
+
+                    return pos;
+                }
+
             private:
 
                 /// @brief The axes order that the array is being transposed to.
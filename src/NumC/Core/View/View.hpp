@@ -64,6 +64,16 @@ namespace NumC
                     return this->_arr;
                 }
 
+                /**
+                 * @copydoc NdArray::buffer_id()
+                 *
+                 * Overridden function.
+                 */
+                const void* buffer_id() const override
+                {
+                    return this->_arr->buffer_id();
+                }
+
                 /**
                  * @copydoc NdArray::shape()
                  *
@@ -101,11 +111,10 @@ namespace NumC
                  */
                 dtype get(size_t index) const override
                 {
-                    if (index < 0 && index >= this->_nunits)
-                    {
-                        std::cout << "ERROR - view - 1" << std::endl;
-                        // throw error
-                    }
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "view - 1: get index out of bounds.");
 
                     return this->_arr->get(
                         this->cmemory_indexer()->operator()(index));
@@ -118,11 +127,10 @@ namespace NumC
                  */
                 void set(size_t index, dtype value) override
                 {
-                    if (index < 0 && index >= this->_nunits)
-                    {
-                        std::cout << "ERROR - view - 2" << std::endl;
-                        // throw error
-                    }
+                    NUMC_ASSERT(
+                        index >= 0 && index < this->_nunits,
+                        ErrorCode::IndexOutOfBounds,
+                        "view - 2: set index out of bounds.");
 
                     this->_arr->set(
                         this->memory_indexer()->operator()(index), value);
@@ -162,7 +170,7 @@ namespace NumC
                 CIterator<dtype> cbegin() const override
                 {
                     return CIterator<dtype>(
-                        this->_arr->data(),
+                        this->__cdata(),
                         0,
                         this->_nunits,
                         this->cmemory_indexer());
@@ -176,14 +184,79 @@ namespace NumC
                 CIterator<dtype> cend() const override
                 {
                     return CIterator<dtype>(
-                        this->_arr->data(),
+                        this->__cdata(),
                         this->_nunits);
                 }
 
+                /**
+                 * @copydoc NdArray::memory_data()
+                 *
+                 * Overridden function.
+                 */
+                const dtype* memory_data() const override
+                {
+                    return this->__cdata();
+                }
+
+                /**
+                 * @copydoc NdArray::mutable_memory_data()
+                 *
+                 * Overridden function.
+                 */
+                dtype* mutable_memory_data() override
+                {
+                    return this->_arr->data();
+                }
+
+                /**
+                 * @brief Deep copies the viewed elements into a new
+                 * contiguous array of the view's shape, in parallel chunks.
+                 *
+                 * @return New array owning its data.
+                 */
+                NdArray<dtype> copy() const override
+                {
+                    NUMC_TRACE_SCOPE("copy", "view");
+
+                    NdArray<dtype> result(this->shape());
+                    dtype* out = result.data();
+                    const dtype* in = this->__cdata();
+                    const MemoryIndexer* indexer = this->cmemory_indexer();
+                    const size_t grain =
+                        std::max<size_t>(1, COPY_GRAIN_BYTES / sizeof(dtype));
+
+                    Utils::parallel_for(
+                        0,
+                        this->_nunits,
+                        grain,
+                        [=](size_t lo, size_t hi)
+                        {
+                            for (size_t i = lo; i < hi; ++i)
+                                out[i] = in[(*indexer)(i)];
+                        });
+
+                    return result;
+                }
+
             protected:
 
                 /// @brief Pointer to the array object.
                 NdArray<dtype>* _arr;
+
+            private:
+
+                /**
+                 * @brief Gets the base array data for reading, without
+                 * splitting a copy-on-write buffer.
+                 *
+                 * @return Pointer to the base data array.
+                 */
+                dtype* __cdata() const
+                {
+                    const NdArray<dtype>* arr = this->_arr;
+
+                    return const_cast<dtype*>(arr->data());
+                }
         };
     }
 }
\ No newline at end of file
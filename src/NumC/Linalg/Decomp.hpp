@@ -0,0 +1,802 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Linalg/Gemm.hpp>
+#include <NumC/Linalg/Products.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace NumC
+{
+    namespace Linalg
+    {
+        /**
+         * @brief LU factorization with partial pivoting, P A = L U, of a
+         * stack of matrices.
+         *
+         * @tparam T Element type, float32 or float64.
+         */
+        template<typename T>
+        struct LuResult
+        {
+            /// @brief (..., n, n) L below the diagonal (unit diagonal not
+            /// stored) and U on and above it.
+            ND_ARRAY<T> lu;
+
+            /// @brief (..., n) row i was swapped with row pivots[i], in
+            /// order.
+            ND_ARRAY<size_t> pivots;
+        };
+
+        /**
+         * @brief Reduced QR factorization, A = Q R, of a stack of matrices.
+         *
+         * @tparam T Element type, float32 or float64.
+         */
+        template<typename T>
+        struct QrResult
+        {
+            /// @brief (..., m, k) orthonormal columns, k = min(m, n).
+            ND_ARRAY<T> q;
+
+            /// @brief (..., k, n) upper triangular.
+            ND_ARRAY<T> r;
+        };
+
+        namespace Detail
+        {
+            /// @brief Panel width of the blocked factorizations and solves.
+            /// Matrices up to this size are handled unblocked.
+            const size_t FACTOR_NB = 64;
+
+            /// @brief Block products of up to this many multiply-adds skip
+            /// the GEMM.
+            const size_t FACTOR_SMALL_PRODUCT = size_t(32) << 10;
+
+            /// @brief Rows per parallel task of row-wise panel updates.
+            const size_t FACTOR_ROW_GRAIN = 16;
+
+            /// @brief Compile time check of the element type.
+            template<typename T>
+            void require_float()
+            {
+                static_assert(
+                    std::is_same<T, float32>::value ||
+                    std::is_same<T, float64>::value,
+                    "Linalg factorizations take float32 or float64 arrays.");
+            }
+
+            /**
+             * @brief Checks a stack of matrices.
+             *
+             * @tparam T Element type.
+             * @param a Array of shape (..., m, n).
+             * @param square Require m == n.
+             * @return Number of matrices, the product of the leading axes.
+             */
+            template<typename T>
+            size_t matrix_batch(const ND_ARRAY<T>& a, bool square)
+            {
+                const auto& shape = a.shape();
+
+                NUMC_CHECK(
+                    shape.size() >= 2,
+                    Core::ErrorCode::InvalidShape,
+                    "linalg - 3: expects a stack of (..., m, n) matrices.");
+
+                const size_t dims = shape.size();
+
+                NUMC_CHECK(
+                    !square || shape[dims - 1] == shape[dims - 2],
+                    Core::ErrorCode::InvalidShape,
+                    "linalg - 4: expects a stack of square matrices.");
+
+                size_t batch = 1;
+
+                for (size_t d = 0; d + 2 < dims; ++d)
+                    batch *= shape[d];
+
+                return batch;
+            }
+
+            /**
+             * @brief Contiguous row-major copy of an array or view, factored
+             * in place.
+             *
+             * @tparam T Element type.
+             * @param a Array or view.
+             * @return New array.
+             */
+            template<typename T>
+            ND_ARRAY<T> dense_copy(const ND_ARRAY<T>& a)
+            {
+                return a.copy();
+            }
+
+            /**
+             * @brief c(i, j) += alpha * sum_l a(i, l) * b(l, j) over strided
+             * blocks, with a(i, l) = a[i * a_rs + l * a_cs] and
+             * b(l, j) = b[l * b_rs + j * b_cs]. C may share the buffer of
+             * A and B if the blocks do not overlap.
+             *
+             * @tparam T Element type.
+             * @param m Rows of C.
+             * @param k Inner dimension.
+             * @param n Columns of C.
+             * @param ldc Row stride of C.
+             */
+            template<typename T>
+            void block_product(
+                const T* a,
+                size_t a_rs,
+                size_t a_cs,
+                const T* b,
+                size_t b_rs,
+                size_t b_cs,
+                T* c,
+                size_t ldc,
+                size_t m,
+                size_t k,
+                size_t n,
+                T alpha)
+            {
+                if (m == 0 || k == 0 || n == 0)
+                    return;
+
+                // Not worth the packing and offset tables.
+                if (m * k * n <= FACTOR_SMALL_PRODUCT)
+                {
+                    for (size_t i = 0; i < m; ++i)
+                        for (size_t l = 0; l < k; ++l)
+                        {
+                            const T f = alpha * a[i * a_rs + l * a_cs];
+                            const T* bl = b + l * b_rs;
+                            T* ci = c + i * ldc;
+
+                            for (size_t j = 0; j < n; ++j)
+                                ci[j] += f * bl[j * b_cs];
+                        }
+
+                    return;
+                }
+
+                GemmLayout g;
+
+                g.batch_a.assign(1, 0);
+                g.batch_b.assign(1, 0);
+                g.rows = offsets({m}, {a_rs});
+                g.a_k = offsets({k}, {a_cs});
+                g.b_k = offsets({k}, {b_rs});
+                g.cols = offsets({n}, {b_cs});
+
+                gemm(a, b, c, g, alpha, ldc);
+            }
+
+            /**
+             * @brief Solves t x = b in place of b, t triangular. Blocks of
+             * FACTOR_NB rows are solved by substitution after subtracting
+             * the solved rows with one GEMM.
+             *
+             * @tparam T Element type.
+             * @param t (n, n) triangular matrix, row stride ldt.
+             * @param b (n, k) right-hand sides, row stride ldb.
+             * @param lower Lower rather than upper triangular.
+             * @param unit Assume a unit diagonal.
+             */
+            template<typename T>
+            void trsm(
+                const T* t,
+                size_t ldt,
+                T* b,
+                size_t ldb,
+                size_t n,
+                size_t k,
+                bool lower,
+                bool unit)
+            {
+                for (size_t blk = 0; blk < n; blk += FACTOR_NB)
+                {
+                    // Lower: top block first; upper: bottom block first.
+                    const size_t ib = std::min(FACTOR_NB, n - blk);
+                    const size_t i0 = lower ? blk : n - blk - ib;
+                    const size_t s0 = lower ? 0 : i0 + ib;
+
+                    block_product(
+                        t + i0 * ldt + s0, ldt, size_t(1),
+                        b + s0 * ldb, ldb, size_t(1),
+                        b + i0 * ldb, ldb,
+                        ib, blk, k, T(-1));
+
+                    for (size_t s = 0; s < ib; ++s)
+                    {
+                        const size_t i = lower ? i0 + s : i0 + ib - 1 - s;
+                        const size_t j0 = lower ? i0 : i + 1;
+                        const size_t j1 = lower ? i : i0 + ib;
+                        T* row = b + i * ldb;
+
+                        for (size_t j = j0; j < j1; ++j)
+                        {
+                            const T f = t[i * ldt + j];
+                            const T* src = b + j * ldb;
+
+                            for (size_t c = 0; c < k; ++c)
+                                row[c] -= f * src[c];
+                        }
+
+                        if (!unit)
+                        {
+                            const T d = t[i * ldt + i];
+
+                            for (size_t c = 0; c < k; ++c)
+                                row[c] /= d;
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @brief Right-looking blocked LU with partial pivoting of one
+             * row-major matrix, in place. A zero pivot leaves its column
+             * unscaled, like LAPACK getrf.
+             *
+             * @tparam T Element type.
+             * @param a (n, n) matrix.
+             * @param n Order.
+             * @param piv Output pivots, n of them.
+             */
+            template<typename T>
+            void lu_matrix(T* a, size_t n, size_t* piv)
+            {
+                for (size_t k0 = 0; k0 < n; k0 += FACTOR_NB)
+                {
+                    const size_t k1 = std::min(n, k0 + FACTOR_NB);
+
+                    // Panel: whole rows are swapped, updates stay in it.
+                    for (size_t j = k0; j < k1; ++j)
+                    {
+                        size_t p = j;
+
+                        for (size_t i = j + 1; i < n; ++i)
+                            if (std::abs(a[i * n + j]) >
+                                std::abs(a[p * n + j]))
+                                p = i;
+
+                        piv[j] = p;
+
+                        if (p != j)
+                            std::swap_ranges(
+                                a + j * n, a + (j + 1) * n, a + p * n);
+
+                        const T d = a[j * n + j];
+                        const T* urow = a + j * n;
+
+                        if (d == T(0))
+                            continue;
+
+                        for (size_t i = j + 1; i < n; ++i)
+                        {
+                            T* row = a + i * n;
+                            const T l = row[j] /= d;
+
+                            for (size_t c = j + 1; c < k1; ++c)
+                                row[c] -= l * urow[c];
+                        }
+                    }
+
+                    if (k1 == n)
+                        break;
+
+                    // U12 = L11^-1 A12, then A22 -= L21 U12.
+                    trsm(
+                        a + k0 * n + k0, n, a + k0 * n + k1, n,
+                        k1 - k0, n - k1, true, true);
+                    block_product(
+                        a + k1 * n + k0, n, size_t(1),
+                        a + k0 * n + k1, n, size_t(1),
+                        a + k1 * n + k1, n,
+                        n - k1, k1 - k0, n - k1, T(-1));
+                }
+            }
+
+            /**
+             * @brief Right-looking blocked Cholesky of one row-major
+             * matrix, in place. Reads the lower triangle and leaves L
+             * there, with zeros above.
+             *
+             * @tparam T Element type.
+             * @param a (n, n) symmetric positive definite matrix.
+             * @param n Order.
+             */
+            template<typename T>
+            void cholesky_matrix(T* a, size_t n)
+            {
+                auto dot = [](const T* x, const T* y, size_t len)
+                {
+                    T sum = T(0);
+
+                    for (size_t l = 0; l < len; ++l)
+                        sum += x[l] * y[l];
+
+                    return sum;
+                };
+
+                for (size_t k0 = 0; k0 < n; k0 += FACTOR_NB)
+                {
+                    const size_t k1 = std::min(n, k0 + FACTOR_NB);
+
+                    for (size_t j = k0; j < k1; ++j)
+                    {
+                        T* rj = a + j * n;
+                        const T d = rj[j] - dot(rj + k0, rj + k0, j - k0);
+
+                        NUMC_CHECK(
+                            d > T(0),
+                            Core::ErrorCode::SingularMatrix,
+                            "linalg - 7: matrix is not positive definite.");
+
+                        rj[j] = std::sqrt(d);
+
+                        for (size_t i = j + 1; i < k1; ++i)
+                        {
+                            T* ri = a + i * n;
+
+                            ri[j] = (ri[j] - dot(ri + k0, rj + k0, j - k0)) /
+                                rj[j];
+                        }
+                    }
+
+                    if (k1 == n)
+                        break;
+
+                    // L21 = A21 L11^-T, row by row.
+                    Utils::parallel_for(
+                        k1,
+                        n,
+                        FACTOR_ROW_GRAIN,
+                        [&](size_t lo, size_t hi)
+                        {
+                            for (size_t i = lo; i < hi; ++i)
+                            {
+                                T* ri = a + i * n;
+
+                                for (size_t j = k0; j < k1; ++j)
+                                {
+                                    const T* rj = a + j * n;
+
+                                    ri[j] = (ri[j] -
+                                        dot(ri + k0, rj + k0, j - k0)) /
+                                        rj[j];
+                                }
+                            }
+                        });
+
+                    // A22 -= L21 L21^T. The upper half is computed too and
+                    // cleared at the end.
+                    block_product(
+                        a + k1 * n + k0, n, size_t(1),
+                        a + k1 * n + k0, size_t(1), n,
+                        a + k1 * n + k1, n,
+                        n - k1, k1 - k0, n - k1, T(-1));
+                }
+
+                for (size_t i = 0; i < n; ++i)
+                    std::fill(a + i * n + i + 1, a + (i + 1) * n, T(0));
+            }
+
+            /**
+             * @brief Householder reflector H = I - tau v v^T with
+             * H x = (beta, 0, ...), as LAPACK larfg. x becomes
+             * (beta, v[1:]), v[0] = 1 being implicit.
+             *
+             * @tparam T Element type.
+             * @param x Vector, stride inc.
+             * @param len Length.
+             * @return tau, 0 when x is already (x0, 0, ...).
+             */
+            template<typename T>
+            T householder(T* x, size_t inc, size_t len)
+            {
+                T norm = T(0);
+
+                for (size_t i = 1; i < len; ++i)
+                    norm += x[i * inc] * x[i * inc];
+
+                if (norm == T(0))
+                    return T(0);
+
+                const T alpha = x[0];
+                T beta = std::sqrt(alpha * alpha + norm);
+
+                if (alpha > T(0))
+                    beta = -beta;
+
+                const T scale = T(1) / (alpha - beta);
+
+                for (size_t i = 1; i < len; ++i)
+                    x[i * inc] *= scale;
+
+                x[0] = beta;
+
+                return (beta - alpha) / beta;
+            }
+
+            /**
+             * @brief c = (I - tau v v^T) c for one reflector of a factored
+             * matrix, v = (1, x[inc], x[2 inc], ...).
+             *
+             * @tparam T Element type.
+             * @param x Reflector, stride inc, x[0] is not read.
+             * @param len Length of v and rows of c.
+             * @param tau Reflector scale.
+             * @param c (len, cols) block, row stride ldc.
+             * @param w Scratch.
+             */
+            template<typename T>
+            void apply_reflector(
+                const T* x,
+                size_t inc,
+                size_t len,
+                T tau,
+                T* c,
+                size_t ldc,
+                size_t cols,
+                std::vector<T>& w)
+            {
+                if (tau == T(0) || cols == 0)
+                    return;
+
+                // w = v^T c, c -= tau v w.
+                w.assign(c, c + cols);
+
+                for (size_t i = 1; i < len; ++i)
+                {
+                    const T vi = x[i * inc];
+                    const T* row = c + i * ldc;
+
+                    for (size_t j = 0; j < cols; ++j)
+                        w[j] += vi * row[j];
+                }
+
+                for (size_t i = 0; i < len; ++i)
+                {
+                    const T f = i == 0 ? tau : tau * x[i * inc];
+                    T* row = c + i * ldc;
+
+                    for (size_t j = 0; j < cols; ++j)
+                        row[j] -= f * w[j];
+                }
+            }
+
+            /**
+             * @brief Block reflector I - V T V^T of reflectors k0 .. k1 of a
+             * factored matrix, as LAPACK larft.
+             *
+             * @tparam T Element type.
+             * @param a Factored (m, n) matrix.
+             * @param tau Reflector scales.
+             * @param v Output (m - k0, k1 - k0) V, explicit unit diagonal.
+             * @param t Output (k1 - k0, k1 - k0) upper triangular T.
+             */
+            template<typename T>
+            void block_reflector(
+                const T* a,
+                size_t m,
+                size_t n,
+                const T* tau,
+                size_t k0,
+                size_t k1,
+                std::vector<T>& v,
+                std::vector<T>& t)
+            {
+                const size_t kb = k1 - k0;
+                const size_t rows = m - k0;
+
+                v.assign(rows * kb, T(0));
+                t.assign(kb * kb, T(0));
+
+                for (size_t r = 0; r < rows; ++r)
+                    for (size_t c = 0; c < kb && c <= r; ++c)
+                        v[r * kb + c] =
+                            c == r ? T(1) : a[(k0 + r) * n + k0 + c];
+
+                for (size_t i = 0; i < kb; ++i)
+                {
+                    // t(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^T v_i.
+                    std::vector<T> w(i, T(0));
+
+                    for (size_t r = i; r < rows; ++r)
+                        for (size_t l = 0; l < i; ++l)
+                            w[l] += v[r * kb + l] * v[r * kb + i];
+
+                    for (size_t l = 0; l < i; ++l)
+                    {
+                        T sum = T(0);
+
+                        for (size_t p = l; p < i; ++p)
+                            sum += t[l * kb + p] * w[p];
+
+                        t[l * kb + i] = -tau[k0 + i] * sum;
+                    }
+
+                    t[i * kb + i] = tau[k0 + i];
+                }
+            }
+
+            /**
+             * @brief c = (I - V op(T) V^T) c with three GEMMs, as LAPACK
+             * larfb.
+             *
+             * @tparam T Element type.
+             * @param v (rows, kb) V.
+             * @param t (kb, kb) T.
+             * @param transpose Apply T^T, i.e. the transposed reflector.
+             * @param c (rows, cols) block, row stride ldc.
+             */
+            template<typename T>
+            void apply_block_reflector(
+                const std::vector<T>& v,
+                const std::vector<T>& t,
+                size_t kb,
+                bool transpose,
+                T* c,
+                size_t ldc,
+                size_t rows,
+                size_t cols)
+            {
+                if (cols == 0)
+                    return;
+
+                std::vector<T> w(kb * cols, T(0)), tw(kb * cols, T(0));
+
+                // w = V^T c, tw = op(T) w, c -= V tw.
+                block_product(
+                    v.data(), size_t(1), kb, c, ldc, size_t(1),
+                    w.data(), cols, kb, rows, cols, T(1));
+                block_product(
+                    t.data(), transpose ? size_t(1) : kb,
+                    transpose ? kb : size_t(1),
+                    w.data(), cols, size_t(1),
+                    tw.data(), cols, kb, kb, cols, T(1));
+                block_product(
+                    v.data(), kb, size_t(1), tw.data(), cols, size_t(1),
+                    c, ldc, rows, kb, cols, T(-1));
+            }
+
+            /**
+             * @brief Blocked Householder QR of one row-major matrix, as
+             * LAPACK geqrf: each panel is factored column by column, then
+             * the rest of the matrix is updated as one block reflector.
+             *
+             * @tparam T Element type.
+             * @param a (m, n) matrix, R on and above the diagonal and the
+             * reflectors below on return.
+             * @param tau Output min(m, n) reflector scales.
+             */
+            template<typename T>
+            void qr_matrix(T* a, size_t m, size_t n, T* tau)
+            {
+                const size_t k = std::min(m, n);
+                std::vector<T> v, t, w;
+
+                for (size_t k0 = 0; k0 < k; k0 += FACTOR_NB)
+                {
+                    const size_t k1 = std::min(k, k0 + FACTOR_NB);
+
+                    for (size_t j = k0; j < k1; ++j)
+                    {
+                        T* col = a + j * n + j;
+
+                        tau[j] = householder(col, n, m - j);
+
+                        // Panel columns j + 1 .. k1 only.
+                        apply_reflector(
+                            col, n, m - j, tau[j], col + 1, n, k1 - j - 1,
+                            w);
+                    }
+
+                    if (k1 == n)
+                        continue;
+
+                    block_reflector(a, m, n, tau, k0, k1, v, t);
+                    apply_block_reflector(
+                        v, t, k1 - k0, true, a + k0 * n + k1, n,
+                        m - k0, n - k1);
+                }
+            }
+
+            /**
+             * @brief Forms the (m, k) Q of a factored matrix by applying
+             * the block reflectors to the first k columns of I, last block
+             * first, as LAPACK orgqr.
+             *
+             * @tparam T Element type.
+             * @param a Factored (m, n) matrix.
+             * @param tau Reflector scales.
+             * @param q Output (m, k) Q.
+             */
+            template<typename T>
+            void form_q(const T* a, size_t m, size_t n, const T* tau, T* q)
+            {
+                const size_t k = std::min(m, n);
+                std::vector<T> v, t;
+
+                std::fill(q, q + m * k, T(0));
+
+                for (size_t i = 0; i < k; ++i)
+                    q[i * k + i] = T(1);
+
+                if (k == 0)
+                    return;
+
+                // One panel: the reflectors one by one, as LAPACK org2r.
+                if (k <= FACTOR_NB)
+                {
+                    for (size_t j = k; j-- > 0;)
+                        apply_reflector(
+                            a + j * n + j, n, m - j, tau[j],
+                            q + j * k + j, k, k - j, v);
+
+                    return;
+                }
+
+                for (size_t k0 = (k - 1) / FACTOR_NB * FACTOR_NB;;
+                    k0 -= FACTOR_NB)
+                {
+                    const size_t k1 = std::min(k, k0 + FACTOR_NB);
+
+                    block_reflector(a, m, n, tau, k0, k1, v, t);
+                    apply_block_reflector(
+                        v, t, k1 - k0, false, q + k0 * k + k0, k,
+                        m - k0, k - k0);
+
+                    if (k0 == 0)
+                        break;
+                }
+            }
+        }
+
+        /**
+         * @brief LU factorization with partial pivoting of a matrix or a
+         * stack of them, (..., n, n). Blocked: panels of FACTOR_NB columns
+         * are factored and the trailing matrix is updated with one GEMM.
+         * Matrices of a stack are factored in parallel.
+         *
+         * @note Singular matrices are factored too, with zeros on the
+         * diagonal of U; solve() and inv() reject them.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a Array or view.
+         * @return Factors and pivots.
+         */
+        template<typename T>
+        LuResult<T> lu_factor(const ND_ARRAY<T>& a)
+        {
+            NUMC_TRACE_SCOPE("lu_factor", "linalg");
+            Detail::require_float<T>();
+
+            const size_t batch = Detail::matrix_batch(a, true);
+            const size_t n = a.shape().back();
+            shape_t piv_shape = a.shape();
+
+            piv_shape.pop_back();
+
+            LuResult<T> result{
+                Detail::dense_copy(a), ND_ARRAY<size_t>(piv_shape)};
+            T* data = result.lu.data();
+            size_t* piv = result.pivots.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    Detail::lu_matrix(data + i * n * n, n, piv + i * n);
+                });
+
+            NUMC_TRACE_INFO(
+                a.size(), 2 * a.size() * sizeof(T),
+                Core::trace_describe(result.lu));
+
+            return result;
+        }
+
+        /**
+         * @brief Cholesky factor L, A = L L^T, of a symmetric positive
+         * definite matrix or a stack of them, (..., n, n). Only the lower
+         * triangle of a is read. Blocked like lu_factor().
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a Array or view.
+         * @return New lower triangular array.
+         */
+        template<typename T>
+        ND_ARRAY<T> cholesky(const ND_ARRAY<T>& a)
+        {
+            NUMC_TRACE_SCOPE("cholesky", "linalg");
+            Detail::require_float<T>();
+
+            const size_t batch = Detail::matrix_batch(a, true);
+            const size_t n = a.shape().back();
+            ND_ARRAY<T> result = Detail::dense_copy(a);
+            T* data = result.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    Detail::cholesky_matrix(data + i * n * n, n);
+                });
+
+            NUMC_TRACE_INFO(
+                a.size(), 2 * a.size() * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Reduced Householder QR of a matrix or a stack of them,
+         * (..., m, n). Blocked: each panel's reflectors are applied to the
+         * rest of the matrix at once, as three GEMMs.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a Array or view.
+         * @return Q of shape (..., m, k) and R of shape (..., k, n),
+         * k = min(m, n).
+         */
+        template<typename T>
+        QrResult<T> qr(const ND_ARRAY<T>& a)
+        {
+            NUMC_TRACE_SCOPE("qr", "linalg");
+            Detail::require_float<T>();
+
+            const size_t batch = Detail::matrix_batch(a, false);
+            const size_t dims = a.shape().size();
+            const size_t m = a.shape()[dims - 2];
+            const size_t n = a.shape()[dims - 1];
+            const size_t k = std::min(m, n);
+            shape_t q_shape = a.shape(), r_shape = a.shape();
+
+            q_shape.back() = k;
+            r_shape[dims - 2] = k;
+
+            ND_ARRAY<T> factors = Detail::dense_copy(a);
+            QrResult<T> result{ND_ARRAY<T>(q_shape), ND_ARRAY<T>(r_shape)};
+            T* data = factors.data();
+            T* q = result.q.data();
+            T* r = result.r.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    T* f = data + i * m * n;
+                    T* ri = r + i * k * n;
+                    std::vector<T> tau(k);
+
+                    Detail::qr_matrix(f, m, n, tau.data());
+                    Detail::form_q(f, m, n, tau.data(), q + i * m * k);
+
+                    for (size_t row = 0; row < k; ++row)
+                    {
+                        std::fill(ri + row * n, ri + row * n + row, T(0));
+                        std::copy(
+                            f + row * n + row, f + (row + 1) * n,
+                            ri + row * n + row);
+                    }
+                });
+
+            NUMC_TRACE_INFO(
+                a.size(),
+                (2 * a.size() + result.q.size() + result.r.size()) *
+                    sizeof(T),
+                Core::trace_describe(result.r));
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,681 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Linalg/Gemm.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace NumC
+{
+    namespace Linalg
+    {
+        namespace Detail
+        {
+            /// @brief Up to this many operands the contraction order is
+            /// searched exhaustively; beyond it is chosen greedily.
+            const size_t EINSUM_OPTIMAL_TERMS = 4;
+
+            /// @brief Output rows per parallel task of a reduction.
+            const size_t EINSUM_REDUCE_GRAIN = 64;
+
+            /// @brief Parsed subscripts: one label string per operand.
+            struct EinsumSpec
+            {
+                std::vector<std::string> inputs;
+                std::string output;
+            };
+
+            /// @brief Pairs of term positions contracted in turn. The result
+            /// of each contraction is appended to the remaining terms.
+            using EinsumPath = std::vector<std::pair<size_t, size_t>>;
+
+            /**
+             * @brief Strided operand of an einsum, one label per axis.
+             * Intermediate results keep their array alive through owner.
+             *
+             * @tparam T Element type.
+             */
+            template<typename T>
+            struct EinsumTerm
+            {
+                const T* data;
+                std::string labels;
+                std::vector<size_t> sizes;
+                std::vector<size_t> strides;
+                std::shared_ptr<ND_ARRAY<T>> owner;
+            };
+
+            /**
+             * @brief Parses "ij,jk->ik" style subscripts. Without "->", the
+             * output is every label used once, in alphabetical order.
+             *
+             * @param subscripts Subscripts string. Spaces are ignored.
+             * @param n_operands Number of operands passed.
+             * @return Parsed subscripts.
+             */
+            inline EinsumSpec parse_einsum(
+                const std::string& subscripts,
+                size_t n_operands)
+            {
+                std::string s;
+
+                for (char ch: subscripts)
+                    if (ch != ' ')
+                        s.push_back(ch);
+
+                EinsumSpec spec;
+                const auto arrow = s.find("->");
+                const std::string lhs = s.substr(0, arrow);
+                std::map<char, size_t> counts;
+
+                spec.inputs.push_back(std::string());
+
+                for (char ch: lhs)
+                {
+                    if (ch == ',')
+                    {
+                        spec.inputs.push_back(std::string());
+
+                        continue;
+                    }
+
+                    NUMC_CHECK(
+                        std::isalpha((unsigned char)ch),
+                        Core::ErrorCode::InvalidArgument,
+                        "einsum - 1: subscripts take letters, ',' and '->' "
+                        "only.");
+
+                    spec.inputs.back().push_back(ch);
+                    ++counts[ch];
+                }
+
+                NUMC_CHECK(
+                    size_t(spec.inputs.size()) == n_operands,
+                    Core::ErrorCode::InvalidArgument,
+                    "einsum - 2: expected one subscript term per operand.");
+
+                if (arrow == std::string::npos)
+                {
+                    for (const auto& count: counts)
+                        if (count.second == 1)
+                            spec.output.push_back(count.first);
+
+                    return spec;
+                }
+
+                spec.output = s.substr(arrow + 2);
+
+                for (size_t i = 0; i < size_t(spec.output.size()); ++i)
+                {
+                    const char ch = spec.output[i];
+
+                    NUMC_CHECK(
+                        counts.count(ch) == 1 &&
+                        spec.output.find(ch, i + 1) == std::string::npos,
+                        Core::ErrorCode::InvalidArgument,
+                        "einsum - 3: output labels must be unique and used "
+                        "by an operand.");
+                }
+
+                return spec;
+            }
+
+            /**
+             * @brief Labels kept by contracting terms i and j: those still
+             * needed by the output or another term, in order of appearance.
+             *
+             * @param terms Labels of the current terms.
+             * @param i First term.
+             * @param j Second term.
+             * @param output Output labels.
+             * @return Labels of the result.
+             */
+            inline std::string kept_labels(
+                const std::vector<std::string>& terms,
+                size_t i,
+                size_t j,
+                const std::string& output)
+            {
+                std::string kept;
+
+                for (char ch: terms[i] + terms[j])
+                {
+                    bool needed = output.find(ch) != std::string::npos;
+
+                    for (size_t t = 0; t < size_t(terms.size()) && !needed; ++t)
+                        needed = t != i && t != j &&
+                            terms[t].find(ch) != std::string::npos;
+
+                    if (needed && kept.find(ch) == std::string::npos)
+                        kept.push_back(ch);
+                }
+
+                return kept;
+            }
+
+            /**
+             * @brief Multiply-adds of contracting terms i and j: the product
+             * of the sizes of all their labels.
+             */
+            inline double pair_cost(
+                const std::vector<std::string>& terms,
+                size_t i,
+                size_t j,
+                const std::map<char, size_t>& sizes)
+            {
+                std::string seen;
+                double cost = 1;
+
+                for (char ch: terms[i] + terms[j])
+                {
+                    if (seen.find(ch) != std::string::npos)
+                        continue;
+
+                    seen.push_back(ch);
+                    cost *= double(sizes.at(ch));
+                }
+
+                return cost;
+            }
+
+            /// @brief Size of the result of a contraction.
+            inline double labels_size(
+                const std::string& labels,
+                const std::map<char, size_t>& sizes)
+            {
+                double size = 1;
+
+                for (char ch: labels)
+                    size *= double(sizes.at(ch));
+
+                return size;
+            }
+
+            /// @brief Terms left after contracting i and j.
+            inline std::vector<std::string> contract_labels(
+                const std::vector<std::string>& terms,
+                size_t i,
+                size_t j,
+                const std::string& output)
+            {
+                std::vector<std::string> next;
+
+                for (size_t t = 0; t < size_t(terms.size()); ++t)
+                    if (t != i && t != j)
+                        next.push_back(terms[t]);
+
+                next.push_back(kept_labels(terms, i, j, output));
+
+                return next;
+            }
+
+            /**
+             * @brief Exhaustive search for the cheapest contraction order.
+             *
+             * @param terms Labels of the current terms.
+             * @param output Output labels.
+             * @param sizes Size of each label.
+             * @param path Order so far.
+             * @param cost Cost so far.
+             * @param best Cost of the best order found.
+             * @param best_path Best order found.
+             */
+            inline void search_path(
+                const std::vector<std::string>& terms,
+                const std::string& output,
+                const std::map<char, size_t>& sizes,
+                EinsumPath& path,
+                double cost,
+                double& best,
+                EinsumPath& best_path)
+            {
+                if (cost >= best)
+                    return;
+
+                if (terms.size() == 1)
+                {
+                    best = cost;
+                    best_path = path;
+
+                    return;
+                }
+
+                for (size_t i = 0; i < size_t(terms.size()); ++i)
+                    for (size_t j = i + 1; j < size_t(terms.size()); ++j)
+                    {
+                        path.push_back(std::make_pair(i, j));
+                        search_path(
+                            contract_labels(terms, i, j, output),
+                            output,
+                            sizes,
+                            path,
+                            cost + pair_cost(terms, i, j, sizes),
+                            best,
+                            best_path);
+                        path.pop_back();
+                    }
+            }
+
+            /**
+             * @brief Chooses the order of pairwise contractions: the
+             * cheapest overall for up to EINSUM_OPTIMAL_TERMS operands, else
+             * repeatedly the cheapest pair, smallest result first on ties.
+             *
+             * @param terms Labels of the operands.
+             * @param output Output labels.
+             * @param sizes Size of each label.
+             * @return Contraction order.
+             */
+            inline EinsumPath plan_einsum(
+                std::vector<std::string> terms,
+                const std::string& output,
+                const std::map<char, size_t>& sizes)
+            {
+                EinsumPath path;
+
+                if (terms.size() <= EINSUM_OPTIMAL_TERMS)
+                {
+                    EinsumPath best_path;
+                    double best = std::numeric_limits<double>::infinity();
+
+                    search_path(terms, output, sizes, path, 0, best, best_path);
+
+                    return best_path;
+                }
+
+                while (terms.size() > 1)
+                {
+                    size_t best_i = 0, best_j = 1;
+                    double best_cost = std::numeric_limits<double>::infinity();
+                    double best_size = best_cost;
+
+                    for (size_t i = 0; i < size_t(terms.size()); ++i)
+                        for (size_t j = i + 1; j < size_t(terms.size()); ++j)
+                        {
+                            double cost = pair_cost(terms, i, j, sizes);
+                            double size = labels_size(
+                                kept_labels(terms, i, j, output), sizes);
+
+                            if (cost < best_cost ||
+                                (cost == best_cost && size < best_size))
+                            {
+                                best_i = i;
+                                best_j = j;
+                                best_cost = cost;
+                                best_size = size;
+                            }
+                        }
+
+                    path.push_back(std::make_pair(best_i, best_j));
+                    terms = contract_labels(terms, best_i, best_j, output);
+                }
+
+                return path;
+            }
+
+            /**
+             * @brief Wraps an array or view as a term. Repeated labels take
+             * the diagonal, by summing their strides.
+             *
+             * @tparam T Element type.
+             * @param array Operand.
+             * @param labels Labels of its axes.
+             * @param sizes Size of each label, filled and checked.
+             * @return Strided term over the operand's buffer.
+             */
+            template<typename T>
+            EinsumTerm<T> make_term(
+                const ND_ARRAY<T>& array,
+                const std::string& labels,
+                std::map<char, size_t>& sizes)
+            {
+                const auto& shape = array.shape();
+                const auto strides = array.memory_strides();
+                EinsumTerm<T> term;
+
+                NUMC_CHECK(
+                    size_t(labels.size()) == size_t(shape.size()),
+                    Core::ErrorCode::InvalidShape,
+                    "einsum - 4: term length differs from operand ndims.");
+
+                term.data = array.memory_data() + array.memory_offset();
+
+                for (size_t d = 0; d < size_t(labels.size()); ++d)
+                {
+                    const char ch = labels[d];
+
+                    NUMC_CHECK(
+                        sizes.count(ch) == 0 || sizes[ch] == shape[d],
+                        Core::ErrorCode::InvalidShape,
+                        "einsum - 5: a label spans axes of different sizes.");
+
+                    sizes[ch] = shape[d];
+
+                    const auto pos = term.labels.find(ch);
+
+                    if (pos != std::string::npos)
+                    {
+                        term.strides[pos] += strides[d];
+
+                        continue;
+                    }
+
+                    term.labels.push_back(ch);
+                    term.sizes.push_back(shape[d]);
+                    term.strides.push_back(strides[d]);
+                }
+
+                return term;
+            }
+
+            /**
+             * @brief Wraps a new contiguous array as a term.
+             *
+             * @tparam T Element type.
+             * @param labels Labels of its axes.
+             * @param sizes Size of each label.
+             * @return Term owning a zeroed array.
+             */
+            template<typename T>
+            EinsumTerm<T> new_term(
+                const std::string& labels,
+                const std::map<char, size_t>& sizes)
+            {
+                EinsumTerm<T> term;
+                shape_t shape;
+
+                term.labels = labels;
+
+                for (char ch: labels)
+                {
+                    term.sizes.push_back(sizes.at(ch));
+                    shape.push_back(sizes.at(ch));
+                }
+
+                term.strides.assign(labels.size(), 1);
+
+                for (size_t d = size_t(labels.size()) - 1; d > 0; --d)
+                    term.strides[d - 1] = term.strides[d] * term.sizes[d];
+
+                // Full contractions give a 1 element array.
+                if (shape.empty())
+                    shape.push_back(1);
+
+                term.owner = std::make_shared<ND_ARRAY<T>>(
+                    shape, Core::ArrayInit::Zeros);
+                term.data = term.owner->data();
+
+                return term;
+            }
+
+            /// @brief Sizes and strides of some of a term's labels.
+            template<typename T>
+            void select_axes(
+                const EinsumTerm<T>& term,
+                const std::string& labels,
+                std::vector<size_t>& sizes,
+                std::vector<size_t>& strides)
+            {
+                sizes.clear();
+                strides.clear();
+
+                for (char ch: labels)
+                {
+                    const auto pos = term.labels.find(ch);
+
+                    sizes.push_back(term.sizes[pos]);
+                    strides.push_back(term.strides[pos]);
+                }
+            }
+
+            /**
+             * @brief Sums a term over every label not in labels, into a new
+             * contiguous term with exactly those labels in that order. Also
+             * serves as the strided copy for transposes.
+             *
+             * @tparam T Element type.
+             * @param term Input term.
+             * @param labels Labels of the result.
+             * @param sizes Size of each label.
+             * @return New term.
+             */
+            template<typename T>
+            EinsumTerm<T> reduce_term(
+                const EinsumTerm<T>& term,
+                const std::string& labels,
+                const std::map<char, size_t>& sizes)
+            {
+                EinsumTerm<T> result = new_term<T>(labels, sizes);
+                std::string summed;
+
+                for (char ch: term.labels)
+                    if (labels.find(ch) == std::string::npos)
+                        summed.push_back(ch);
+
+                // Last kept label walked inline, the others via offsets.
+                const std::string outer = labels.empty() ?
+                    labels : labels.substr(0, labels.size() - 1);
+                size_t inner = 1, inner_stride = 0;
+
+                if (!labels.empty())
+                {
+                    const auto pos = term.labels.find(labels.back());
+
+                    inner = term.sizes[pos];
+                    inner_stride = term.strides[pos];
+                }
+
+                std::vector<size_t> axis_sizes, axis_strides;
+
+                select_axes(term, outer, axis_sizes, axis_strides);
+                const auto outer_off = offsets(axis_sizes, axis_strides);
+                select_axes(term, summed, axis_sizes, axis_strides);
+                const auto summed_off = offsets(axis_sizes, axis_strides);
+
+                const T* in = term.data;
+                T* out = result.owner->data();
+
+                Utils::parallel_for(
+                    0,
+                    size_t(outer_off.size()),
+                    EINSUM_REDUCE_GRAIN,
+                    [&](size_t lo, size_t hi)
+                    {
+                        for (size_t o = lo; o < hi; ++o)
+                        {
+                            T* row = out + o * inner;
+
+                            for (auto s: summed_off)
+                            {
+                                const T* src = in + outer_off[o] + s;
+
+                                for (size_t i = 0; i < inner; ++i)
+                                    row[i] += src[i * inner_stride];
+                            }
+                        }
+                    });
+
+                return result;
+            }
+
+            /**
+             * @brief Contracts two terms into one holding the kept labels,
+             * as a batched matrix product: shared kept labels are batches,
+             * shared dropped ones the inner dimension and the rest rows or
+             * columns. Labels only one side drops are summed first.
+             *
+             * @tparam T Element type.
+             * @param a First term.
+             * @param b Second term.
+             * @param kept Labels of the result.
+             * @param sizes Size of each label.
+             * @return New term.
+             */
+            template<typename T>
+            EinsumTerm<T> contract_pair(
+                EinsumTerm<T> a,
+                EinsumTerm<T> b,
+                const std::string& kept,
+                const std::map<char, size_t>& sizes)
+            {
+                auto in = [](char ch, const std::string& labels)
+                {
+                    return labels.find(ch) != std::string::npos;
+                };
+
+                std::string a_own, b_own;
+
+                for (char ch: a.labels)
+                    if (in(ch, b.labels) || in(ch, kept))
+                        a_own.push_back(ch);
+                for (char ch: b.labels)
+                    if (in(ch, a.labels) || in(ch, kept))
+                        b_own.push_back(ch);
+
+                if (a_own != a.labels)
+                    a = reduce_term(a, a_own, sizes);
+                if (b_own != b.labels)
+                    b = reduce_term(b, b_own, sizes);
+
+                std::string batch, rows, inner, cols;
+
+                for (char ch: a.labels)
+                {
+                    if (!in(ch, b.labels))
+                        rows.push_back(ch);
+                    else if (in(ch, kept))
+                        batch.push_back(ch);
+                    else
+                        inner.push_back(ch);
+                }
+
+                for (char ch: b.labels)
+                    if (!in(ch, a.labels))
+                        cols.push_back(ch);
+
+                EinsumTerm<T> result =
+                    new_term<T>(batch + rows + cols, sizes);
+                GemmLayout g;
+                std::vector<size_t> axis_sizes, axis_strides;
+
+                select_axes(a, batch, axis_sizes, axis_strides);
+                g.batch_a = offsets(axis_sizes, axis_strides);
+                select_axes(b, batch, axis_sizes, axis_strides);
+                g.batch_b = offsets(axis_sizes, axis_strides);
+                select_axes(a, rows, axis_sizes, axis_strides);
+                g.rows = offsets(axis_sizes, axis_strides);
+                select_axes(a, inner, axis_sizes, axis_strides);
+                g.a_k = offsets(axis_sizes, axis_strides);
+                select_axes(b, inner, axis_sizes, axis_strides);
+                g.b_k = offsets(axis_sizes, axis_strides);
+                select_axes(b, cols, axis_sizes, axis_strides);
+                g.cols = offsets(axis_sizes, axis_strides);
+
+                gemm(a.data, b.data, result.owner->data(), g);
+
+                return result;
+            }
+        }
+
+        /**
+         * @brief Einstein summation over arrays and views, e.g. "ij,jk->ik"
+         * for a matrix product or "bij,bjk->bik" for a batched one.
+         *
+         * Operands are read in place through their buffer strides, so
+         * transposed and sliced views cost no copies. Several operands are
+         * contracted pairwise, in the order with the fewest multiply-adds:
+         * searched exhaustively for up to 4 operands, greedily beyond.
+         * Each pairwise contraction runs as a blocked, batched matmul.
+         *
+         * @note Repeated labels in a term take its diagonal. Ellipses are
+         * not supported. A full contraction returns a 1 element array.
+         *
+         * @tparam T Array element data type.
+         * @param subscripts Subscripts, with or without "->" and output.
+         * @param operands Pointers to the operands, one per term.
+         * @return New array of the output labels' shape.
+         */
+        template<typename T>
+        ND_ARRAY<T> einsum(
+            const std::string& subscripts,
+            const std::vector<const ND_ARRAY<T>*>& operands)
+        {
+            NUMC_TRACE_SCOPE("einsum", "linalg");
+
+            const auto spec =
+                Detail::parse_einsum(subscripts, operands.size());
+            std::map<char, size_t> sizes;
+            std::vector<Detail::EinsumTerm<T>> terms;
+
+            for (size_t i = 0; i < size_t(operands.size()); ++i)
+                terms.push_back(
+                    Detail::make_term(*operands[i], spec.inputs[i], sizes));
+
+            std::vector<std::string> labels;
+
+            for (const auto& term: terms)
+                labels.push_back(term.labels);
+
+            for (const auto& step:
+                Detail::plan_einsum(labels, spec.output, sizes))
+            {
+                const auto kept = Detail::kept_labels(
+                    labels, step.first, step.second, spec.output);
+                auto result = Detail::contract_pair(
+                    terms[step.first], terms[step.second], kept, sizes);
+
+                terms.erase(terms.begin() + step.second);
+                terms.erase(terms.begin() + step.first);
+                terms.push_back(result);
+                labels = Detail::contract_labels(
+                    labels, step.first, step.second, spec.output);
+            }
+
+            auto last = terms.front();
+
+            // The last contraction usually leaves the output as is;
+            // otherwise sum or reorder into it.
+            if (!last.owner || last.labels != spec.output)
+                last = Detail::reduce_term(last, spec.output, sizes);
+
+            NUMC_TRACE_INFO(
+                last.owner->size(),
+                last.owner->size() * sizeof(T),
+                Core::trace_describe(*last.owner));
+
+            return *last.owner;
+        }
+
+        /**
+         * @brief Einstein summation over arrays and views, e.g.
+         * einsum("ij,jk->ik", a, b). See the overload taking a list of
+         * operands.
+         *
+         * @tparam T Array element data type.
+         * @tparam Rest Further operand types, arrays or views of T.
+         * @param subscripts Subscripts, with or without "->" and output.
+         * @param first First operand.
+         * @param rest Further operands.
+         * @return New array of the output labels' shape.
+         */
+        template<typename T, typename... Rest>
+        ND_ARRAY<T> einsum(
+            const std::string& subscripts,
+            const ND_ARRAY<T>& first,
+            const Rest&... rest)
+        {
+            std::vector<const ND_ARRAY<T>*> operands{&first, &rest...};
+
+            return einsum(subscripts, operands);
+        }
+    }
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace NumC
+{
+    namespace Linalg
+    {
+        namespace Detail
+        {
+            /// @brief Rows of A per parallel task and packed block.
+            const size_t GEMM_MC = 64;
+
+            /// @brief Depth of the packed blocks.
+            const size_t GEMM_KC = 256;
+
+            /// @brief Columns of B per packed block.
+            const size_t GEMM_NC = 512;
+
+            /**
+             * @brief Buffer offsets of every multi-index over a group of
+             * axes, in row-major order.
+             *
+             * @param sizes Size of each axis.
+             * @param strides Buffer stride of each axis.
+             * @return Offsets, one per multi-index. {0} for no axes.
+             */
+            inline std::vector<size_t> offsets(
+                const std::vector<size_t>& sizes,
+                const std::vector<size_t>& strides)
+            {
+                std::vector<size_t> result(1, 0);
+
+                for (size_t d = 0; d < size_t(sizes.size()); ++d)
+                {
+                    std::vector<size_t> next;
+
+                    next.reserve(result.size() * sizes[d]);
+
+                    for (auto base: result)
+                        for (size_t i = 0; i < sizes[d]; ++i)
+                            next.push_back(base + i * strides[d]);
+
+                    result.swap(next);
+                }
+
+                return result;
+            }
+
+            /**
+             * @brief Strided operands of a batched product
+             * C[b](m, n) = sum_k A[b](m, k) * B[b](k, n). Element (m, k) of
+             * batch b of A is a[batch_a[b] + rows[m] + a_k[k]], element
+             * (k, n) of B is b[batch_b[b] + b_k[k] + cols[n]]. Offset tables
+             * let grouped axes of any strided view take part without copies.
+             */
+            struct GemmLayout
+            {
+                std::vector<size_t> batch_a;
+                std::vector<size_t> batch_b;
+                std::vector<size_t> rows;
+                std::vector<size_t> a_k;
+                std::vector<size_t> b_k;
+                std::vector<size_t> cols;
+            };
+
+            /// @brief Rows of C per micro-kernel call.
+            const size_t GEMM_MR = 4;
+
+            /// @brief Columns of C per micro-kernel call.
+            const size_t GEMM_NR = 8;
+
+            /// @brief n rounded up to a multiple of step.
+            inline size_t round_up(size_t n, size_t step)
+            {
+                return (n + step - 1) / step * step;
+            }
+
+            /**
+             * @brief c(m, n) += alpha * sum_k ap(m, k) * bp(k, n) for one
+             * GEMM_MR x GEMM_NR tile, accumulated in registers.
+             *
+             * @tparam T Element type.
+             * @param ap Packed A panel, kc x GEMM_MR.
+             * @param bp Packed B panel, kc x GEMM_NR.
+             * @param c First element of the C tile.
+             * @param kc Depth.
+             * @param mr Valid rows of the tile.
+             * @param nr Valid columns of the tile.
+             * @param ldc Row stride of C.
+             * @param alpha Scale of the product.
+             */
+            template<typename T>
+            void gemm_tile(
+                const T* ap,
+                const T* bp,
+                T* c,
+                size_t kc,
+                size_t mr,
+                size_t nr,
+                size_t ldc,
+                T alpha)
+            {
+                T acc[GEMM_MR][GEMM_NR];
+
+                for (size_t r = 0; r < GEMM_MR; ++r)
+                    for (size_t j = 0; j < GEMM_NR; ++j)
+                        acc[r][j] = T(0);
+
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    const T* a = ap + k * GEMM_MR;
+                    const T* b = bp + k * GEMM_NR;
+
+                    for (size_t r = 0; r < GEMM_MR; ++r)
+                        for (size_t j = 0; j < GEMM_NR; ++j)
+                            acc[r][j] += a[r] * b[j];
+                }
+
+                for (size_t r = 0; r < mr; ++r)
+                    for (size_t j = 0; j < nr; ++j)
+                        c[r * ldc + j] += alpha * acc[r][j];
+            }
+
+            /**
+             * @brief Blocked, batched product over strided operands. Blocks
+             * of A and B are packed into zero padded panels, so transposed
+             * or sliced operands cost no more than contiguous ones. Batches
+             * and blocks of GEMM_MC rows run in parallel.
+             *
+             * @tparam T Element type.
+             * @param a Buffer of A.
+             * @param b Buffer of B.
+             * @param c Output, (batch, M) rows of ldc elements. The
+             * product is added to it.
+             * @param g Operand layout.
+             * @param alpha Scale of the product.
+             * @param ldc Row stride of C, 0 for N.
+             */
+            template<typename T>
+            void gemm(
+                const T* a,
+                const T* b,
+                T* c,
+                const GemmLayout& g,
+                T alpha = T(1),
+                size_t ldc = 0)
+            {
+                const size_t M = g.rows.size();
+                const size_t N = g.cols.size();
+                const size_t K = g.a_k.size();
+
+                if (ldc == 0)
+                    ldc = N;
+
+                const size_t m_blocks = (M + GEMM_MC - 1) / GEMM_MC;
+
+                Utils::parallel_for(
+                    size_t(g.batch_a.size()) * m_blocks,
+                    [&](size_t task)
+                    {
+                        const size_t batch = task / m_blocks;
+                        const size_t m0 = (task % m_blocks) * GEMM_MC;
+                        const size_t mc = std::min(GEMM_MC, M - m0);
+                        const T* a_base = a + g.batch_a[batch];
+                        const T* b_base = b + g.batch_b[batch];
+                        T* c_base = c + (batch * M + m0) * ldc;
+                        // Sized for the block, small products stay cheap.
+                        const size_t kc_max = std::min(GEMM_KC, K);
+                        std::vector<T> ap(round_up(mc, GEMM_MR) * kc_max);
+                        std::vector<T> bp(
+                            kc_max * round_up(std::min(GEMM_NC, N), GEMM_NR));
+
+                        for (size_t n0 = 0; n0 < N; n0 += GEMM_NC)
+                        {
+                            const size_t nc = std::min(GEMM_NC, N - n0);
+
+                            for (size_t k0 = 0; k0 < K; k0 += GEMM_KC)
+                            {
+                                const size_t kc = std::min(GEMM_KC, K - k0);
+
+                                // B as kc x GEMM_NR panels.
+                                for (size_t n = 0; n < nc; n += GEMM_NR)
+                                {
+                                    T* dst = bp.data() + n * kc;
+
+                                    for (size_t k = 0; k < kc; ++k)
+                                    {
+                                        const T* src = b_base + g.b_k[k0 + k];
+
+                                        for (size_t j = 0; j < GEMM_NR; ++j)
+                                            *dst++ = n + j < nc ?
+                                                src[g.cols[n0 + n + j]] : T(0);
+                                    }
+                                }
+
+                                // A as kc x GEMM_MR panels.
+                                for (size_t m = 0; m < mc; m += GEMM_MR)
+                                {
+                                    T* dst = ap.data() + m * kc;
+
+                                    for (size_t k = 0; k < kc; ++k)
+                                    {
+                                        const T* src = a_base + g.a_k[k0 + k];
+
+                                        for (size_t r = 0; r < GEMM_MR; ++r)
+                                            *dst++ = m + r < mc ?
+                                                src[g.rows[m0 + m + r]] : T(0);
+                                    }
+                                }
+
+                                for (size_t m = 0; m < mc; m += GEMM_MR)
+                                    for (size_t n = 0; n < nc; n += GEMM_NR)
+                                        gemm_tile(
+                                            ap.data() + m * kc,
+                                            bp.data() + n * kc,
+                                            c_base + m * ldc + n0 + n,
+                                            kc,
+                                            std::min(GEMM_MR, mc - m),
+                                            std::min(GEMM_NR, nc - n),
+                                            ldc,
+                                            alpha);
+                            }
+                        }
+                    });
+            }
+        }
+
+        /**
+         * @brief Matrix product of two 2-D arrays or views. Transposed and
+         * sliced views are read in place.
+         *
+         * @tparam T Array element data type.
+         * @param a Lhs (rows, k).
+         * @param b Rhs (k, cols).
+         * @return New (rows, cols) array.
+         */
+        template<typename T>
+        ND_ARRAY<T> matmul(const ND_ARRAY<T>& a, const ND_ARRAY<T>& b)
+        {
+            NUMC_TRACE_SCOPE("matmul", "linalg");
+
+            NUMC_CHECK(
+                a.shape().size() == 2 && b.shape().size() == 2,
+                Core::ErrorCode::InvalidShape,
+                "linalg - 1: matmul expects 2-D operands.");
+
+            NUMC_CHECK(
+                a.shape()[1] == b.shape()[0],
+                Core::ErrorCode::InvalidShape,
+                "linalg - 2: matmul inner dimensions must match.");
+
+            const size_t rows = a.shape()[0];
+            const size_t k = a.shape()[1];
+            const size_t cols = b.shape()[1];
+            const auto a_strides = a.memory_strides();
+            const auto b_strides = b.memory_strides();
+            Detail::GemmLayout g;
+
+            g.batch_a.assign(1, a.memory_offset());
+            g.batch_b.assign(1, b.memory_offset());
+            g.rows = Detail::offsets({rows}, {a_strides[0]});
+            g.a_k = Detail::offsets({k}, {a_strides[1]});
+            g.b_k = Detail::offsets({k}, {b_strides[0]});
+            g.cols = Detail::offsets({cols}, {b_strides[1]});
+
+            ND_ARRAY<T> result(shape_t({rows, cols}), Core::ArrayInit::Zeros);
+
+            Detail::gemm(a.memory_data(), b.memory_data(), result.data(), g);
+
+            NUMC_TRACE_INFO(
+                rows * cols,
+                (rows * k + k * cols + rows * cols) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Linalg/Gemm.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Linalg
+    {
+        namespace Detail
+        {
+            /// @brief Output bytes written per parallel task of outer/kron.
+            const size_t PRODUCT_GRAIN_BYTES = size_t(256) << 10;
+
+            /**
+             * @brief out[i] = s * in[i] for i in [0, n).
+             *
+             * @tparam T Element type.
+             * @param in Input row.
+             * @param s Scale.
+             * @param out Output row.
+             * @param n Number of elements.
+             */
+            template<typename T>
+            void scale_row(const T* in, T s, T* out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = s * in[i];
+            }
+
+#if defined(__SSE2__)
+            inline void scale_row(
+                const float32* in, float32 s, float32* out, size_t n)
+            {
+                const __m128 vs = _mm_set1_ps(s);
+                size_t i = 0;
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    _mm_storeu_ps(
+                        out + i, _mm_mul_ps(vs, _mm_loadu_ps(in + i)));
+                    _mm_storeu_ps(
+                        out + i + 4,
+                        _mm_mul_ps(vs, _mm_loadu_ps(in + i + 4)));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = s * in[i];
+            }
+
+            inline void scale_row(
+                const float64* in, float64 s, float64* out, size_t n)
+            {
+                const __m128d vs = _mm_set1_pd(s);
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4)
+                {
+                    _mm_storeu_pd(
+                        out + i, _mm_mul_pd(vs, _mm_loadu_pd(in + i)));
+                    _mm_storeu_pd(
+                        out + i + 2,
+                        _mm_mul_pd(vs, _mm_loadu_pd(in + i + 2)));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = s * in[i];
+            }
+#endif
+
+            /**
+             * @brief Tells if an array or view has its elements in
+             * row-major order in its buffer.
+             *
+             * @tparam T Element type.
+             * @param array Array or view.
+             * @return True if row-major contiguous.
+             */
+            template<typename T>
+            bool is_row_major(const ND_ARRAY<T>& array)
+            {
+                const auto& shape = array.shape();
+                const auto strides = array.memory_strides();
+                size_t expected = 1;
+
+                for (size_t d = size_t(shape.size()); d-- > 0;)
+                {
+                    if (shape[d] != 1 && strides[d] != expected)
+                        return false;
+
+                    expected *= shape[d];
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief Elements of an array or view in row-major order. The
+             * buffer is used directly when already laid out that way,
+             * otherwise the elements are gathered once with copy() into a
+             * tracked buffer.
+             *
+             * @tparam T Element type.
+             * @param array Array or view.
+             * @param scratch Holds the gathered copy, if one is made.
+             * @return Pointer to array.size() contiguous elements.
+             */
+            template<typename T>
+            const T* row_major(const ND_ARRAY<T>& array, ND_ARRAY<T>& scratch)
+            {
+                if (is_row_major(array))
+                    return array.memory_data() + array.memory_offset();
+
+                scratch = array.copy();
+
+                return scratch.data();
+            }
+
+            /**
+             * @brief Normalizes and checks a list of axes of an array.
+             *
+             * @param axes Axes, negative ones counted from the end.
+             * @param ndims Number of dimensions of the array.
+             * @return Axes in [0, ndims).
+             */
+            inline std::vector<size_t> normalize_axes(
+                const std::vector<size_t>& axes, size_t ndims)
+            {
+                std::vector<size_t> result;
+
+                for (auto axis: axes)
+                {
+                    if (axis < 0)
+                        axis += ndims;
+
+                    NUMC_CHECK(
+                        axis >= 0 && axis < ndims &&
+                        std::find(result.begin(), result.end(), axis) ==
+                            result.end(),
+                        Core::ErrorCode::InvalidArgument,
+                        "tensordot - 2: axes out of range or repeated.");
+
+                    result.push_back(axis);
+                }
+
+                return result;
+            }
+        }
+
+        /**
+         * @brief Tensor dot product: sums the products of a and b over
+         * axes_a of a paired with axes_b of b. The result has the remaining
+         * axes of a followed by the remaining axes of b.
+         *
+         * Both sides are read in place through their buffer strides and
+         * the axis groups are handed to the blocked GEMM as offset tables,
+         * so no transposed or reshaped copy is ever built; the only copies
+         * are the cache sized blocks the GEMM packs.
+         *
+         * @note Contracting every axis returns a 1 element array.
+         *
+         * @tparam T Array element data type.
+         * @param a Lhs array or view.
+         * @param b Rhs array or view.
+         * @param axes_a Contracted axes of a.
+         * @param axes_b Contracted axes of b, in the same order.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> tensordot(
+            const ND_ARRAY<T>& a,
+            const ND_ARRAY<T>& b,
+            const std::vector<size_t>& axes_a,
+            const std::vector<size_t>& axes_b)
+        {
+            NUMC_TRACE_SCOPE("tensordot", "linalg");
+
+            NUMC_CHECK(
+                axes_a.size() == axes_b.size(),
+                Core::ErrorCode::InvalidArgument,
+                "tensordot - 1: axes lists differ in length.");
+
+            const auto& a_shape = a.shape();
+            const auto& b_shape = b.shape();
+            const auto a_strides = a.memory_strides();
+            const auto b_strides = b.memory_strides();
+            const auto sum_a = Detail::normalize_axes(axes_a, a_shape.size());
+            const auto sum_b = Detail::normalize_axes(axes_b, b_shape.size());
+            std::vector<size_t> k_sizes, a_k, b_k;
+            std::vector<size_t> row_sizes, rows, col_sizes, cols;
+            shape_t shape;
+
+            for (size_t i = 0; i < size_t(sum_a.size()); ++i)
+            {
+                NUMC_CHECK(
+                    a_shape[sum_a[i]] == b_shape[sum_b[i]],
+                    Core::ErrorCode::InvalidShape,
+                    "tensordot - 3: contracted axes differ in size.");
+
+                k_sizes.push_back(a_shape[sum_a[i]]);
+                a_k.push_back(a_strides[sum_a[i]]);
+                b_k.push_back(b_strides[sum_b[i]]);
+            }
+
+            for (size_t d = 0; d < size_t(a_shape.size()); ++d)
+            {
+                if (std::count(sum_a.begin(), sum_a.end(), d) != 0)
+                    continue;
+
+                row_sizes.push_back(a_shape[d]);
+                rows.push_back(a_strides[d]);
+                shape.push_back(a_shape[d]);
+            }
+
+            for (size_t d = 0; d < size_t(b_shape.size()); ++d)
+            {
+                if (std::count(sum_b.begin(), sum_b.end(), d) != 0)
+                    continue;
+
+                col_sizes.push_back(b_shape[d]);
+                cols.push_back(b_strides[d]);
+                shape.push_back(b_shape[d]);
+            }
+
+            if (shape.empty())
+                shape.push_back(1);
+
+            Detail::GemmLayout g;
+
+            g.batch_a.assign(1, a.memory_offset());
+            g.batch_b.assign(1, b.memory_offset());
+            g.rows = Detail::offsets(row_sizes, rows);
+            g.a_k = Detail::offsets(k_sizes, a_k);
+            g.b_k = Detail::offsets(k_sizes, b_k);
+            g.cols = Detail::offsets(col_sizes, cols);
+
+            ND_ARRAY<T> result(shape, Core::ArrayInit::Zeros);
+
+            Detail::gemm(a.memory_data(), b.memory_data(), result.data(), g);
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                (a.size() + b.size() + result.size()) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Tensor dot product over the last n axes of a and the first
+         * n axes of b, in order. n = 1 is a matrix product, n = 2 the
+         * default of NumPy.
+         *
+         * @tparam T Array element data type.
+         * @param a Lhs array or view.
+         * @param b Rhs array or view.
+         * @param n Number of contracted axes.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> tensordot(
+            const ND_ARRAY<T>& a, const ND_ARRAY<T>& b, size_t n = 2)
+        {
+            const size_t a_dims = a.shape().size();
+
+            NUMC_CHECK(
+                n >= 0 && n <= a_dims && n <= size_t(b.shape().size()),
+                Core::ErrorCode::InvalidArgument,
+                "tensordot - 2: axes out of range or repeated.");
+
+            std::vector<size_t> axes_a, axes_b;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                axes_a.push_back(a_dims - n + i);
+                axes_b.push_back(i);
+            }
+
+            return tensordot(a, b, axes_a, axes_b);
+        }
+
+        /**
+         * @brief Outer product of the flattened a and b:
+         * result(i, j) = a[i] * b[j]. Rows are written in parallel with
+         * vectorized scaling of b.
+         *
+         * @tparam T Array element data type.
+         * @param a Lhs array or view.
+         * @param b Rhs array or view.
+         * @return New (a.size(), b.size()) array.
+         */
+        template<typename T>
+        ND_ARRAY<T> outer(const ND_ARRAY<T>& a, const ND_ARRAY<T>& b)
+        {
+            NUMC_TRACE_SCOPE("outer", "linalg");
+
+            ND_ARRAY<T> a_scratch, b_scratch;
+            const T* av = Detail::row_major(a, a_scratch);
+            const T* bv = Detail::row_major(b, b_scratch);
+            const size_t rows = a.size();
+            const size_t cols = b.size();
+
+            ND_ARRAY<T> result(shape_t({rows, cols}));
+            T* out = result.data();
+
+            Utils::parallel_for(
+                0,
+                rows,
+                std::max<size_t>(
+                    1, Detail::PRODUCT_GRAIN_BYTES / (cols * sizeof(T) + 1)),
+                [&](size_t lo, size_t hi)
+                {
+                    for (size_t i = lo; i < hi; ++i)
+                        Detail::scale_row(bv, av[i], out + i * cols, cols);
+                });
+
+            NUMC_TRACE_INFO(
+                rows * cols,
+                (rows + cols + rows * cols) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Kronecker product. The operand of fewer dimensions is
+         * padded with leading 1s; axis d of the result has size
+         * a.shape()[d] * b.shape()[d], and block (i...) of it is
+         * a(i...) * b. Output rows are written in parallel, each as
+         * vectorized scaled copies of a row of b.
+         *
+         * @tparam T Array element data type.
+         * @param a Lhs array or view.
+         * @param b Rhs array or view.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> kron(const ND_ARRAY<T>& a, const ND_ARRAY<T>& b)
+        {
+            NUMC_TRACE_SCOPE("kron", "linalg");
+
+            const size_t ndims =
+                std::max(size_t(a.shape().size()), size_t(b.shape().size()));
+            std::vector<size_t> a_dims(ndims, 1), b_dims(ndims, 1);
+
+            std::copy(
+                a.shape().begin(), a.shape().end(),
+                a_dims.end() - a.shape().size());
+            std::copy(
+                b.shape().begin(), b.shape().end(),
+                b_dims.end() - b.shape().size());
+
+            std::vector<size_t> a_strides(ndims, 1), b_strides(ndims, 1);
+            shape_t shape(ndims);
+
+            for (size_t d = ndims; d-- > 0;)
+            {
+                shape[d] = a_dims[d] * b_dims[d];
+
+                if (d + 1 < ndims)
+                {
+                    a_strides[d] = a_strides[d + 1] * a_dims[d + 1];
+                    b_strides[d] = b_strides[d + 1] * b_dims[d + 1];
+                }
+            }
+
+            ND_ARRAY<T> a_scratch, b_scratch;
+            const T* av = Detail::row_major(a, a_scratch);
+            const T* bv = Detail::row_major(b, b_scratch);
+            const size_t a_last = a_dims.back();
+            const size_t b_last = b_dims.back();
+            const size_t cols = shape.back();
+
+            ND_ARRAY<T> result(shape);
+            T* out = result.data();
+            const size_t rows = result.size() / std::max<size_t>(1, cols);
+
+            Utils::parallel_for(
+                0,
+                rows,
+                std::max<size_t>(
+                    1, Detail::PRODUCT_GRAIN_BYTES / (cols * sizeof(T) + 1)),
+                [&](size_t lo, size_t hi)
+                {
+                    for (size_t r = lo; r < hi; ++r)
+                    {
+                        // Split the output row index into the row indices
+                        // of a and b, last leading axis first.
+                        size_t a_off = 0, b_off = 0, rest = r;
+
+                        for (size_t d = ndims - 1; d-- > 0;)
+                        {
+                            const size_t o = rest % shape[d];
+
+                            rest /= shape[d];
+                            a_off += (o / b_dims[d]) * a_strides[d];
+                            b_off += (o % b_dims[d]) * b_strides[d];
+                        }
+
+                        T* row = out + r * cols;
+
+                        for (size_t i = 0; i < a_last; ++i)
+                            Detail::scale_row(
+                                bv + b_off, av[a_off + i],
+                                row + i * b_last, b_last);
+                    }
+                });
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                (a.size() + b.size() + result.size()) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+    }
+}
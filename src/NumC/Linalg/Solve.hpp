@@ -0,0 +1,291 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Linalg/Decomp.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace NumC
+{
+    namespace Linalg
+    {
+        namespace Detail
+        {
+            /**
+             * @brief Checks the right-hand sides of a stack of (n, n)
+             * systems: (..., n) vectors or (..., n, k) matrices, with the
+             * leading axes of the stack.
+             *
+             * @tparam T Element type.
+             * @param a (..., n, n) matrices.
+             * @param b Right-hand sides.
+             * @return Number of right-hand sides per system, k.
+             */
+            template<typename T>
+            size_t rhs_columns(const ND_ARRAY<T>& a, const ND_ARRAY<T>& b)
+            {
+                const auto& a_shape = a.shape();
+                const auto& b_shape = b.shape();
+                const bool vectors = b_shape.size() + 1 == a_shape.size();
+                bool match = vectors || b_shape.size() == a_shape.size();
+
+                for (size_t d = 0; match && d + 1 < size_t(a_shape.size()); ++d)
+                    match = b_shape[d] == a_shape[d];
+
+                NUMC_CHECK(
+                    match,
+                    Core::ErrorCode::InvalidShape,
+                    "linalg - 5: right-hand sides do not match the "
+                    "matrices.");
+
+                return vectors ? 1 : b_shape.back();
+            }
+
+            /**
+             * @brief Throws if a triangular factor has a zero on its
+             * diagonal.
+             *
+             * @tparam T Element type.
+             * @param t (n, n) row-major matrix.
+             * @param n Order.
+             */
+            template<typename T>
+            void check_diagonal(const T* t, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    NUMC_CHECK(
+                        t[i * n + i] != T(0),
+                        Core::ErrorCode::SingularMatrix,
+                        "linalg - 6: matrix is singular.");
+            }
+
+            /**
+             * @brief Solves one factored system in place of x.
+             *
+             * @tparam T Element type.
+             * @param lu (n, n) LU factors.
+             * @param piv n pivots.
+             * @param x (n, k) right-hand sides.
+             */
+            template<typename T>
+            void lu_solve_matrix(
+                const T* lu, const size_t* piv, size_t n, T* x, size_t k)
+            {
+                check_diagonal(lu, n);
+
+                for (size_t i = 0; i < n; ++i)
+                    if (piv[i] != i)
+                        std::swap_ranges(
+                            x + i * k, x + (i + 1) * k, x + piv[i] * k);
+
+                trsm(lu, n, x, k, n, k, true, true);
+                trsm(lu, n, x, k, n, k, false, false);
+            }
+        }
+
+        /**
+         * @brief Solves t x = b for triangular t, or a stack of such
+         * systems. Blocked: rows already solved are subtracted from each
+         * block of FACTOR_NB rows with one GEMM.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param t (..., n, n) triangular matrices. The other triangle is
+         * not read.
+         * @param b (..., n) or (..., n, k) right-hand sides.
+         * @param lower Lower rather than upper triangular.
+         * @param unit_diagonal Assume ones on the diagonal of t.
+         * @return New array of b's shape.
+         */
+        template<typename T>
+        ND_ARRAY<T> solve_triangular(
+            const ND_ARRAY<T>& t,
+            const ND_ARRAY<T>& b,
+            bool lower = true,
+            bool unit_diagonal = false)
+        {
+            NUMC_TRACE_SCOPE("solve_triangular", "linalg");
+            Detail::require_float<T>();
+
+            const size_t batch = Detail::matrix_batch(t, true);
+            const size_t k = Detail::rhs_columns(t, b);
+            const size_t n = t.shape().back();
+            ND_ARRAY<T> scratch;
+            const T* tv = Detail::row_major(t, scratch);
+            ND_ARRAY<T> result = Detail::dense_copy(b);
+            T* x = result.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    const T* ti = tv + i * n * n;
+
+                    if (!unit_diagonal)
+                        Detail::check_diagonal(ti, n);
+
+                    Detail::trsm(
+                        ti, n, x + i * n * k, k, n, k, lower, unit_diagonal);
+                });
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                (t.size() + 2 * result.size()) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Solves a x = b from the LU factors of a, for one or a
+         * stack of systems.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param factors Result of lu_factor(a).
+         * @param b (..., n) or (..., n, k) right-hand sides.
+         * @return New array of b's shape.
+         */
+        template<typename T>
+        ND_ARRAY<T> lu_solve(const LuResult<T>& factors, const ND_ARRAY<T>& b)
+        {
+            NUMC_TRACE_SCOPE("lu_solve", "linalg");
+            Detail::require_float<T>();
+
+            const size_t batch = Detail::matrix_batch(factors.lu, true);
+            const size_t k = Detail::rhs_columns(factors.lu, b);
+            const size_t n = factors.lu.shape().back();
+            const T* lu = factors.lu.data();
+            const size_t* piv = factors.pivots.data();
+            ND_ARRAY<T> result = Detail::dense_copy(b);
+            T* x = result.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    Detail::lu_solve_matrix(
+                        lu + i * n * n, piv + i * n, n, x + i * n * k, k);
+                });
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                (factors.lu.size() + 2 * result.size()) * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Solves a x = b, or a stack of such systems, through LU
+         * with partial pivoting.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a (..., n, n) matrices.
+         * @param b (..., n) or (..., n, k) right-hand sides.
+         * @return New array of b's shape.
+         */
+        template<typename T>
+        ND_ARRAY<T> solve(const ND_ARRAY<T>& a, const ND_ARRAY<T>& b)
+        {
+            NUMC_TRACE_SCOPE("solve", "linalg");
+
+            Detail::rhs_columns(a, b);
+
+            return lu_solve(lu_factor(a), b);
+        }
+
+        /**
+         * @brief Inverse of a matrix, or of each matrix of a stack.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a (..., n, n) matrices.
+         * @return New array of a's shape.
+         */
+        template<typename T>
+        ND_ARRAY<T> inv(const ND_ARRAY<T>& a)
+        {
+            NUMC_TRACE_SCOPE("inv", "linalg");
+
+            const auto factors = lu_factor(a);
+            const size_t batch = Detail::matrix_batch(a, true);
+            const size_t n = a.shape().back();
+            const T* lu = factors.lu.data();
+            const size_t* piv = factors.pivots.data();
+            ND_ARRAY<T> result(a.shape(), Core::ArrayInit::Zeros);
+            T* x = result.data();
+
+            Utils::parallel_for(
+                batch,
+                [&](size_t i)
+                {
+                    T* xi = x + i * n * n;
+
+                    for (size_t d = 0; d < n; ++d)
+                        xi[d * n + d] = T(1);
+
+                    Detail::lu_solve_matrix(
+                        lu + i * n * n, piv + i * n, n, xi, n);
+                });
+
+            NUMC_TRACE_INFO(
+                a.size(), 3 * a.size() * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Determinant of a matrix, or of each matrix of a stack,
+         * from its LU factors.
+         *
+         * @tparam T Array element data type, float32 or float64.
+         * @param a (..., n, n) matrices.
+         * @return New array of the leading axes' shape, {1} for a single
+         * matrix.
+         */
+        template<typename T>
+        ND_ARRAY<T> det(const ND_ARRAY<T>& a)
+        {
+            NUMC_TRACE_SCOPE("det", "linalg");
+
+            const auto factors = lu_factor(a);
+            const size_t batch = Detail::matrix_batch(a, true);
+            const size_t n = a.shape().back();
+            const T* lu = factors.lu.data();
+            const size_t* piv = factors.pivots.data();
+            shape_t shape = a.shape();
+
+            shape.pop_back();
+            shape.pop_back();
+
+            if (shape.size() == 0)
+                shape.push_back(1);
+
+            ND_ARRAY<T> result(shape);
+            T* out = result.data();
+
+            for (size_t i = 0; i < batch; ++i)
+            {
+                T value = T(1);
+
+                for (size_t d = 0; d < n; ++d)
+                {
+                    value *= lu[(i * n + d) * n + d];
+
+                    if (piv[i * n + d] != d)
+                        value = -value;
+                }
+
+                out[i] = value;
+            }
+
+            NUMC_TRACE_INFO(
+                result.size(), a.size() * sizeof(T),
+                Core::trace_describe(result));
+
+            return result;
+        }
+    }
+}
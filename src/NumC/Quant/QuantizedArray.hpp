@@ -0,0 +1,831 @@
+#pragma once
+
+#define QUANTIZED_ARRAY NumC::Quant::QuantizedArray
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/View/View.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Quant
+    {
+        /// @brief How the quantization parameters are picked.
+        enum class QuantScheme
+        {
+            /// @brief Maps [min, max] onto the full integer range, with a
+            /// zero point.
+            Affine,
+
+            /// @brief Maps [-max|x|, max|x|] onto [-127, 127] around a fixed
+            /// zero point (0 for int8, 128 for uint8).
+            Symmetric
+        };
+
+        namespace Detail
+        {
+            /// @brief Elements processed per parallel task.
+            const size_t QUANT_GRAIN = size_t(1) << 16;
+
+            /**
+             * @brief Gets an array's elements as a contiguous array. Arrays
+             * are shared, views are copied.
+             *
+             * @tparam T Element data type.
+             * @param array Reference to the array or view.
+             * @return Contiguous array.
+             */
+            template<typename T>
+            ND_ARRAY<T> contiguous(const ND_ARRAY<T>& array)
+            {
+                if (dynamic_cast<const VIEW<T>*>(&array) == nullptr)
+                    return array;
+
+                return array.copy();
+            }
+
+            /**
+             * @brief Quantizes n values sharing one scale and zero point:
+             * q = clamp(round(x / scale) + zero_point), rounding half to
+             * even. NaNs become the lowest integer.
+             *
+             * @tparam Q Quantized type, int8 or uint8.
+             * @param in Input buffer.
+             * @param out Output buffer.
+             * @param n Number of elements.
+             * @param scale Scale.
+             * @param zero_point Zero point.
+             */
+            template<typename Q>
+            void quantize_run(
+                const float32* in,
+                Q* out,
+                size_t n,
+                float32 scale,
+                int32 zero_point)
+            {
+                const float32 inv = 1.0f / scale;
+                const float32 lo =
+                    float32(std::numeric_limits<Q>::min() - zero_point);
+                const float32 hi =
+                    float32(std::numeric_limits<Q>::max() - zero_point);
+                size_t i = 0;
+
+#if defined(__SSE2__)
+                const __m128 v_inv = _mm_set1_ps(inv);
+                const __m128 v_lo = _mm_set1_ps(lo);
+                const __m128 v_hi = _mm_set1_ps(hi);
+                const __m128i v_zp = _mm_set1_epi32(zero_point);
+
+                // Clamped first, so the conversions and packs are exact.
+                auto quantize4 = [&](const float32* p) -> __m128i
+                {
+                    __m128 v = _mm_mul_ps(_mm_loadu_ps(p), v_inv);
+
+                    v = _mm_min_ps(_mm_max_ps(v, v_lo), v_hi);
+
+                    return _mm_add_epi32(_mm_cvtps_epi32(v), v_zp);
+                };
+
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i lo16 = _mm_packs_epi32(
+                        quantize4(in + i), quantize4(in + i + 4));
+                    __m128i hi16 = _mm_packs_epi32(
+                        quantize4(in + i + 8), quantize4(in + i + 12));
+
+                    _mm_storeu_si128(
+                        (__m128i*)(out + i),
+                        std::is_signed<Q>::value ?
+                            _mm_packs_epi16(lo16, hi16) :
+                            _mm_packus_epi16(lo16, hi16));
+                }
+#endif
+                for (; i < n; ++i)
+                {
+                    float32 v = in[i] * inv;
+
+                    v = v > lo ? v : lo;
+                    v = v < hi ? v : hi;
+
+                    out[i] = Q(int32(std::nearbyint(v)) + zero_point);
+                }
+            }
+
+            /**
+             * @brief Widens [min, max] to include n values. NaNs are
+             * skipped.
+             *
+             * @param in Input buffer.
+             * @param n Number of elements.
+             * @param min Range start, updated.
+             * @param max Range end, updated.
+             */
+            inline void widen_range(
+                const float32* in,
+                size_t n,
+                float32& min,
+                float32& max)
+            {
+                size_t i = 0;
+
+#if defined(__SSE2__)
+                // Two accumulators each, to hide the min/max latency. A NaN
+                // input loses as the operands are ordered (x, acc).
+                __m128 min0 = _mm_set1_ps(min), min1 = min0;
+                __m128 max0 = _mm_set1_ps(max), max1 = max0;
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m128 x0 = _mm_loadu_ps(in + i);
+                    __m128 x1 = _mm_loadu_ps(in + i + 4);
+
+                    min0 = _mm_min_ps(x0, min0);
+                    min1 = _mm_min_ps(x1, min1);
+                    max0 = _mm_max_ps(x0, max0);
+                    max1 = _mm_max_ps(x1, max1);
+                }
+
+                float32 lanes[8];
+                _mm_storeu_ps(lanes, _mm_min_ps(min0, min1));
+                _mm_storeu_ps(lanes + 4, _mm_max_ps(max0, max1));
+
+                for (size_t l = 0; l < 4; ++l)
+                {
+                    min = std::min(min, lanes[l]);
+                    max = std::max(max, lanes[4 + l]);
+                }
+#endif
+                for (; i < n; ++i)
+                {
+                    min = std::min(min, in[i]);
+                    max = std::max(max, in[i]);
+                }
+            }
+
+            /**
+             * @brief Runs func(lo, hi, channel) over [0, n) in parallel,
+             * split so that each run [lo, hi) lies within one channel.
+             *
+             * @tparam Func Callable taking a run and its channel.
+             * @param n Number of elements.
+             * @param inner Elements per channel block.
+             * @param channels Number of channels.
+             * @param func Run body.
+             */
+            template<typename Func>
+            void for_channel_runs(
+                size_t n,
+                size_t inner,
+                size_t channels,
+                const Func& func)
+            {
+                Utils::parallel_for(
+                    0,
+                    n,
+                    QUANT_GRAIN,
+                    [&](size_t lo, size_t hi)
+                    {
+                        while (lo < hi)
+                        {
+                            size_t block = lo / inner;
+                            size_t end = std::min(hi, (block + 1) * inner);
+
+                            func(lo, end, block % channels);
+                            lo = end;
+                        }
+                    });
+            }
+        }
+
+        /**
+         * @brief Int8 or uint8 array with affine quantization parameters:
+         * value = (q - zero_point) * scale. The parameters are set for the
+         * whole tensor, or per channel along one axis.
+         *
+         * @tparam Q Quantized type, int8 or uint8.
+         */
+        template<typename Q>
+        class QuantizedArray
+        {
+            static_assert(
+                std::is_same<Q, int8>::value || std::is_same<Q, uint8>::value,
+                "QuantizedArray holds int8 or uint8 values.");
+
+            public:
+                /// Aliases
+                using qtype = Q;
+
+                /**
+                 * @brief Construct a new Quantized Array object from
+                 * quantized values and their parameters.
+                 *
+                 * @param values Quantized values. Arrays are shared, views
+                 * are copied.
+                 * @param scales One scale, or one per channel along axis.
+                 * @param zero_points One zero point per scale.
+                 * @param axis Channel axis. -1 for per-tensor parameters.
+                 */
+                QuantizedArray(
+                    const ND_ARRAY<Q>& values,
+                    std::vector<float32> scales,
+                    std::vector<int32> zero_points,
+                    size_t axis = -1) :
+                    _values(Detail::contiguous(values)),
+                    _scales(std::move(scales)),
+                    _zero_points(std::move(zero_points)),
+                    _axis(axis)
+                {
+                    const shape_t& shape = values.shape();
+
+                    NUMC_CHECK(
+                        !shape.empty(),
+                        Core::ErrorCode::InvalidShape,
+                        "quant - 1: quantized arrays cannot be empty.");
+
+                    NUMC_CHECK(
+                        axis >= -1 && axis < (size_t)shape.size(),
+                        Core::ErrorCode::InvalidAxes,
+                        "quant - 2: channel axis out of range.");
+
+                    const size_t channels = axis < 0 ? 1 : shape[axis];
+
+                    NUMC_CHECK(
+                        (size_t)this->_scales.size() == channels &&
+                            (size_t)this->_zero_points.size() == channels,
+                        Core::ErrorCode::InvalidArgument,
+                        "quant - 3: expected one scale and zero point per "
+                        "channel.");
+
+                    for (size_t c = 0; c < channels; ++c)
+                    {
+                        NUMC_CHECK(
+                            this->_scales[c] > 0 &&
+                                std::isfinite(this->_scales[c]) &&
+                                this->_zero_points[c] >=
+                                    std::numeric_limits<Q>::min() &&
+                                this->_zero_points[c] <=
+                                    std::numeric_limits<Q>::max(),
+                            Core::ErrorCode::InvalidArgument,
+                            "quant - 4: scales must be positive and zero "
+                            "points representable.");
+                    }
+                }
+
+                /**
+                 * @brief Quantizes a float32 array or view. The range of
+                 * each channel is widened to include 0 so that 0 is exact.
+                 *
+                 * @param array Reference to the array to be quantized.
+                 * @param axis Channel axis. -1 for per-tensor parameters.
+                 * @param scheme How the parameters are picked.
+                 * @return New quantized array.
+                 */
+                static QuantizedArray quantize(
+                    const ND_ARRAY<float32>& array,
+                    size_t axis = -1,
+                    QuantScheme scheme = QuantScheme::Affine)
+                {
+                    NUMC_TRACE_SCOPE("quantize", "quant");
+
+                    const shape_t& shape = array.shape();
+
+                    NUMC_CHECK(
+                        axis >= -1 && axis < (size_t)shape.size(),
+                        Core::ErrorCode::InvalidAxes,
+                        "quant - 2: channel axis out of range.");
+
+                    const ND_ARRAY<float32> src = Detail::contiguous(array);
+                    const float32* in = src.data();
+                    const size_t n = src.size();
+                    const size_t channels = axis < 0 ? 1 : shape[axis];
+                    const size_t inner = inner_size(shape, axis);
+
+                    // Per channel ranges.
+                    using range_t = std::vector<std::pair<float32, float32>>;
+
+                    range_t ranges = Utils::parallel_reduce(
+                        0,
+                        n,
+                        Detail::QUANT_GRAIN,
+                        range_t(channels, std::make_pair(0.0f, 0.0f)),
+                        [&](size_t lo, size_t hi)
+                        {
+                            range_t local(
+                                channels, std::make_pair(0.0f, 0.0f));
+
+                            while (lo < hi)
+                            {
+                                size_t block = lo / inner;
+                                size_t end =
+                                    std::min(hi, (block + 1) * inner);
+                                auto& range = local[block % channels];
+
+                                Detail::widen_range(
+                                    in + lo,
+                                    end - lo,
+                                    range.first,
+                                    range.second);
+                                lo = end;
+                            }
+
+                            return local;
+                        },
+                        [](range_t a, const range_t& b)
+                        {
+                            for (size_t c = 0; c < (size_t)a.size(); ++c)
+                            {
+                                a[c].first = std::min(a[c].first, b[c].first);
+                                a[c].second =
+                                    std::max(a[c].second, b[c].second);
+                            }
+
+                            return a;
+                        });
+
+                    std::vector<float32> scales(channels);
+                    std::vector<int32> zero_points(channels);
+
+                    for (size_t c = 0; c < channels; ++c)
+                        choose_params(
+                            ranges[c].first,
+                            ranges[c].second,
+                            scheme,
+                            scales[c],
+                            zero_points[c]);
+
+                    ND_ARRAY<Q> values(shape);
+                    Q* out = values.data();
+
+                    Detail::for_channel_runs(
+                        n,
+                        inner,
+                        channels,
+                        [&](size_t lo, size_t hi, size_t c)
+                        {
+                            Detail::quantize_run(
+                                in + lo,
+                                out + lo,
+                                hi - lo,
+                                scales[c],
+                                zero_points[c]);
+                        });
+
+                    NUMC_TRACE_INFO(
+                        n,
+                        n * (sizeof(float32) + sizeof(Q)),
+                        Core::trace_describe(values));
+
+                    return QuantizedArray(
+                        values,
+                        std::move(scales),
+                        std::move(zero_points),
+                        axis);
+                }
+
+                /**
+                 * @brief Converts back to float32.
+                 *
+                 * @return New float32 array.
+                 */
+                ND_ARRAY<float32> dequantize() const
+                {
+                    NUMC_TRACE_SCOPE("dequantize", "quant");
+
+                    const shape_t& shape = this->shape();
+                    const Q* in = this->_values.data();
+                    ND_ARRAY<float32> result(shape);
+                    float32* out = result.data();
+
+                    Detail::for_channel_runs(
+                        this->size(),
+                        inner_size(shape, this->_axis),
+                        this->_scales.size(),
+                        [&](size_t lo, size_t hi, size_t c)
+                        {
+                            const float32 scale = this->_scales[c];
+                            const int32 zero_point = this->_zero_points[c];
+
+                            for (size_t i = lo; i < hi; ++i)
+                                out[i] =
+                                    float32(int32(in[i]) - zero_point) * scale;
+                        });
+
+                    return result;
+                }
+
+                /**
+                 * @brief Gets the shape of the array.
+                 *
+                 * @return List of dimensions.
+                 */
+                const shape_t& shape() const
+                {
+                    return this->_values.shape();
+                }
+
+                /**
+                 * @brief Gets the total number of elements.
+                 *
+                 * @return Number of elements.
+                 */
+                size_t size() const
+                {
+                    return this->_values.size();
+                }
+
+                /**
+                 * @brief Gets the channel axis.
+                 *
+                 * @return Channel axis, -1 for per-tensor parameters.
+                 */
+                size_t axis() const
+                {
+                    return this->_axis;
+                }
+
+                /**
+                 * @brief Gets the quantized values.
+                 *
+                 * @return Reference to the values array.
+                 */
+                const ND_ARRAY<Q>& values() const
+                {
+                    return this->_values;
+                }
+
+                /**
+                 * @brief Gets the scales.
+                 *
+                 * @return One scale, or one per channel.
+                 */
+                const std::vector<float32>& scales() const
+                {
+                    return this->_scales;
+                }
+
+                /**
+                 * @brief Gets the zero points.
+                 *
+                 * @return One zero point, or one per channel.
+                 */
+                const std::vector<int32>& zero_points() const
+                {
+                    return this->_zero_points;
+                }
+
+            protected:
+
+                /// @brief Quantized values.
+                ND_ARRAY<Q> _values;
+
+                /// @brief Scale per channel.
+                std::vector<float32> _scales;
+
+                /// @brief Zero point per channel.
+                std::vector<int32> _zero_points;
+
+                /// @brief Channel axis, -1 for per-tensor.
+                size_t _axis;
+
+            private:
+
+                /// @brief Elements per channel block: the product of the
+                /// dimensions after axis, or all of them for per-tensor.
+                static size_t inner_size(const shape_t& shape, size_t axis)
+                {
+                    size_t inner = 1;
+
+                    for (size_t i = axis + 1; i < (size_t)shape.size(); ++i)
+                        inner *= shape[i];
+
+                    return inner;
+                }
+
+                /// @brief Picks the scale and zero point of a range.
+                static void choose_params(
+                    float32 min,
+                    float32 max,
+                    QuantScheme scheme,
+                    float32& scale,
+                    int32& zero_point)
+                {
+                    const int32 q_min = std::numeric_limits<Q>::min();
+                    const int32 q_max = std::numeric_limits<Q>::max();
+
+                    if (scheme == QuantScheme::Symmetric)
+                    {
+                        float32 amax = std::max(-min, max);
+
+                        scale = amax / 127.0f;
+                        zero_point = std::is_signed<Q>::value ? 0 : 128;
+                    }
+                    else
+                    {
+                        scale = (max - min) / float32(q_max - q_min);
+                        zero_point = 0;
+
+                        if (scale > 0 && std::isfinite(scale))
+                            zero_point = q_min -
+                                int32(std::nearbyint(min / scale));
+                    }
+
+                    if (!(scale > 0) || !std::isfinite(scale))
+                        scale = 1.0f;
+
+                    zero_point = std::min(std::max(zero_point, q_min), q_max);
+                }
+        };
+
+        namespace Detail
+        {
+            /// @brief Zero point shift turning Q into the kernel's type.
+            template<typename Q>
+            int32 unsigned_shift()
+            {
+                return std::is_signed<Q>::value ? 128 : 0;
+            }
+
+            /**
+             * @brief Raw int8 GEMM, c = a * b, on shifted values: a as uint8
+             * (rows x k, row-major) and b as int8 (k x cols, row-major).
+             * The k x cols block of b is packed once, rows run in parallel.
+             *
+             * @note Uses AVX-512 VNNI dot products (4 products per int32
+             * lane) when compiled in, else AVX2 pmaddwd on int16 widened
+             * values (2 per lane). pmaddubsw is not used since its int16
+             * pair sums saturate for uint8 x int8 inputs. Sums are exact
+             * while k < 66000.
+             *
+             * @param a Shifted lhs values.
+             * @param b Shifted rhs values.
+             * @param c Output, rows x cols.
+             * @param rows Number of rows of a.
+             * @param k Inner dimension.
+             * @param cols Number of columns of b.
+             */
+            inline void gemm_u8s8(
+                const uint8* a,
+                const int8* b,
+                int32* c,
+                size_t rows,
+                size_t k,
+                size_t cols)
+            {
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+                const size_t k_step = 4, lanes = 16;
+                using packed_t = int8;
+#elif defined(__AVX2__)
+                const size_t k_step = 2, lanes = 8;
+                using packed_t = int16;
+#else
+                const size_t k_step = 1, lanes = 1;
+                using packed_t = int32;
+#endif
+                const size_t k_pad = (k + k_step - 1) / k_step * k_step;
+                const size_t c_pad = (cols + lanes - 1) / lanes * lanes;
+
+                // b as [k_pad / k_step][c_pad][k_step], zero padded.
+                std::vector<packed_t> packed(k_pad * c_pad, 0);
+
+                for (size_t p = 0; p < k; ++p)
+                    for (size_t j = 0; j < cols; ++j)
+                        packed[(p / k_step * c_pad + j) * k_step +
+                            p % k_step] = packed_t(b[p * cols + j]);
+
+                const packed_t* bp = packed.data();
+
+                Utils::parallel_for(
+                    rows,
+                    [&](size_t i)
+                    {
+                        // Row of a widened and zero padded to k_pad.
+                        std::vector<packed_t> row(k_pad, 0);
+                        int32* out = c + i * cols;
+                        int32 acc[lanes];
+
+                        for (size_t p = 0; p < k; ++p)
+                            row[p] = packed_t(a[i * k + p]);
+
+                        for (size_t j = 0; j < c_pad; j += lanes)
+                        {
+                            const packed_t* panel = bp + j * k_step;
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+                            __m512i sum = _mm512_setzero_si512();
+
+                            for (size_t p = 0; p < k_pad; p += 4)
+                            {
+                                int32 quad;
+                                std::memcpy(&quad, row.data() + p, 4);
+
+                                // Row bytes are stored as int8 but hold
+                                // the uint8 values bit for bit.
+                                sum = _mm512_dpbusd_epi32(
+                                    sum,
+                                    _mm512_set1_epi32(quad),
+                                    _mm512_loadu_si512(
+                                        panel + p / 4 * c_pad * 4));
+                            }
+
+                            _mm512_storeu_si512(acc, sum);
+#elif defined(__AVX2__)
+                            __m256i sum = _mm256_setzero_si256();
+
+                            for (size_t p = 0; p < k_pad; p += 2)
+                            {
+                                int32 pair;
+                                std::memcpy(&pair, row.data() + p, 4);
+
+                                sum = _mm256_add_epi32(
+                                    sum,
+                                    _mm256_madd_epi16(
+                                        _mm256_set1_epi32(pair),
+                                        _mm256_loadu_si256(
+                                            (const __m256i*)(panel +
+                                                p / 2 * c_pad * 2))));
+                            }
+
+                            _mm256_storeu_si256((__m256i*)acc, sum);
+#else
+                            acc[0] = 0;
+
+                            for (size_t p = 0; p < k_pad; ++p)
+                                acc[0] += row[p] * panel[p * c_pad];
+#endif
+                            size_t n = std::min(lanes, cols - j);
+
+                            std::copy(acc, acc + n, out + j);
+                        }
+                    });
+            }
+
+            /**
+             * @brief Checks the operands of a quantized matmul.
+             *
+             * @param a_shape Lhs shape.
+             * @param a_axis Lhs channel axis.
+             * @param b_shape Rhs shape.
+             * @param b_axis Rhs channel axis.
+             */
+            inline void validate_matmul(
+                const shape_t& a_shape,
+                size_t a_axis,
+                const shape_t& b_shape,
+                size_t b_axis)
+            {
+                NUMC_CHECK(
+                    a_shape.size() == 2 && b_shape.size() == 2 &&
+                        a_shape[1] == b_shape[0],
+                    Core::ErrorCode::BroadcastError,
+                    "quant - 5: matmul needs 2-D arrays with matching inner "
+                    "dimensions.");
+
+                NUMC_CHECK(
+                    (a_axis == -1 || a_axis == 0) &&
+                        (b_axis == -1 || b_axis == 1),
+                    Core::ErrorCode::Unsupported,
+                    "quant - 6: matmul needs per-tensor or per-row lhs and "
+                    "per-tensor or per-column rhs parameters.");
+            }
+        }
+
+        /**
+         * @brief Quantized matrix product accumulated in int32:
+         * c[i][j] = sum_p (a[i][p] - za[i]) * (b[p][j] - zb[j]).
+         *
+         * @note int8 lhs values are shifted to uint8 and uint8 rhs values to
+         * int8 to fit the u8 x s8 kernel; the zero points absorb the shift.
+         *
+         * @tparam QA Lhs quantized type.
+         * @tparam QB Rhs quantized type.
+         * @param a Lhs (rows, k), per-tensor or per-row (axis 0).
+         * @param b Rhs (k, cols), per-tensor or per-column (axis 1).
+         * @return New (rows, cols) int32 array.
+         */
+        template<typename QA, typename QB>
+        ND_ARRAY<int32> matmul_int32(
+            const QuantizedArray<QA>& a,
+            const QuantizedArray<QB>& b)
+        {
+            NUMC_TRACE_SCOPE("qmatmul", "quant");
+
+            Detail::validate_matmul(a.shape(), a.axis(), b.shape(), b.axis());
+
+            const size_t rows = a.shape()[0];
+            const size_t k = a.shape()[1];
+            const size_t cols = b.shape()[1];
+            const int32 a_shift = Detail::unsigned_shift<QA>();
+            const int32 b_shift = 128 - Detail::unsigned_shift<QB>();
+
+            // Shifted copies: a as uint8, b as int8.
+            std::vector<uint8> a_u(rows * k);
+            std::vector<int8> b_s(k * cols);
+            const QA* a_in = a.values().data();
+            const QB* b_in = b.values().data();
+
+            // Row sums of a and column sums of b for the zero point
+            // corrections.
+            std::vector<int32> row_sums(rows, 0), col_sums(cols, 0);
+
+            Utils::parallel_for(
+                rows,
+                [&](size_t i)
+                {
+                    for (size_t p = i * k; p < (i + 1) * k; ++p)
+                    {
+                        a_u[p] = uint8(int32(a_in[p]) + a_shift);
+                        row_sums[i] += a_u[p];
+                    }
+                });
+
+            for (size_t p = 0; p < k; ++p)
+            {
+                for (size_t j = 0; j < cols; ++j)
+                {
+                    b_s[p * cols + j] =
+                        int8(int32(b_in[p * cols + j]) - b_shift);
+                    col_sums[j] += b_s[p * cols + j];
+                }
+            }
+
+            ND_ARRAY<int32> result(shape_t({rows, cols}));
+            int32* c = result.data();
+
+            Detail::gemm_u8s8(a_u.data(), b_s.data(), c, rows, k, cols);
+
+            Utils::parallel_for(
+                rows,
+                [&](size_t i)
+                {
+                    const int32 za = a.zero_points()[
+                        a.axis() < 0 ? 0 : i] + a_shift;
+
+                    for (size_t j = 0; j < cols; ++j)
+                    {
+                        const int32 zb = b.zero_points()[
+                            b.axis() < 0 ? 0 : j] - b_shift;
+
+                        c[i * cols + j] += -zb * row_sums[i] -
+                            za * col_sums[j] + int32(k) * za * zb;
+                    }
+                });
+
+            NUMC_TRACE_INFO(
+                rows * cols,
+                rows * k + k * cols + rows * cols * sizeof(int32),
+                Core::trace_describe(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Quantized matrix product, dequantized to float32:
+         * c[i][j] = sa[i] * sb[j] * matmul_int32(a, b)[i][j].
+         *
+         * @tparam QA Lhs quantized type.
+         * @tparam QB Rhs quantized type.
+         * @param a Lhs (rows, k), per-tensor or per-row (axis 0).
+         * @param b Rhs (k, cols), per-tensor or per-column (axis 1).
+         * @return New (rows, cols) float32 array.
+         */
+        template<typename QA, typename QB>
+        ND_ARRAY<float32> matmul(
+            const QuantizedArray<QA>& a,
+            const QuantizedArray<QB>& b)
+        {
+            const ND_ARRAY<int32> acc = matmul_int32(a, b);
+            const int32* in = acc.data();
+            const size_t rows = acc.shape()[0];
+            const size_t cols = acc.shape()[1];
+            ND_ARRAY<float32> result(acc.shape());
+            float32* out = result.data();
+
+            Utils::parallel_for(
+                rows,
+                [&](size_t i)
+                {
+                    const float32 sa = a.scales()[a.axis() < 0 ? 0 : i];
+
+                    for (size_t j = 0; j < cols; ++j)
+                        out[i * cols + j] = float32(in[i * cols + j]) * sa *
+                            b.scales()[b.axis() < 0 ? 0 : j];
+                });
+
+            return result;
+        }
+    }
+}
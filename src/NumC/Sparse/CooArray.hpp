@@ -0,0 +1,198 @@
+#pragma once
+
+#define COO_ARRAY NumC::Sparse::CooArray
+
+#include <NumC/Core/NdArray.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace NumC
+{
+    namespace Sparse
+    {
+        /**
+         * @brief Validates a sparse array shape.
+         *
+         * @param shape Shape to be validated.
+         */
+        inline void validate_sparse_shape(const shape_t& shape)
+        {
+            NUMC_CHECK(
+                shape.size() == 2 && shape[0] > 0 && shape[1] > 0,
+                Core::ErrorCode::InvalidShape,
+                "sp - 1: sparse arrays must be 2-D with positive dims.");
+        }
+
+        /**
+         * @brief Sparse 2-D array in coordinate (COO) format: parallel lists
+         * of row indices, column indices and values. Cheap to build
+         * incrementally. Convert to CsrArray for arithmetic.
+         *
+         * @note Duplicate entries are allowed and add up.
+         *
+         * @tparam T The data type to be stored.
+         */
+        template<typename T>
+        class CooArray
+        {
+            public:
+                /// Aliases
+                using dtype = T;
+
+                /**
+                 * @brief Construct a new empty Coo Array object.
+                 *
+                 * @param shape Shape (rows, cols) of the array.
+                 */
+                CooArray(const shape_t& shape) :
+                    _shape(shape)
+                {
+                    validate_sparse_shape(shape);
+                }
+
+                /**
+                 * @brief Construct a new Coo Array object from the non-zero
+                 * elements of a dense 2-D array or view.
+                 *
+                 * @param dense Reference to the dense array.
+                 */
+                explicit CooArray(const ND_ARRAY<T>& dense) :
+                    _shape(dense.shape())
+                {
+                    NUMC_TRACE_SCOPE("coo_from_dense", "sparse");
+
+                    validate_sparse_shape(this->_shape);
+
+                    const size_t cols = this->_shape[1];
+                    size_t i = 0;
+
+                    for (auto it = dense.cbegin(), ite = dense.cend();
+                        it != ite;
+                        ++it, ++i)
+                    {
+                        if (*it != T())
+                            this->push_back(i / cols, i % cols, *it);
+                    }
+                }
+
+                /**
+                 * @brief Appends an entry.
+                 *
+                 * @param row Row index.
+                 * @param col Column index.
+                 * @param value Value of the entry.
+                 */
+                void push_back(size_t row, size_t col, dtype value)
+                {
+                    NUMC_CHECK(
+                        row >= 0 && row < this->_shape[0] &&
+                            col >= 0 && col < this->_shape[1],
+                        Core::ErrorCode::IndexOutOfBounds,
+                        "sp - 2: entry index out of bounds.");
+
+                    this->_rows.push_back(row);
+                    this->_cols.push_back(col);
+                    this->_values.push_back(value);
+                }
+
+                /**
+                 * @brief Reserves room for a number of entries.
+                 *
+                 * @param nnz Expected number of entries.
+                 */
+                void reserve(size_t nnz)
+                {
+                    this->_rows.reserve(nnz);
+                    this->_cols.reserve(nnz);
+                    this->_values.reserve(nnz);
+                }
+
+                /**
+                 * @brief Converts to a dense array. Duplicates add up.
+                 *
+                 * @return New dense array.
+                 */
+                ND_ARRAY<T> to_dense() const
+                {
+                    NUMC_TRACE_SCOPE("coo_to_dense", "sparse");
+
+                    ND_ARRAY<T> dense(this->_shape);
+                    T* data = dense.data();
+                    const size_t cols = this->_shape[1];
+
+                    std::fill(data, data + dense.size(), T());
+
+                    for (size_t k = 0; k < this->nnz(); ++k)
+                        data[this->_rows[k] * cols + this->_cols[k]] +=
+                            this->_values[k];
+
+                    return dense;
+                }
+
+                /**
+                 * @brief Gets the shape of the array.
+                 *
+                 * @return Reference to the shape (rows, cols).
+                 */
+                const shape_t& shape() const
+                {
+                    return this->_shape;
+                }
+
+                /**
+                 * @brief Gets the number of stored entries.
+                 *
+                 * @return Number of entries, duplicates included.
+                 */
+                size_t nnz() const
+                {
+                    return this->_values.size();
+                }
+
+                /**
+                 * @brief Gets the row indices of the entries.
+                 *
+                 * @return Reference to the row index list.
+                 */
+                const std::vector<size_t>& rows() const
+                {
+                    return this->_rows;
+                }
+
+                /**
+                 * @brief Gets the column indices of the entries.
+                 *
+                 * @return Reference to the column index list.
+                 */
+                const std::vector<size_t>& cols() const
+                {
+                    return this->_cols;
+                }
+
+                /**
+                 * @brief Gets the entry values.
+                 *
+                 * @return Reference to the value list.
+                 */
+                const std::vector<T>& values() const
+                {
+                    return this->_values;
+                }
+
+            protected:
+
+                /// @brief Shape (rows, cols).
+                shape_t _shape;
+
+                /// @brief Row index of each entry.
+                std::vector<size_t> _rows;
+
+                /// @brief Column index of each entry.
+                std::vector<size_t> _cols;
+
+                /// @brief Value of each entry.
+                std::vector<T> _values;
+        };
+    }
+}
@@ -0,0 +1,761 @@
+#pragma once
+
+#define CSR_ARRAY NumC::Sparse::CsrArray
+
+#include <NumC/Sparse/CooArray.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace NumC
+{
+    namespace Sparse
+    {
+        /**
+         * @brief Sparse 2-D array in compressed sparse row (CSR) format.
+         * Row r holds the entries indptr[r] .. indptr[r + 1] - 1 of the
+         * indices (columns, sorted and unique per row) and data lists.
+         *
+         * @note Products and element-wise operations run in parallel over
+         * row blocks holding about the same number of entries.
+         *
+         * @tparam T The data type to be stored.
+         */
+        template<typename T>
+        class CsrArray
+        {
+            public:
+                /// Aliases
+                using dtype = T;
+
+                /**
+                 * @brief Construct a new empty Csr Array object.
+                 *
+                 * @param shape Shape (rows, cols) of the array.
+                 */
+                CsrArray(const shape_t& shape) :
+                    _shape(shape)
+                {
+                    validate_sparse_shape(shape);
+                    this->_indptr.assign(shape[0] + 1, 0);
+                }
+
+                /**
+                 * @brief Construct a new Csr Array object from raw CSR lists.
+                 *
+                 * @param shape Shape (rows, cols) of the array.
+                 * @param indptr Row pointers, rows + 1 entries.
+                 * @param indices Column index of each entry.
+                 * @param data Value of each entry.
+                 */
+                CsrArray(
+                    const shape_t& shape,
+                    std::vector<size_t> indptr,
+                    std::vector<size_t> indices,
+                    std::vector<T> data) :
+                    _shape(shape),
+                    _indptr(std::move(indptr)),
+                    _indices(std::move(indices)),
+                    _data(std::move(data))
+                {
+                    validate_sparse_shape(shape);
+
+                    const size_t rows = shape[0], cols = shape[1];
+                    const size_t nnz = this->_data.size();
+
+                    NUMC_CHECK(
+                        (size_t)this->_indptr.size() == rows + 1 &&
+                            (size_t)this->_indices.size() == nnz &&
+                            this->_indptr[0] == 0 &&
+                            this->_indptr[rows] == nnz,
+                        Core::ErrorCode::InvalidArgument,
+                        "sp - 3: inconsistent CSR list sizes.");
+
+                    for (size_t r = 0; r < rows; ++r)
+                    {
+                        NUMC_CHECK(
+                            this->_indptr[r] <= this->_indptr[r + 1],
+                            Core::ErrorCode::InvalidArgument,
+                            "sp - 4: row pointers must not decrease.");
+
+                        for (size_t k = this->_indptr[r];
+                            k < this->_indptr[r + 1];
+                            ++k)
+                        {
+                            NUMC_CHECK(
+                                this->_indices[k] >= 0 &&
+                                    this->_indices[k] < cols &&
+                                    (k == this->_indptr[r] ||
+                                        this->_indices[k - 1] <
+                                            this->_indices[k]),
+                                Core::ErrorCode::InvalidArgument,
+                                "sp - 5: column indices must be in bounds, "
+                                "sorted and unique per row.");
+                        }
+                    }
+                }
+
+                /**
+                 * @brief Construct a new Csr Array object from a COO array.
+                 * Entries are sorted and duplicates added up.
+                 *
+                 * @param coo Reference to the COO array.
+                 */
+                explicit CsrArray(const CooArray<T>& coo) :
+                    _shape(coo.shape())
+                {
+                    NUMC_TRACE_SCOPE("csr_from_coo", "sparse");
+
+                    const size_t rows = this->_shape[0];
+                    const size_t nnz = coo.nnz();
+                    const auto& coo_rows = coo.rows();
+                    const auto& coo_cols = coo.cols();
+                    const auto& coo_values = coo.values();
+
+                    // Counting sort by row.
+                    std::vector<size_t> start(rows + 1, 0);
+                    for (size_t k = 0; k < nnz; ++k)
+                        ++start[coo_rows[k] + 1];
+                    std::partial_sum(start.begin(), start.end(), start.begin());
+
+                    std::vector<size_t> order(nnz);
+                    std::vector<size_t> fill(start.begin(), start.end() - 1);
+                    for (size_t k = 0; k < nnz; ++k)
+                        order[fill[coo_rows[k]]++] = k;
+
+                    // Sort each row by column and merge duplicates.
+                    this->_indptr.assign(rows + 1, 0);
+                    this->_indices.reserve(nnz);
+                    this->_data.reserve(nnz);
+
+                    for (size_t r = 0; r < rows; ++r)
+                    {
+                        std::sort(
+                            order.begin() + start[r],
+                            order.begin() + start[r + 1],
+                            [&](size_t a, size_t b)
+                            {
+                                return coo_cols[a] < coo_cols[b];
+                            });
+
+                        for (size_t i = start[r]; i < start[r + 1]; ++i)
+                        {
+                            size_t k = order[i];
+
+                            if ((size_t)this->_indices.size() >
+                                    this->_indptr[r] &&
+                                this->_indices.back() == coo_cols[k])
+                            {
+                                this->_data.back() += coo_values[k];
+                                continue;
+                            }
+
+                            this->_indices.push_back(coo_cols[k]);
+                            this->_data.push_back(coo_values[k]);
+                        }
+
+                        this->_indptr[r + 1] = this->_indices.size();
+                    }
+
+                    NUMC_TRACE_INFO(
+                        nnz,
+                        nnz * (2 * sizeof(size_t) + sizeof(T)),
+                        "csr(" + std::to_string(rows) + ", " +
+                            std::to_string(this->_shape[1]) + ")");
+                }
+
+                /**
+                 * @brief Construct a new Csr Array object from the non-zero
+                 * elements of a dense 2-D array or view.
+                 *
+                 * @param dense Reference to the dense array.
+                 */
+                explicit CsrArray(const ND_ARRAY<T>& dense) :
+                    _shape(dense.shape())
+                {
+                    NUMC_TRACE_SCOPE("csr_from_dense", "sparse");
+
+                    validate_sparse_shape(this->_shape);
+
+                    const size_t cols = this->_shape[1];
+                    size_t i = 0;
+
+                    this->_indptr.assign(this->_shape[0] + 1, 0);
+
+                    for (auto it = dense.cbegin(), ite = dense.cend();
+                        it != ite;
+                        ++it, ++i)
+                    {
+                        if (*it != T())
+                        {
+                            this->_indices.push_back(i % cols);
+                            this->_data.push_back(*it);
+                        }
+
+                        if (i % cols == cols - 1)
+                            this->_indptr[i / cols + 1] = this->_data.size();
+                    }
+
+                    NUMC_TRACE_INFO(
+                        dense.size(),
+                        dense.size() * sizeof(T),
+                        Core::trace_describe(dense));
+                }
+
+                /**
+                 * @brief Converts to a dense array.
+                 *
+                 * @return New dense array.
+                 */
+                ND_ARRAY<T> to_dense() const
+                {
+                    NUMC_TRACE_SCOPE("csr_to_dense", "sparse");
+
+                    ND_ARRAY<T> dense(this->_shape);
+                    T* out = dense.data();
+                    const size_t cols = this->_shape[1];
+
+                    this->__for_row_blocks(
+                        [&](size_t first, size_t last)
+                        {
+                            std::fill(
+                                out + first * cols, out + last * cols, T());
+
+                            for (size_t r = first; r < last; ++r)
+                                for (size_t k = this->_indptr[r];
+                                    k < this->_indptr[r + 1];
+                                    ++k)
+                                    out[r * cols + this->_indices[k]] =
+                                        this->_data[k];
+                        });
+
+                    NUMC_TRACE_INFO(
+                        dense.size(),
+                        dense.size() * sizeof(T),
+                        Core::trace_describe(dense));
+
+                    return dense;
+                }
+
+                /**
+                 * @brief Converts to COO format.
+                 *
+                 * @return New COO array.
+                 */
+                CooArray<T> to_coo() const
+                {
+                    CooArray<T> coo(this->_shape);
+                    coo.reserve(this->nnz());
+
+                    for (size_t r = 0; r < this->_shape[0]; ++r)
+                        for (size_t k = this->_indptr[r];
+                            k < this->_indptr[r + 1];
+                            ++k)
+                            coo.push_back(r, this->_indices[k], this->_data[k]);
+
+                    return coo;
+                }
+
+                /**
+                 * @brief Gets an element. Looks the column up with a binary
+                 * search in the row.
+                 *
+                 * @param row Row index.
+                 * @param col Column index.
+                 * @return Value of the element, 0 if it is not stored.
+                 */
+                dtype get(size_t row, size_t col) const
+                {
+                    NUMC_ASSERT(
+                        row >= 0 && row < this->_shape[0] &&
+                            col >= 0 && col < this->_shape[1],
+                        Core::ErrorCode::IndexOutOfBounds,
+                        "sp - 2: entry index out of bounds.");
+
+                    auto first = this->_indices.begin() + this->_indptr[row];
+                    auto last = this->_indices.begin() + this->_indptr[row + 1];
+                    auto it = std::lower_bound(first, last, col);
+
+                    if (it == last || *it != col)
+                        return T();
+
+                    return this->_data[it - this->_indices.begin()];
+                }
+
+                /**
+                 * @brief Sparse matrix-vector product (SpMV).
+                 *
+                 * @param x Dense 1-D array (or view) of cols elements.
+                 * @return New 1-D array of rows elements.
+                 */
+                ND_ARRAY<T> dot_vector(const ND_ARRAY<T>& x) const
+                {
+                    NUMC_TRACE_SCOPE("spmv", "sparse");
+
+                    const size_t rows = this->_shape[0];
+
+                    NUMC_CHECK(
+                        x.shape().size() == 1 &&
+                            x.shape()[0] == this->_shape[1],
+                        Core::ErrorCode::BroadcastError,
+                        "sp - 6: SpMV vector length must match the columns.");
+
+                    ND_ARRAY<T> scratch;
+                    const T* xs = contiguous(x, scratch);
+                    ND_ARRAY<T> result(shape_t({rows}));
+                    T* out = result.data();
+
+                    this->__for_row_blocks(
+                        [&](size_t first, size_t last)
+                        {
+                            for (size_t r = first; r < last; ++r)
+                            {
+                                T sum = T();
+
+                                for (size_t k = this->_indptr[r];
+                                    k < this->_indptr[r + 1];
+                                    ++k)
+                                    sum += this->_data[k] *
+                                        xs[this->_indices[k]];
+
+                                out[r] = sum;
+                            }
+                        });
+
+                    NUMC_TRACE_INFO(
+                        this->nnz(),
+                        this->nnz() * (sizeof(size_t) + 2 * sizeof(T)),
+                        Core::trace_describe(x));
+
+                    return result;
+                }
+
+                /**
+                 * @brief Sparse x dense matrix product.
+                 *
+                 * @param rhs Dense 2-D array (or view) of shape (cols, K).
+                 * @return New dense (rows, K) array.
+                 */
+                ND_ARRAY<T> dot_matrix(const ND_ARRAY<T>& rhs) const
+                {
+                    NUMC_TRACE_SCOPE("spmm", "sparse");
+
+                    NUMC_CHECK(
+                        rhs.shape().size() == 2 &&
+                            rhs.shape()[0] == this->_shape[1],
+                        Core::ErrorCode::BroadcastError,
+                        "sp - 7: matmul inner dimensions must match.");
+
+                    const size_t rows = this->_shape[0];
+                    const size_t k_cols = rhs.shape()[1];
+
+                    ND_ARRAY<T> scratch;
+                    const T* b = contiguous(rhs, scratch);
+                    ND_ARRAY<T> result(shape_t({rows, k_cols}));
+                    T* out = result.data();
+
+                    this->__for_row_blocks(
+                        [&](size_t first, size_t last)
+                        {
+                            std::fill(
+                                out + first * k_cols,
+                                out + last * k_cols,
+                                T());
+
+                            for (size_t r = first; r < last; ++r)
+                            {
+                                T* c = out + r * k_cols;
+
+                                for (size_t k = this->_indptr[r];
+                                    k < this->_indptr[r + 1];
+                                    ++k)
+                                {
+                                    const T value = this->_data[k];
+                                    const T* row =
+                                        b + this->_indices[k] * k_cols;
+
+                                    for (size_t j = 0; j < k_cols; ++j)
+                                        c[j] += value * row[j];
+                                }
+                            }
+                        },
+                        k_cols);
+
+                    NUMC_TRACE_INFO(
+                        this->nnz() * k_cols,
+                        (this->nnz() + rows) * k_cols * sizeof(T),
+                        Core::trace_describe(rhs));
+
+                    return result;
+                }
+
+                /**
+                 * @brief Product with a dense array: SpMV for a 1-D rhs,
+                 * sparse x dense matmul for a 2-D rhs.
+                 *
+                 * @param rhs Dense array (or view).
+                 * @return New dense array.
+                 */
+                ND_ARRAY<T> dot(const ND_ARRAY<T>& rhs) const
+                {
+                    return rhs.shape().size() == 1 ?
+                        this->dot_vector(rhs) :
+                        this->dot_matrix(rhs);
+                }
+
+                /**
+                 * @brief Element-wise multiplication with a dense array of
+                 * the same shape. Keeps the sparsity pattern.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Dense array (or view).
+                 * @return New sparse array.
+                 */
+                template<typename rhs_t>
+                CsrArray<T> operator*(const ND_ARRAY<rhs_t>& rhs) const
+                {
+                    this->__validate_same_shape(rhs);
+
+                    CsrArray<T> result(*this);
+                    const size_t cols = this->_shape[1];
+                    ND_ARRAY<rhs_t> scratch;
+                    const rhs_t* b = contiguous(rhs, scratch);
+
+                    this->__for_row_blocks(
+                        [&](size_t first, size_t last)
+                        {
+                            for (size_t r = first; r < last; ++r)
+                                for (size_t k = this->_indptr[r];
+                                    k < this->_indptr[r + 1];
+                                    ++k)
+                                    result._data[k] *=
+                                        b[r * cols + this->_indices[k]];
+                        });
+
+                    return result;
+                }
+
+                /**
+                 * @brief Element-wise addition of a dense array of the same
+                 * shape.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Dense array (or view).
+                 * @return New dense array.
+                 */
+                template<typename rhs_t>
+                ND_ARRAY<T> operator+(const ND_ARRAY<rhs_t>& rhs) const
+                {
+                    return this->__dense_op(
+                        rhs, [](T x, rhs_t y) -> T { return x + y; }, "add");
+                }
+
+                /**
+                 * @brief Element-wise subtraction of a dense array of the
+                 * same shape.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Dense array (or view).
+                 * @return New dense array.
+                 */
+                template<typename rhs_t>
+                ND_ARRAY<T> operator-(const ND_ARRAY<rhs_t>& rhs) const
+                {
+                    return this->__dense_op(
+                        rhs,
+                        [](T x, rhs_t y) -> T { return x - y; },
+                        "subtract");
+                }
+
+                /**
+                 * @brief Multiplication by a scalar.
+                 *
+                 * @param rhs Scalar value.
+                 * @return New sparse array.
+                 */
+                CsrArray<T> operator*(float64 rhs) const
+                {
+                    CsrArray<T> result(*this);
+
+                    for (auto& value : result._data)
+                        value = value * rhs;
+
+                    return result;
+                }
+
+                /**
+                 * @brief Division by a scalar.
+                 *
+                 * @param rhs Scalar value.
+                 * @return New sparse array.
+                 */
+                CsrArray<T> operator/(float64 rhs) const
+                {
+                    CsrArray<T> result(*this);
+
+                    for (auto& value : result._data)
+                        value = value / rhs;
+
+                    return result;
+                }
+
+                /**
+                 * @brief Gets the shape of the array.
+                 *
+                 * @return Reference to the shape (rows, cols).
+                 */
+                const shape_t& shape() const
+                {
+                    return this->_shape;
+                }
+
+                /**
+                 * @brief Gets the number of stored entries.
+                 *
+                 * @return Number of entries.
+                 */
+                size_t nnz() const
+                {
+                    return this->_data.size();
+                }
+
+                /**
+                 * @brief Gets the row pointers.
+                 *
+                 * @return Reference to the rows + 1 row pointers.
+                 */
+                const std::vector<size_t>& indptr() const
+                {
+                    return this->_indptr;
+                }
+
+                /**
+                 * @brief Gets the column index of each entry.
+                 *
+                 * @return Reference to the column index list.
+                 */
+                const std::vector<size_t>& indices() const
+                {
+                    return this->_indices;
+                }
+
+                /**
+                 * @brief Gets the entry values.
+                 *
+                 * @return Reference to the value list.
+                 */
+                const std::vector<T>& data() const
+                {
+                    return this->_data;
+                }
+
+            protected:
+
+                /// @brief Shape (rows, cols).
+                shape_t _shape;
+
+                /// @brief Row pointers.
+                std::vector<size_t> _indptr;
+
+                /// @brief Column index of each entry.
+                std::vector<size_t> _indices;
+
+                /// @brief Value of each entry.
+                std::vector<T> _data;
+
+                /**
+                 * @brief Gets the elements of a dense array or view in row
+                 * major order. Arrays and views laid out that way are read
+                 * in place, other views are gathered with copy() into a
+                 * tracked buffer.
+                 *
+                 * @tparam U Dense element data type.
+                 * @param array Reference to the array.
+                 * @param scratch Holds the gathered copy, if one is made.
+                 * @return Pointer to the elements in row major order.
+                 */
+                template<typename U>
+                static const U* contiguous(
+                    const ND_ARRAY<U>& array,
+                    ND_ARRAY<U>& scratch)
+                {
+                    const U* data = array.memory_data();
+                    const auto& shape = array.shape();
+                    const auto strides = array.memory_strides();
+                    bool dense = data != nullptr;
+                    size_t expected = 1;
+
+                    for (size_t d = shape.size(); dense && d-- > 0;)
+                    {
+                        dense = shape[d] == 1 || strides[d] == expected;
+                        expected *= shape[d];
+                    }
+
+                    if (dense)
+                        return data + array.memory_offset();
+
+                    scratch = array.copy();
+
+                    return scratch.data();
+                }
+
+            private:
+
+                /**
+                 * @brief Runs func(first_row, last_row) over row blocks in
+                 * parallel. Blocks are cut so that each holds about the same
+                 * number of entries plus rows, rows counting row_work
+                 * entries each.
+                 *
+                 * @tparam Func Callable taking a row range.
+                 * @param func Block body.
+                 * @param work_per_entry Relative cost of one entry, used to
+                 * decide if threads are worth starting.
+                 * @param row_work Cost of a row besides its entries, in
+                 * entries, e.g. the columns of a dense row.
+                 */
+                template<typename Func>
+                void __for_row_blocks(
+                    const Func& func,
+                    size_t work_per_entry = 1,
+                    size_t row_work = 1) const
+                {
+                    const size_t rows = this->_shape[0];
+                    const size_t total = this->nnz() + rows * row_work;
+                    const size_t work =
+                        total * std::max<size_t>(1, work_per_entry);
+
+                    // Not worth waking threads for small arrays.
+                    size_t n_blocks = std::min<size_t>(
+                        rows, std::min<size_t>(
+                            4 * Utils::num_threads(), work / 32768 + 1));
+
+                    if (n_blocks <= 1)
+                    {
+                        func(0, rows);
+
+                        return;
+                    }
+
+                    // Block boundaries balanced on indptr[r] + r * row_work.
+                    std::vector<size_t> bounds(n_blocks + 1, rows);
+                    bounds[0] = 0;
+
+                    for (size_t b = 1; b < n_blocks; ++b)
+                    {
+                        size_t target = total * b / n_blocks;
+                        size_t lo = bounds[b - 1], hi = rows;
+
+                        while (lo < hi)
+                        {
+                            size_t mid = lo + (hi - lo) / 2;
+
+                            if (this->_indptr[mid] + mid * row_work < target)
+                                lo = mid + 1;
+                            else
+                                hi = mid;
+                        }
+
+                        bounds[b] = lo;
+                    }
+
+                    Utils::parallel_for(
+                        n_blocks,
+                        [&](size_t b)
+                        {
+                            if (bounds[b] < bounds[b + 1])
+                                func(bounds[b], bounds[b + 1]);
+                        });
+                }
+
+                /**
+                 * @brief Checks that a dense operand has the same shape.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @param rhs Dense array (or view).
+                 */
+                template<typename rhs_t>
+                void __validate_same_shape(const ND_ARRAY<rhs_t>& rhs) const
+                {
+                    NUMC_CHECK(
+                        rhs.shape() == this->_shape,
+                        Core::ErrorCode::BroadcastError,
+                        "sp - 8: element-wise operands must have the same "
+                        "shape.");
+                }
+
+                /**
+                 * @brief Element-wise operation with a dense operand giving
+                 * a dense result: func(0, rhs) where nothing is stored,
+                 * func(value, rhs) at the stored entries.
+                 *
+                 * @tparam rhs_t RHS array element type.
+                 * @tparam Func Callable taking (T, rhs_t).
+                 * @param rhs Dense array (or view).
+                 * @param func Element operation.
+                 * @param op_name Operation name reported to tracing.
+                 * @return New dense array.
+                 */
+                template<typename rhs_t, typename Func>
+                ND_ARRAY<T> __dense_op(
+                    const ND_ARRAY<rhs_t>& rhs,
+                    const Func& func,
+                    const char* op_name) const
+                {
+                    NUMC_TRACE_SCOPE(op_name, "sparse");
+
+                    this->__validate_same_shape(rhs);
+
+                    ND_ARRAY<T> result(this->_shape);
+                    T* out = result.data();
+                    const size_t cols = this->_shape[1];
+                    ND_ARRAY<rhs_t> scratch;
+                    const rhs_t* b = contiguous(rhs, scratch);
+
+                    // Each block fills its dense rows, then overwrites the
+                    // stored entries of the same rows.
+                    this->__for_row_blocks(
+                        [&](size_t first, size_t last)
+                        {
+                            for (size_t i = first * cols; i < last * cols; ++i)
+                                out[i] = func(T(), b[i]);
+
+                            for (size_t r = first; r < last; ++r)
+                                for (size_t k = this->_indptr[r];
+                                    k < this->_indptr[r + 1];
+                                    ++k)
+                                {
+                                    size_t index = r * cols + this->_indices[k];
+                                    out[index] = func(this->_data[k], b[index]);
+                                }
+                        },
+                        1,
+                        cols);
+
+                    NUMC_TRACE_INFO(
+                        result.size(),
+                        2 * result.size() * sizeof(T),
+                        Core::trace_describe(result));
+
+                    return result;
+                }
+        };
+
+        /**
+         * @brief Product of a sparse array and a dense vector or matrix.
+         *
+         * @tparam T Array element data type.
+         * @param lhs Reference to the sparse array.
+         * @param rhs Reference to the dense array (or view).
+         * @return New dense array.
+         */
+        template<typename T>
+        ND_ARRAY<T> matmul(const CsrArray<T>& lhs, const ND_ARRAY<T>& rhs)
+        {
+            return lhs.dot(rhs);
+        }
+    }
+}
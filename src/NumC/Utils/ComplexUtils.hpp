@@ -0,0 +1,139 @@
+#pragma once
+
+#include <NumC/Core/Complex.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Core/View/ComponentView.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <complex>
+
+namespace NumC
+{
+    namespace Utils
+    {
+        namespace Detail
+        {
+            /**
+             * @brief Runs kernel(in, out, lo, hi) over a complex array or
+             * view in parallel chunks. Views are gathered first.
+             *
+             * @tparam T Component type.
+             * @tparam R Result element type.
+             * @tparam Kernel Callable over a contiguous index range.
+             * @param array Reference to the complex array or view.
+             * @param kernel Element kernel.
+             * @return New array of the same shape.
+             */
+            template<typename T, typename R, typename Kernel>
+            ND_ARRAY<R> complex_map(
+                const ND_ARRAY<std::complex<T>>& array,
+                const Kernel& kernel)
+            {
+                ND_ARRAY<std::complex<T>> gathered;
+                const std::complex<T>* in = array.data();
+
+                if (in == nullptr)
+                {
+                    gathered = array.copy();
+                    in = gathered.data();
+                }
+
+                ND_ARRAY<R> result(array.shape());
+                R* out = result.data();
+
+                parallel_for(
+                    0,
+                    array.size(),
+                    Core::Detail::KERNEL_GRAIN,
+                    [&](size_t lo, size_t hi) { kernel(in, out, lo, hi); });
+
+                return result;
+            }
+        }
+
+        /**
+         * @brief Real part of a complex array, as a view that writes through.
+         *
+         * @tparam T Component type.
+         * @param array Reference to the complex array or view.
+         * @return Component view of the array/view.
+         */
+        template<typename T>
+        COMPONENT_VIEW<T> real(ND_ARRAY<std::complex<T>>& array)
+        {
+            return COMPONENT_VIEW<T>(&array, 0);
+        }
+
+        /**
+         * @brief Imaginary part of a complex array, as a view that writes
+         * through.
+         *
+         * @tparam T Component type.
+         * @param array Reference to the complex array or view.
+         * @return Component view of the array/view.
+         */
+        template<typename T>
+        COMPONENT_VIEW<T> imag(ND_ARRAY<std::complex<T>>& array)
+        {
+            return COMPONENT_VIEW<T>(&array, 1);
+        }
+
+        /**
+         * @brief Complex conjugate of each element.
+         *
+         * @tparam T Component type.
+         * @param array Reference to the complex array or view.
+         * @return New complex array.
+         */
+        template<typename T>
+        ND_ARRAY<std::complex<T>> conj(const ND_ARRAY<std::complex<T>>& array)
+        {
+            NUMC_TRACE_SCOPE("conj", "complex");
+
+            auto result = Detail::complex_map<T, std::complex<T>>(
+                array,
+                [](const std::complex<T>* in,
+                    std::complex<T>* out,
+                    size_t lo,
+                    size_t hi)
+                {
+                    Core::Detail::complex_conj(in, out, lo, hi);
+                });
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                2 * result.size() * sizeof(std::complex<T>),
+                Core::trace_describe(array));
+
+            return result;
+        }
+
+        /**
+         * @brief Magnitude of each element, without undue overflow or
+         * underflow.
+         *
+         * @tparam T Component type.
+         * @param array Reference to the complex array or view.
+         * @return New real array.
+         */
+        template<typename T>
+        ND_ARRAY<T> abs(const ND_ARRAY<std::complex<T>>& array)
+        {
+            NUMC_TRACE_SCOPE("abs", "complex");
+
+            auto result = Detail::complex_map<T, T>(
+                array,
+                [](const std::complex<T>* in, T* out, size_t lo, size_t hi)
+                {
+                    Core::Detail::complex_abs(in, out, lo, hi);
+                });
+
+            NUMC_TRACE_INFO(
+                result.size(),
+                result.size() * (sizeof(std::complex<T>) + sizeof(T)),
+                Core::trace_describe(array));
+
+            return result;
+        }
+    }
+}
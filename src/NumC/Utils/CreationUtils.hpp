@@ -0,0 +1,391 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Utils/Parallel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace NumC
+{
+    namespace Utils
+    {
+        namespace Detail
+        {
+            /// @brief Outputs from this size on bypass the caches.
+            const size_t NON_TEMPORAL_BYTES = size_t(32) << 20;
+
+            /// @brief Bytes filled per parallel task.
+            const size_t FILL_GRAIN_BYTES = size_t(256) << 10;
+
+            /// @brief True if T values can be packed into 16 byte stores.
+            template<typename T>
+            struct StreamablePacked : std::integral_constant<
+                bool,
+                16 % sizeof(T) == 0 && std::is_trivially_copyable<T>::value>
+            {};
+
+            /**
+             * @brief Writes out[i] = gen(i) with non-temporal 16 byte stores
+             * from lo on, as long as whole 16 byte blocks fit before hi.
+             *
+             * @param lo First index, advanced past the elements written.
+             */
+            template<typename T, typename Gen>
+            void stream_blocks(
+                T* out,
+                size_t& lo,
+                size_t hi,
+                const Gen& gen,
+                std::true_type)
+            {
+#if defined(__SSE2__)
+                const size_t lanes = 16 / sizeof(T);
+
+                // Scalar head up to the first 16 byte boundary.
+                for (; lo < hi && uintptr_t(out + lo) % 16 != 0; ++lo)
+                    out[lo] = gen(lo);
+
+                for (; lo + lanes <= hi; lo += lanes)
+                {
+                    alignas(16) T block[16 / sizeof(T)];
+
+                    for (size_t k = 0; k < lanes; ++k)
+                        block[k] = gen(lo + k);
+
+                    _mm_stream_si128(
+                        (__m128i*)(out + lo),
+                        _mm_load_si128((const __m128i*)block));
+                }
+#else
+                (void)out;
+                (void)lo;
+                (void)hi;
+                (void)gen;
+#endif
+            }
+
+            /// @brief Elements wider than, or not packing into, 16 bytes
+            /// are left to the scalar loop.
+            template<typename T, typename Gen>
+            void stream_blocks(T*, size_t&, size_t, const Gen&, std::false_type)
+            {}
+
+            /**
+             * @brief Writes out[i] = gen(i) for i in [lo, hi) with
+             * non-temporal 16 byte stores where possible.
+             *
+             * @tparam T Element data type.
+             * @tparam Gen Callable mapping an index to a value.
+             * @param out Output buffer.
+             * @param lo First index.
+             * @param hi Last index + 1.
+             * @param gen Value generator.
+             */
+            template<typename T, typename Gen>
+            void generate_stream(T* out, size_t lo, size_t hi, const Gen& gen)
+            {
+                stream_blocks(out, lo, hi, gen, StreamablePacked<T>());
+
+                for (; lo < hi; ++lo)
+                    out[lo] = gen(lo);
+            }
+
+            /**
+             * @brief Writes array[i] = gen(i) over the whole array, in
+             * parallel chunks. Outputs of NON_TEMPORAL_BYTES and more use
+             * non-temporal stores so they do not evict the caches.
+             *
+             * @tparam T Element data type.
+             * @tparam Gen Callable mapping an index to a value.
+             * @param array Contiguous array to be filled.
+             * @param gen Value generator.
+             */
+            template<typename T, typename Gen>
+            void generate(ND_ARRAY<T>& array, const Gen& gen)
+            {
+                T* out = array.data();
+                const size_t n = array.size();
+                const size_t grain =
+                    std::max<size_t>(1, FILL_GRAIN_BYTES / sizeof(T));
+                const bool stream = n * sizeof(T) >= NON_TEMPORAL_BYTES;
+
+                parallel_for(
+                    0,
+                    n,
+                    grain,
+                    [&](size_t lo, size_t hi)
+                    {
+                        if (stream)
+                        {
+                            generate_stream(out, lo, hi, gen);
+
+#if defined(__SSE2__)
+                            // Orders this thread's streaming stores before
+                            // the chunk is reported done.
+                            _mm_sfence();
+#endif
+                            return;
+                        }
+
+                        for (size_t i = lo; i < hi; ++i)
+                            out[i] = gen(i);
+                    });
+            }
+        }
+
+        /**
+         * @brief Creates an array without initializing its elements.
+         *
+         * @tparam T Array element data type.
+         * @param shape Shape of the array.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> empty(const shape_t& shape)
+        {
+            return ND_ARRAY<T>(shape);
+        }
+
+        /**
+         * @brief Creates an array of zeros. The buffer comes zeroed from the
+         * allocator, so large arrays cost no writes until used.
+         *
+         * @tparam T Array element data type.
+         * @param shape Shape of the array.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> zeros(const shape_t& shape)
+        {
+            NUMC_TRACE_SCOPE("zeros", "factory");
+
+            return ND_ARRAY<T>(shape, Core::ArrayInit::Zeros);
+        }
+
+        /**
+         * @brief Creates an array filled with a value.
+         *
+         * @tparam T Array element data type.
+         * @param shape Shape of the array.
+         * @param value Fill value.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> full(const shape_t& shape, T value)
+        {
+            NUMC_TRACE_SCOPE("full", "factory");
+
+            ND_ARRAY<T> array(shape);
+
+            Detail::generate(array, [value](size_t) { return value; });
+
+            NUMC_TRACE_INFO(
+                array.size(),
+                array.size() * sizeof(T),
+                Core::trace_describe(array));
+
+            return array;
+        }
+
+        /**
+         * @brief Creates an array of ones.
+         *
+         * @tparam T Array element data type.
+         * @param shape Shape of the array.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> ones(const shape_t& shape)
+        {
+            return full<T>(shape, T(1));
+        }
+
+        /**
+         * @brief Creates a 1-D array of evenly spaced values in
+         * [start, stop).
+         *
+         * @tparam T Array element data type.
+         * @param start First value.
+         * @param stop End of the range, not included.
+         * @param step Spacing between values. Defaults to 1.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> arange(T start, T stop, T step = T(1))
+        {
+            NUMC_TRACE_SCOPE("arange", "factory");
+
+            NUMC_CHECK(
+                step != T(0),
+                Core::ErrorCode::InvalidArgument,
+                "factory - 1: arange step cannot be zero.");
+
+            double count = std::ceil(
+                (double(stop) - double(start)) / double(step));
+
+            NUMC_CHECK(
+                count >= 1,
+                Core::ErrorCode::InvalidShape,
+                "factory - 2: arange range is empty.");
+
+            ND_ARRAY<T> array(shape_t({size_t(count)}));
+
+            Detail::generate(
+                array,
+                [start, step](size_t i) { return T(start + T(i) * step); });
+
+            return array;
+        }
+
+        /**
+         * @brief Creates a 1-D array of evenly spaced values in [0, stop).
+         *
+         * @tparam T Array element data type.
+         * @param stop End of the range, not included.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> arange(T stop)
+        {
+            return arange<T>(T(0), stop, T(1));
+        }
+
+        /**
+         * @brief Creates a 1-D array of num evenly spaced values over
+         * [start, stop].
+         *
+         * @tparam T Array element data type.
+         * @param start First value.
+         * @param stop Last value.
+         * @param num Number of values. Defaults to 50.
+         * @param endpoint Include stop. Defaults to true.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> linspace(
+            T start,
+            T stop,
+            size_t num = 50,
+            bool endpoint = true)
+        {
+            NUMC_TRACE_SCOPE("linspace", "factory");
+
+            NUMC_CHECK(
+                num > 0,
+                Core::ErrorCode::InvalidShape,
+                "factory - 3: linspace needs at least one value.");
+
+            ND_ARRAY<T> array(shape_t({num}));
+            const double first = double(start);
+            const size_t intervals = endpoint ? num - 1 : num;
+            const double step = intervals > 0 ?
+                (double(stop) - first) / double(intervals) : 0.0;
+            const size_t last = num - 1;
+
+            Detail::generate(
+                array,
+                [=](size_t i)
+                {
+                    return endpoint && i == last && i > 0 ?
+                        stop : T(first + double(i) * step);
+                });
+
+            return array;
+        }
+
+        /**
+         * @brief Creates a 2-D array with ones on a diagonal and zeros
+         * elsewhere.
+         *
+         * @tparam T Array element data type.
+         * @param rows Number of rows.
+         * @param cols Number of columns. 0 uses rows.
+         * @param k Diagonal offset: positive above, negative below the main
+         * diagonal.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> eye(size_t rows, size_t cols = 0, size_t k = 0)
+        {
+            NUMC_TRACE_SCOPE("eye", "factory");
+
+            if (cols <= 0)
+                cols = rows;
+
+            ND_ARRAY<T> array = zeros<T>(shape_t({rows, cols}));
+            T* data = array.data();
+
+            for (size_t r = std::max<size_t>(0, -k);
+                r < rows && r + k < cols;
+                ++r)
+                data[r * cols + r + k] = T(1);
+
+            return array;
+        }
+
+        /**
+         * @brief Creates an uninitialized array shaped like another array or
+         * view.
+         *
+         * @tparam T Array element data type.
+         * @param array Reference to the array giving the shape.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> empty_like(const ND_ARRAY<T>& array)
+        {
+            return empty<T>(array.shape());
+        }
+
+        /**
+         * @brief Creates an array of zeros shaped like another array or
+         * view.
+         *
+         * @tparam T Array element data type.
+         * @param array Reference to the array giving the shape.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> zeros_like(const ND_ARRAY<T>& array)
+        {
+            return zeros<T>(array.shape());
+        }
+
+        /**
+         * @brief Creates an array of ones shaped like another array or view.
+         *
+         * @tparam T Array element data type.
+         * @param array Reference to the array giving the shape.
+         * @return New array.
+         */
+        template<typename T>
+        ND_ARRAY<T> ones_like(const ND_ARRAY<T>& array)
+        {
+            return ones<T>(array.shape());
+        }
+
+        /**
+         * @brief Creates an array filled with a value, shaped like another
+         * array or view.
+         *
+         * @tparam T Array element data type.
+         * @tparam V Fill value type, converted to T.
+         * @param array Reference to the array giving the shape.
+         * @param value Fill value.
+         * @return New array.
+         */
+        template<typename T, typename V>
+        ND_ARRAY<T> full_like(const ND_ARRAY<T>& array, V value)
+        {
+            return full<T>(array.shape(), T(value));
+        }
+    }
+}
@@ -0,0 +1,570 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Utils/Parallel.hpp>
+#include <NumC/Utils/StringUtils.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NUMC_HAS_MMAP
+#endif
+
+namespace NumC
+{
+    namespace Utils
+    {
+        /// @brief Options of loadtxt and savetxt.
+        struct TextOptions
+        {
+            /// @brief Value separator. ' ' splits on any run of spaces/tabs.
+            char delimiter = ',';
+
+            /// @brief Starts a comment running to the end of the line.
+            char comments = '#';
+
+            /// @brief Lines skipped at the start of the file (loadtxt).
+            size_t skiprows = 0;
+
+            /// @brief Returns a 1-D array for a single row or column
+            /// (loadtxt).
+            bool squeeze = true;
+
+            /// @brief Digits written per value (savetxt). Negative writes
+            /// the shortest text that reads back to the same value.
+            int precision = -1;
+
+            /// @brief Fixed ("%f") over general ("%g") notation (savetxt).
+            bool fixed = false;
+
+            /// @brief Text written first, each line prefixed with the
+            /// comment character (savetxt).
+            std::string header;
+
+            /// @brief Maximum number of threads. 0 uses
+            /// num_threads().
+            size_t threads = 0;
+        };
+
+        /**
+         * @brief Read-only view of a whole file. Memory mapped where
+         * available, read into memory otherwise.
+         */
+        class MappedFile
+        {
+            public:
+
+                /**
+                 * @brief Construct a new Mapped File object.
+                 *
+                 * @param path File path.
+                 */
+                explicit MappedFile(const std::string& path) :
+                    __data(nullptr),
+                    __size(0)
+                {
+#ifdef NUMC_HAS_MMAP
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    NUMC_CHECK(
+                        fd >= 0,
+                        Core::ErrorCode::IOError,
+                        "io - 1: could not open '" + path + "'.");
+
+                    struct stat info;
+                    if (::fstat(fd, &info) != 0)
+                    {
+                        ::close(fd);
+                        NUMC_CHECK(
+                            false,
+                            Core::ErrorCode::IOError,
+                            "io - 1: could not open '" + path + "'.");
+                    }
+
+                    this->__size = info.st_size;
+
+                    if (this->__size > 0)
+                    {
+                        void* data = ::mmap(
+                            nullptr,
+                            this->__size,
+                            PROT_READ,
+                            MAP_PRIVATE,
+                            fd,
+                            0);
+                        ::close(fd);
+
+                        NUMC_CHECK(
+                            data != MAP_FAILED,
+                            Core::ErrorCode::IOError,
+                            "io - 2: could not map '" + path + "'.");
+
+                        ::madvise(data, this->__size, MADV_WILLNEED);
+                        this->__data = static_cast<const char*>(data);
+                    }
+                    else
+                    {
+                        ::close(fd);
+                    }
+#else
+                    std::ifstream in(path, std::ios::binary);
+                    NUMC_CHECK(
+                        (bool)in,
+                        Core::ErrorCode::IOError,
+                        "io - 1: could not open '" + path + "'.");
+
+                    std::ostringstream content;
+                    content << in.rdbuf();
+                    this->__buffer = content.str();
+                    this->__data = this->__buffer.data();
+                    this->__size = this->__buffer.size();
+#endif
+                }
+
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                /// @brief Unmaps the file.
+                ~MappedFile()
+                {
+#ifdef NUMC_HAS_MMAP
+                    if (this->__data)
+                        ::munmap((void*)this->__data, this->__size);
+#endif
+                }
+
+                /**
+                 * @brief Gets the file content.
+                 *
+                 * @return Pointer to the first byte.
+                 */
+                const char* data() const
+                {
+                    return this->__data;
+                }
+
+                /**
+                 * @brief Gets the file size.
+                 *
+                 * @return Size in bytes.
+                 */
+                size_t size() const
+                {
+                    return this->__size;
+                }
+
+            private:
+
+                /// @brief File content.
+                const char* __data;
+
+                /// @brief File size in bytes.
+                size_t __size;
+
+#ifndef NUMC_HAS_MMAP
+                /// @brief Owned content when mmap is unavailable.
+                std::string __buffer;
+#endif
+        };
+
+        namespace Detail
+        {
+            /**
+             * @brief Skips blanks (spaces, tabs, carriage returns) that are
+             * not the delimiter.
+             */
+            inline const char*
+            skip_blanks(const char* p, const char* end, char delimiter)
+            {
+                while (p < end &&
+                    (*p == ' ' || *p == '\t' || *p == '\r') &&
+                    (*p != delimiter || delimiter == ' '))
+                    ++p;
+
+                return p;
+            }
+
+            /**
+             * @brief Finds the end of the data on a line: the newline,
+             * comment character or end of input, whichever comes first.
+             *
+             * @param p Start of the line.
+             * @param end End of the input.
+             * @param comments Comment character.
+             * @param next Set to the start of the next line.
+             * @return End of the line content.
+             */
+            inline const char* line_end(
+                const char* p,
+                const char* end,
+                char comments,
+                const char*& next)
+            {
+                const char* eol =
+                    static_cast<const char*>(std::memchr(p, '\n', end - p));
+                eol = eol ? eol : end;
+                next = eol < end ? eol + 1 : end;
+
+                const char* comment = static_cast<const char*>(
+                    std::memchr(p, comments, eol - p));
+
+                return comment ? comment : eol;
+            }
+
+            /**
+             * @brief Checks if a line holds any data.
+             */
+            inline bool
+            is_data_line(const char* p, const char* eol, char delimiter)
+            {
+                return skip_blanks(p, eol, delimiter) < eol;
+            }
+
+            /**
+             * @brief Parses the values of one line.
+             *
+             * @tparam T Element data type.
+             * @param p Start of the line content.
+             * @param eol End of the line content.
+             * @param delimiter Value separator.
+             * @param out Destination, or nullptr to only count values.
+             * @param max_values Capacity of out.
+             * @param row Data row number, for error messages.
+             * @return Number of values on the line.
+             */
+            template<typename T>
+            size_t parse_row(
+                const char* p,
+                const char* eol,
+                char delimiter,
+                T* out,
+                size_t max_values,
+                size_t row)
+            {
+                size_t n = 0;
+
+                while (true)
+                {
+                    p = skip_blanks(p, eol, delimiter);
+
+                    if (p >= eol && (n == 0 || delimiter == ' '))
+                        break;
+
+                    T value;
+                    const char* next = parse_number(p, eol, value);
+                    NUMC_CHECK(
+                        next != nullptr,
+                        Core::ErrorCode::InvalidArgument,
+                        "io - 3: could not parse value " +
+                            std::to_string(n + 1) + " of row " +
+                            std::to_string(row + 1) + ".");
+
+                    if (out && n < max_values)
+                        out[n] = value;
+
+                    ++n;
+                    p = skip_blanks(next, eol, delimiter);
+
+                    if (p >= eol)
+                        break;
+
+                    if (delimiter == ' ')
+                    {
+                        NUMC_CHECK(
+                            p > next,
+                            Core::ErrorCode::InvalidArgument,
+                            "io - 3: could not parse value " +
+                                std::to_string(n) + " of row " +
+                                std::to_string(row + 1) + ".");
+
+                        continue;
+                    }
+
+                    NUMC_CHECK(
+                        *p == delimiter,
+                        Core::ErrorCode::InvalidArgument,
+                        "io - 3: could not parse value " +
+                            std::to_string(n) + " of row " +
+                            std::to_string(row + 1) + ".");
+                    ++p;
+                }
+
+                return n;
+            }
+        }
+
+        /**
+         * @brief Loads a delimited text file (CSV, TSV, whitespace
+         * separated) into a new array. The shape is inferred: rows x
+         * columns, or 1-D for a single row/column when options.squeeze is
+         * set.
+         *
+         * @note The file is memory mapped and split into line aligned
+         * chunks. Rows are counted and then parsed straight into the array
+         * buffer, both passes in parallel.
+         *
+         * @tparam T Element data type.
+         * @param path File path.
+         * @param options Parsing options.
+         * @return New array holding the values.
+         */
+        template<typename T>
+        ND_ARRAY<T> loadtxt(
+            const std::string& path,
+            const TextOptions& options = TextOptions())
+        {
+            NUMC_TRACE_SCOPE("loadtxt", "io");
+
+            const char delimiter = options.delimiter;
+            const char comments = options.comments;
+
+            MappedFile file(path);
+            const char* begin = file.data();
+            const char* end = begin + file.size();
+            const char* next = begin;
+
+            for (size_t i = 0; i < options.skiprows && begin < end; ++i)
+            {
+                Detail::line_end(begin, end, comments, next);
+                begin = next;
+            }
+
+            // Columns of the first data row.
+            size_t cols = 0;
+
+            for (const char* p = begin; p < end && cols == 0; p = next)
+            {
+                const char* eol = Detail::line_end(p, end, comments, next);
+
+                if (Detail::is_data_line(p, eol, delimiter))
+                    cols = Detail::parse_row<T>(
+                        p, eol, delimiter, nullptr, 0, 0);
+            }
+
+            NUMC_CHECK(
+                cols > 0,
+                Core::ErrorCode::InvalidArgument,
+                "io - 4: '" + path + "' holds no data rows.");
+
+            // Line aligned chunks of at least 1 MB.
+            size_t n_threads =
+                options.threads > 0 ? options.threads : num_threads();
+            size_t bytes = end - begin;
+            size_t n_chunks = std::max<size_t>(
+                1, std::min<size_t>(bytes >> 20, 4 * n_threads));
+
+            std::vector<const char*> bounds(n_chunks + 1, end);
+            bounds[0] = begin;
+
+            for (size_t i = 1; i < n_chunks; ++i)
+            {
+                const char* p =
+                    std::max(begin + bytes / n_chunks * i, bounds[i - 1]);
+                const char* eol = static_cast<const char*>(
+                    std::memchr(p, '\n', end - p));
+                bounds[i] = eol ? eol + 1 : end;
+            }
+
+            // Pass 1: data rows per chunk.
+            std::vector<size_t> offsets(n_chunks + 1, 0);
+
+            parallel_for(
+                n_chunks,
+                [&](size_t chunk)
+                {
+                    const char* next = nullptr;
+                    size_t rows = 0;
+
+                    for (const char* p = bounds[chunk];
+                        p < bounds[chunk + 1];
+                        p = next)
+                    {
+                        const char* eol = Detail::line_end(
+                            p, bounds[chunk + 1], comments, next);
+                        rows += Detail::is_data_line(p, eol, delimiter);
+                    }
+
+                    offsets[chunk + 1] = rows;
+                },
+                n_threads);
+
+            for (size_t i = 0; i < n_chunks; ++i)
+                offsets[i + 1] += offsets[i];
+
+            size_t rows = offsets[n_chunks];
+
+            shape_t shape = {rows, cols};
+            if (options.squeeze && (rows == 1 || cols == 1))
+                shape = {rows * cols};
+
+            ND_ARRAY<T> array(shape);
+            T* data = array.data();
+
+            // Pass 2: parse straight into the array.
+            parallel_for(
+                n_chunks,
+                [&](size_t chunk)
+                {
+                    const char* next = nullptr;
+                    size_t row = offsets[chunk];
+
+                    for (const char* p = bounds[chunk];
+                        p < bounds[chunk + 1];
+                        p = next)
+                    {
+                        const char* eol = Detail::line_end(
+                            p, bounds[chunk + 1], comments, next);
+
+                        if (!Detail::is_data_line(p, eol, delimiter))
+                            continue;
+
+                        size_t n = Detail::parse_row(
+                            p, eol, delimiter, data + row * cols, cols, row);
+
+                        NUMC_CHECK(
+                            n == cols,
+                            Core::ErrorCode::InvalidArgument,
+                            "io - 5: row " + std::to_string(row + 1) +
+                                " has " + std::to_string(n) +
+                                " values, expected " +
+                                std::to_string(cols) + ".");
+                        ++row;
+                    }
+                },
+                n_threads);
+
+            NUMC_TRACE_INFO(
+                rows * cols,
+                bytes + rows * cols * sizeof(T),
+                Core::trace_describe(array));
+
+            return array;
+        }
+
+        /**
+         * @brief Saves a 1-D or 2-D array (or view) as delimited text. A
+         * 1-D array is written one value per line.
+         *
+         * @note Rows are formatted in parallel batches and written in
+         * order, so memory stays bounded for any array size.
+         *
+         * @tparam ArrayType Array object data type.
+         * @param path File path.
+         * @param array Reference to the array.
+         * @param options Formatting options.
+         */
+        template<typename ArrayType>
+        void savetxt(
+            const std::string& path,
+            const ArrayType& array,
+            const TextOptions& options = TextOptions())
+        {
+            NUMC_TRACE_SCOPE("savetxt", "io");
+
+            const shape_t& shape = array.shape();
+            NUMC_CHECK(
+                shape.size() <= 2,
+                Core::ErrorCode::Unsupported,
+                "io - 6: savetxt supports 1-D and 2-D arrays.");
+
+            const size_t rows = shape[0];
+            const size_t cols = shape.size() == 2 ? shape[1] : 1;
+
+            std::unique_ptr<FILE, int (*)(FILE*)> file(
+                std::fopen(path.c_str(), "wb"), &std::fclose);
+            NUMC_CHECK(
+                file != nullptr,
+                Core::ErrorCode::IOError,
+                "io - 1: could not open '" + path + "'.");
+
+            bool ok = true;
+
+            if (!options.header.empty())
+            {
+                std::string header;
+                std::istringstream lines(options.header);
+
+                for (std::string line; std::getline(lines, line);)
+                    header += std::string(1, options.comments) + " " +
+                        line + "\n";
+
+                ok = std::fwrite(
+                    header.data(), 1, header.size(), file.get()) ==
+                    header.size();
+            }
+
+            size_t n_threads =
+                options.threads > 0 ? options.threads : num_threads();
+            size_t rows_per_task = std::max<size_t>(1, 65536 / cols);
+            size_t tasks_per_batch = 4 * n_threads;
+            std::vector<std::string> texts(tasks_per_batch);
+
+            for (size_t first = 0; ok && first < rows;
+                first += rows_per_task * tasks_per_batch)
+            {
+                size_t n_tasks = std::min(
+                    tasks_per_batch,
+                    (rows - first + rows_per_task - 1) / rows_per_task);
+
+                parallel_for(
+                    n_tasks,
+                    [&](size_t task)
+                    {
+                        std::string& text = texts[task];
+                        size_t row = first + task * rows_per_task;
+                        size_t last = std::min(rows, row + rows_per_task);
+                        char buffer[64];
+
+                        text.clear();
+
+                        for (; row < last; ++row)
+                        {
+                            for (size_t col = 0; col < cols; ++col)
+                            {
+                                if (col > 0)
+                                    text += options.delimiter;
+
+                                int n = format_number(
+                                    buffer,
+                                    buffer + sizeof(buffer),
+                                    array.get(row * cols + col),
+                                    options.precision,
+                                    options.fixed);
+                                text.append(buffer, n);
+                            }
+
+                            text += '\n';
+                        }
+                    },
+                    n_threads);
+
+                for (size_t task = 0; ok && task < n_tasks; ++task)
+                    ok = std::fwrite(
+                        texts[task].data(),
+                        1,
+                        texts[task].size(),
+                        file.get()) == texts[task].size();
+            }
+
+            ok = ok && std::fflush(file.get()) == 0;
+            NUMC_CHECK(
+                ok,
+                Core::ErrorCode::IOError,
+                "io - 7: could not write '" + path + "'.");
+
+            NUMC_TRACE_INFO(
+                rows * cols,
+                rows * cols * sizeof(typename ArrayType::dtype),
+                Core::trace_describe(array));
+        }
+    }
+}
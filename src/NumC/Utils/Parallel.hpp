@@ -0,0 +1,359 @@
+#pragma once
+
+#include <NumC/Utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NumC
+{
+    namespace Utils
+    {
+        /**
+         * @brief Gets the number of threads NumC runs parallel work on.
+         *
+         * @return Number of workers in the shared pool.
+         */
+        inline size_t num_threads()
+        {
+            return ThreadPool::instance().size();
+        }
+
+        /**
+         * @brief Sets the number of threads NumC runs parallel work on. The
+         * shared pool is restarted with that many workers.
+         *
+         * @warning Must not be called while NumC work is running.
+         *
+         * @param n_threads Number of threads. 0 uses hardware_threads().
+         */
+        inline void set_num_threads(size_t n_threads)
+        {
+            ThreadPool& pool = ThreadPool::instance();
+
+            pool.resize(n_threads, pool.pinned());
+        }
+
+        /**
+         * @brief Pins, or unpins, each worker of the shared pool to one CPU.
+         *
+         * @warning Must not be called while NumC work is running.
+         *
+         * @param pin True to pin the workers.
+         */
+        inline void set_thread_pinning(bool pin)
+        {
+            ThreadPool& pool = ThreadPool::instance();
+
+            pool.resize(pool.size(), pin);
+        }
+
+        namespace Detail
+        {
+            /**
+             * @brief Tasks of one parallel_for call shared between the
+             * calling thread and the helper jobs.
+             *
+             * @tparam Func Callable taking the task index.
+             */
+            template<typename Func>
+            struct ParallelTasks
+            {
+                ParallelTasks(const Func& func, size_t n_tasks) :
+                    func(&func),
+                    n_tasks(n_tasks),
+                    next(0),
+                    done(0),
+                    failed(false)
+                {}
+
+                /// @brief Runs tasks until none is left to claim.
+                void work()
+                {
+                    for (size_t task = next++; task < n_tasks; task = next++)
+                        run(task);
+                }
+
+                /// @brief Runs one task, skipped if another one failed.
+                void run(size_t task)
+                {
+                    if (!failed)
+                    {
+                        try
+                        {
+                            (*func)(task);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+
+                            if (!failed.exchange(true))
+                                error = std::current_exception();
+                        }
+                    }
+
+                    if (++done == n_tasks)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        cv.notify_all();
+                    }
+                }
+
+                /// @brief Blocks until all the tasks are done.
+                void wait()
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+
+                    cv.wait(lock, [this] { return done == n_tasks; });
+                }
+
+                /// @brief Only used by threads holding an unfinished task.
+                const Func* func;
+
+                const size_t n_tasks;
+                std::atomic<size_t> next;
+                std::atomic<size_t> done;
+                std::atomic<bool> failed;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable cv;
+            };
+
+            /**
+             * @brief Gets the number of chunks a range is split in.
+             *
+             * @param n Range length.
+             * @param grain Chunk length. Set if 0 to get 4 chunks per
+             * thread.
+             * @return Number of chunks.
+             */
+            inline size_t chunk_count(size_t n, size_t& grain)
+            {
+                size_t n_chunks = 4 * num_threads();
+
+                if (grain <= 0)
+                    grain = std::max<size_t>(
+                        1, (n + n_chunks - 1) / n_chunks);
+
+                return (n + grain - 1) / grain;
+            }
+        }
+
+        /**
+         * @brief Runs func(task) for every task in [0, n_tasks). Tasks are
+         * handed out dynamically to the calling thread and up to
+         * max_threads - 1 jobs on the shared ThreadPool.
+         *
+         * @note Safe to nest: the calling thread works through the tasks
+         * itself and only waits for the ones already started by other
+         * threads, so a call made from a pool worker never deadlocks and
+         * never uses more than num_threads() threads.
+         *
+         * @note The first exception thrown by a task is rethrown once all
+         * started tasks are done. Remaining tasks are skipped.
+         *
+         * @tparam Func Callable taking the task index.
+         * @param n_tasks Number of tasks.
+         * @param func Task body.
+         * @param max_threads Maximum number of threads, capped at
+         * num_threads(). 0 uses num_threads().
+         */
+        template<typename Func>
+        void parallel_for(
+            size_t n_tasks,
+            const Func& func,
+            size_t max_threads = 0)
+        {
+            size_t n_threads = num_threads();
+
+            if (max_threads > 0)
+                n_threads = std::min(n_threads, max_threads);
+
+            n_threads = std::min(n_threads, n_tasks);
+
+            if (n_threads <= 1)
+            {
+                for (size_t task = 0; task < n_tasks; ++task)
+                    func(task);
+
+                return;
+            }
+
+            auto tasks =
+                std::make_shared<Detail::ParallelTasks<Func>>(func, n_tasks);
+            ThreadPool& pool = ThreadPool::instance();
+
+            for (size_t i = 1; i < n_threads; ++i)
+                pool.submit([tasks] { tasks->work(); });
+
+            tasks->work();
+            tasks->wait();
+
+            // Taken out so the helpers never release the exception.
+            std::exception_ptr error;
+            error.swap(tasks->error);
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        /**
+         * @brief Runs func(lo, hi) over [begin, end) split in chunks of
+         * grain indices, in parallel as parallel_for(n_tasks, ...).
+         *
+         * @tparam Func Callable taking a chunk [lo, hi).
+         * @param begin First index.
+         * @param end Last index + 1.
+         * @param grain Chunk length. 0 picks 4 chunks per thread.
+         * @param func Chunk body.
+         */
+        template<typename Func>
+        void parallel_for(
+            size_t begin,
+            size_t end,
+            size_t grain,
+            const Func& func)
+        {
+            if (end <= begin)
+                return;
+
+            size_t n_chunks = Detail::chunk_count(end - begin, grain);
+
+            parallel_for(
+                n_chunks,
+                [&](size_t chunk)
+                {
+                    size_t lo = begin + chunk * grain;
+
+                    func(lo, std::min(end, lo + grain));
+                });
+        }
+
+        /**
+         * @brief Runs func(lo, hi) over [begin, end) split in one contiguous
+         * block per worker of the shared pool: block i always runs on
+         * worker i. Used to place memory by first touch.
+         *
+         * @warning A block waits for its worker: one busy worker stalls the
+         * whole call. Compute kernels should use parallel_for(), which the
+         * calling thread and any idle worker take part in.
+         *
+         * @note Blocks are at least grain indices long, so short ranges use
+         * fewer workers. The calling thread only waits. Called from a pool
+         * worker, where the other workers may be busy waiting on this one,
+         * the blocks are run as parallel_for() chunks instead.
+         *
+         * @note The first exception thrown by a block is rethrown once all
+         * the blocks are done.
+         *
+         * @tparam Func Callable taking a block [lo, hi).
+         * @param begin First index.
+         * @param end Last index + 1.
+         * @param grain Minimum block length.
+         * @param func Block body.
+         */
+        template<typename Func>
+        void parallel_for_static(
+            size_t begin,
+            size_t end,
+            size_t grain,
+            const Func& func)
+        {
+            if (end <= begin)
+                return;
+
+            const size_t n = end - begin;
+
+            grain = std::max<size_t>(1, grain);
+
+            size_t n_blocks = std::min(num_threads(), (n + grain - 1) / grain);
+            const size_t block = (n + n_blocks - 1) / n_blocks;
+            n_blocks = (n + block - 1) / block;
+
+            if (n_blocks <= 1 || ThreadPool::in_worker())
+            {
+                parallel_for(begin, end, block, func);
+
+                return;
+            }
+
+            auto body = [&](size_t i)
+            {
+                size_t lo = begin + i * block;
+
+                func(lo, std::min(end, lo + block));
+            };
+
+            auto tasks = std::make_shared<
+                Detail::ParallelTasks<decltype(body)>>(body, n_blocks);
+            ThreadPool& pool = ThreadPool::instance();
+
+            for (size_t i = 0; i < n_blocks; ++i)
+                pool.submit_to(i, [tasks, i] { tasks->run(i); });
+
+            tasks->wait();
+
+            std::exception_ptr error;
+            error.swap(tasks->error);
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        /**
+         * @brief Reduces [begin, end) split in chunks of grain indices.
+         * Chunks are mapped in parallel, the partial results are then
+         * combined in chunk order.
+         *
+         * @note The result only depends on grain, not on the thread count,
+         * unless grain is 0.
+         *
+         * @tparam T Result type.
+         * @tparam Map Callable mapping a chunk [lo, hi) to a T.
+         * @tparam Reduce Callable combining two T.
+         * @param begin First index.
+         * @param end Last index + 1.
+         * @param grain Chunk length. 0 picks 4 chunks per thread.
+         * @param identity Result of an empty range.
+         * @param map Chunk body.
+         * @param reduce Combines two partial results.
+         * @return Reduced value.
+         */
+        template<typename T, typename Map, typename Reduce>
+        T parallel_reduce(
+            size_t begin,
+            size_t end,
+            size_t grain,
+            T identity,
+            const Map& map,
+            const Reduce& reduce)
+        {
+            if (end <= begin)
+                return identity;
+
+            size_t n_chunks = Detail::chunk_count(end - begin, grain);
+            std::vector<T> partials(n_chunks, identity);
+
+            parallel_for(
+                n_chunks,
+                [&](size_t chunk)
+                {
+                    size_t lo = begin + chunk * grain;
+
+                    partials[chunk] = map(lo, std::min(end, lo + grain));
+                });
+
+            T result = identity;
+
+            for (size_t chunk = 0; chunk < n_chunks; ++chunk)
+                result = reduce(result, partials[chunk]);
+
+            return result;
+        }
+    }
+}
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Utils/StringUtils.hpp>
+
+#include <cstring>
+#include <ostream>
+
+namespace NumC
+{
+    namespace Utils
+    {
+        /// @brief Formatting options of print_array.
+        struct PrintOptions
+        {
+            /// @brief Digits after the decimal point (significant digits
+            /// when fixed is off) of floating point elements.
+            int precision = 6;
+
+            /// @brief Fixed ("%f") over general ("%g") float notation.
+            bool fixed = true;
+
+            /// @brief Arrays with more elements than this are summarized.
+            size_t threshold = 1000;
+
+            /// @brief Number of leading and trailing items kept per axis
+            /// when summarizing.
+            size_t edgeitems = 3;
+
+            /// @brief Lines longer than this are wrapped (tabs count as 8).
+            size_t linewidth = 75;
+
+            /// @brief Prints the shape, indices and strides header.
+            bool metadata = true;
+        };
+
+        /**
+         * @brief Small fixed-size buffer in front of an output stream. Keeps
+         * track of the current column so that rows can be wrapped.
+         */
+        class PrintBuffer
+        {
+            public:
+
+                /**
+                 * @brief Construct a new Print Buffer object.
+                 *
+                 * @param out Stream the text is flushed to.
+                 */
+                explicit PrintBuffer(std::ostream& out) :
+                    __out(out),
+                    __len(0),
+                    __column(0)
+                {}
+
+                PrintBuffer(const PrintBuffer&) = delete;
+                PrintBuffer& operator=(const PrintBuffer&) = delete;
+
+                /// @brief Flushes the remaining text.
+                ~PrintBuffer()
+                {
+                    this->flush();
+                }
+
+                /**
+                 * @brief Appends characters.
+                 *
+                 * @param s Characters to be appended.
+                 * @param n Number of characters.
+                 */
+                void write(const char* s, size_t n)
+                {
+                    for (size_t i = 0; i < n; ++i)
+                        this->put(s[i]);
+                }
+
+                /**
+                 * @brief Appends a null terminated string.
+                 *
+                 * @param s String to be appended.
+                 */
+                void write(const char* s)
+                {
+                    this->write(s, std::strlen(s));
+                }
+
+                /**
+                 * @brief Appends a string.
+                 *
+                 * @param s String to be appended.
+                 */
+                void write(const std::string& s)
+                {
+                    this->write(s.data(), s.size());
+                }
+
+                /**
+                 * @brief Appends a character.
+                 *
+                 * @param c Character to be appended.
+                 */
+                void put(char c)
+                {
+                    if (this->__len == sizeof(this->__buffer))
+                        this->flush();
+
+                    this->__buffer[this->__len++] = c;
+
+                    if (c == '\n')
+                        this->__column = 0;
+                    else if (c == '\t')
+                        this->__column = (this->__column / 8 + 1) * 8;
+                    else
+                        ++(this->__column);
+                }
+
+                /**
+                 * @brief Appends a character several times.
+                 *
+                 * @param c Character to be appended.
+                 * @param count Number of copies.
+                 */
+                void fill(char c, size_t count)
+                {
+                    for (size_t i = 0; i < count; ++i)
+                        this->put(c);
+                }
+
+                /**
+                 * @brief Gets the column of the next character.
+                 *
+                 * @return Current column.
+                 */
+                size_t column() const
+                {
+                    return this->__column;
+                }
+
+                /// @brief Writes the buffered text to the stream.
+                void flush()
+                {
+                    this->__out.write(this->__buffer, this->__len);
+                    this->__len = 0;
+                }
+
+            private:
+
+                /// @brief Destination stream.
+                std::ostream& __out;
+
+                /// @brief Pending text.
+                char __buffer[4096];
+
+                /// @brief Number of pending characters.
+                size_t __len;
+
+                /// @brief Column of the next character.
+                size_t __column;
+        };
+
+        /**
+         * @brief Helper to print one axis of an array.
+         *
+         * @note Elements are read through get() with the logical strides, so
+         * summarized arrays only touch the printed elements.
+         *
+         * @tparam ArrayType Array object data type.
+         * @param buffer Output buffer.
+         * @param array Reference to the array.
+         * @param options Formatting options.
+         * @param summarize Value indicating if axes are cut to edge items.
+         * @param axis Dimension being printed.
+         * @param offset Logical index of the first element of the block.
+         */
+        template<typename ArrayType>
+        void print_axis(
+            PrintBuffer& buffer,
+            const ArrayType& array,
+            const PrintOptions& options,
+            bool summarize,
+            size_t axis,
+            size_t offset)
+        {
+            const size_t ndims = array.shape().size();
+            const size_t dim = array.shape()[axis];
+            const size_t stride = array.strides()[axis];
+            const size_t edge = options.edgeitems;
+            const bool cut = summarize && dim > 2 * edge;
+
+            buffer.put('[');
+
+            for (size_t i = 0; i < dim; ++i)
+            {
+                if (cut && i == edge)
+                {
+                    // Ellipsis in place of the skipped items.
+                    i = dim - edge - 1;
+
+                    if (axis + 1 < ndims)
+                    {
+                        buffer.write(",\n\t");
+                        buffer.fill(' ', axis + 1);
+                    }
+                    else
+                    {
+                        buffer.write(", ");
+                    }
+
+                    buffer.write("...");
+
+                    continue;
+                }
+
+                if (axis + 1 < ndims)
+                {
+                    if (i > 0)
+                    {
+                        buffer.write(",\n\t");
+                        buffer.fill(' ', axis + 1);
+                    }
+
+                    print_axis(
+                        buffer,
+                        array,
+                        options,
+                        summarize,
+                        axis + 1,
+                        offset + i * stride);
+
+                    continue;
+                }
+
+                char text[64];
+                size_t len = format_number(
+                    text,
+                    text + sizeof(text),
+                    array.get(offset + i * stride),
+                    options.precision,
+                    options.fixed);
+
+                if (i > 0)
+                {
+                    buffer.put(',');
+
+                    // Room for " <text>" plus the closing brackets.
+                    if (buffer.column() + len + ndims + 1 > options.linewidth)
+                    {
+                        buffer.write("\n\t");
+                        buffer.fill(' ', axis + 1);
+                    }
+                    else
+                    {
+                        buffer.put(' ');
+                    }
+                }
+
+                buffer.write(text, len);
+            }
+
+            buffer.put(']');
+        }
+
+        /**
+         * @brief Prints the array to a stream. Elements are formatted into a
+         * small fixed buffer and streamed, the full text is never built.
+         * Arrays with more than options.threshold elements are summarized
+         * with options.edgeitems leading/trailing items per axis.
+         *
+         * @tparam ArrayType Array object data type.
+         * @param array Reference to the array.
+         * @param out Output stream.
+         * @param options Formatting options.
+         */
+        template<typename ArrayType>
+        void print_array(
+            const ArrayType& array,
+            std::ostream& out,
+            const PrintOptions& options = PrintOptions())
+        {
+            NUMC_TRACE_SCOPE("print_array", "io");
+
+            PrintBuffer buffer(out);
+
+            buffer.write("array(\n");
+
+            if (options.metadata)
+            {
+                buffer.write("\tshape(");
+                buffer.write(to_string<size_t>(array.shape()));
+                buffer.write("),\n\n");
+
+                buffer.write("\tindices(");
+                buffer.write(to_string<size_t>(array.indices()));
+                buffer.write("),\n\n");
+
+                buffer.write("\tstrides(");
+                buffer.write(to_string<size_t>(array.strides()));
+                buffer.write("),\n\n");
+            }
+
+            bool summarize = array.size() > options.threshold;
+
+            buffer.put('\t');
+            print_axis(buffer, array, options, summarize, 0, 0);
+            buffer.write("\n)\n");
+
+            NUMC_TRACE_INFO(
+                array.size(),
+                array.size() * sizeof(typename ArrayType::dtype),
+                Core::trace_describe(array));
+        }
+
+        /**
+         * @brief Prints the array to the standard output.
+         *
+         * @tparam ArrayType Array object data type.
+         * @param array Reference to the array.
+         */
+        template<typename ArrayType>
+        void print_array(const ArrayType& array)
+        {
+            print_array(array, std::cout);
+        }
+    }
+
+    namespace Core
+    {
+        /**
+         * @brief Streams an array (or view) with the default print options.
+         *
+         * @tparam T Array element data type.
+         * @param out Output stream.
+         * @param array Reference to the array.
+         * @return Reference to the stream.
+         */
+        template<typename T>
+        std::ostream& operator<<(std::ostream& out, const NdArray<T>& array)
+        {
+            Utils::print_array(array, out);
+
+            return out;
+        }
+    }
+}
@@ -1,6 +1,42 @@
 #pragma once
 
+#include <NumC/Core/Half.hpp>
+#include <NumC/Core/SmallVector.hpp>
+
 #include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <complex>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <locale.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#define NUMC_HAS_STRTOD_L
+#endif
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+/**
+ * @brief Defined when std::to_chars supports floating point values. Number
+ * formatting falls back to snprintf otherwise.
+ */
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define NUMC_HAS_TO_CHARS
+#endif
 
 namespace NumC
 {
@@ -140,6 +176,642 @@ namespace NumC
             return output;
         }
 
+        /**
+         * @brief Utility function to stringify small vector of pairs.
+         *
+         * @tparam T Basic data type.
+         * @tparam N Inline capacity of the small vector.
+         * @param vctr Reference to the small vector of pairs.
+         * @return Output string.
+         */
+        template<typename T, std::size_t N>
+        static std::string
+        to_string(const Core::SmallVector<std::pair<T, T>, N>& vctr)
+        {
+            return to_string<T>(vctr.data(), vctr.size());
+        }
+
+        /**
+         * @brief Utility function to stringify small vector.
+         *
+         * @tparam T Basic data type.
+         * @tparam N Inline capacity of the small vector.
+         * @param vctr Small vector to be printed.
+         * @return Output string.
+         */
+        template<typename T, std::size_t N>
+        static std::string to_string(const Core::SmallVector<T, N>& vctr)
+        {
+            return to_string<T>(vctr.data(), vctr.size());
+        }
+
+        /**
+         * @brief Writes the decimal digits of an unsigned integer.
+         *
+         * @param first Start of the output buffer.
+         * @param last End of the output buffer. Must leave room for 20
+         * digits.
+         * @param value Value to be written.
+         * @return Number of characters written.
+         */
+        inline int format_digits(char* first, char*, unsigned long long value)
+        {
+            char digits[20];
+            int n = 0;
+
+            do
+            {
+                digits[n++] = '0' + value % 10;
+                value /= 10;
+            }
+            while (value);
+
+            for (int i = 0; i < n; ++i)
+                first[i] = digits[n - 1 - i];
+
+            return n;
+        }
+
+        /**
+         * @brief Gets a power of ten.
+         *
+         * @param exponent Exponent, 0 to 9.
+         * @return 10^exponent.
+         */
+        inline unsigned long long pow10(int exponent)
+        {
+            static const unsigned long long table[] = {
+                1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+                1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL};
+
+            return table[exponent];
+        }
+
+        /**
+         * @brief Rounds value * 10^precision to the nearest integer, ties to
+         * even, exactly like printf does on the decimal expansion.
+         *
+         * @note The product is split into two exact halves (Veltkamp split
+         * of value, 10^p = 2^p * 5^p) and summed with its rounding error
+         * kept (TwoSum), so ties and near-ties are decided on the exact
+         * product.
+         *
+         * @param value Non-negative finite value.
+         * @param precision Digits after the decimal point, 0 to 9. The
+         * product must stay below 2^52.
+         * @return Rounded product.
+         */
+        inline unsigned long long round_scaled(double value, int precision)
+        {
+            const double p5 = (double)(pow10(precision) >> precision);
+            const double p2 = (double)(1ULL << precision);
+
+            // 32 + 21 significant bits, so both products below are exact.
+            double c = value * 2097153.0;
+            double hi = c - (c - value);
+            double lo = value - hi;
+            double a = hi * p5 * p2;
+            double b = lo * p5 * p2;
+
+            double sum = a + b;
+            double bb = sum - a;
+            double err = (a - (sum - bb)) + (b - bb);
+
+            double rounded = std::nearbyint(sum);
+            double frac = sum - rounded;
+
+            if (frac == 0.5 && err > 0)
+                rounded += 1;
+            else if (frac == -0.5 && err < 0)
+                rounded -= 1;
+
+            return (unsigned long long)rounded;
+        }
+
+        /**
+         * @brief Formats an integer into a caller provided buffer. Does not
+         * allocate and does not null terminate.
+         *
+         * @tparam T Integral data type.
+         * @param first Start of the output buffer.
+         * @param last End of the output buffer.
+         * @param value Value to be formatted.
+         * @param precision Unused for integers.
+         * @param fixed Unused for integers.
+         * @return Number of characters written.
+         */
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value, int>::type
+        format_number(char* first, char* last, T value, int, bool)
+        {
+#ifdef NUMC_HAS_TO_CHARS
+            return std::to_chars(first, last, value).ptr - first;
+#else
+            char* p = first;
+
+            if (value < 0)
+                *p++ = '-';
+
+            // Negating through the unsigned type keeps INT64_MIN intact.
+            unsigned long long u = (unsigned long long)value;
+            if (value < 0)
+                u = 0ULL - u;
+
+            return (p - first) + format_digits(p, last, u);
+#endif
+        }
+
+        /**
+         * @brief Formats a floating point value into a caller provided
+         * buffer. Does not allocate and does not null terminate.
+         *
+         * @tparam T Floating point data type.
+         * @param first Start of the output buffer.
+         * @param last End of the output buffer.
+         * @param value Value to be formatted.
+         * @param precision Digits after the decimal point when fixed,
+         * significant digits otherwise. Negative picks the shortest text
+         * that reads back to the same value (max_digits10 significant
+         * digits without std::to_chars).
+         * @param fixed Value indicating fixed ("%f") over general ("%g")
+         * notation. Ignored for a negative precision.
+         * @return Number of characters written.
+         */
+        template<typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, int>::type
+        format_number(
+            char* first,
+            char* last,
+            T value,
+            int precision,
+            bool fixed)
+        {
+#ifdef NUMC_HAS_TO_CHARS
+            auto result = precision < 0 ?
+                std::to_chars(first, last, value) :
+                std::to_chars(
+                    first,
+                    last,
+                    value,
+                    fixed ?
+                        std::chars_format::fixed : std::chars_format::general,
+                    precision);
+
+            if (result.ec == std::errc())
+                return result.ptr - first;
+#endif
+            if (precision < 0)
+            {
+                precision = std::numeric_limits<T>::max_digits10;
+                fixed = false;
+            }
+
+            // Fixed notation of moderate values is built from one rounded
+            // integer instead of going through printf.
+            if (fixed && precision >= 0 && precision <= 9 &&
+                std::isfinite(value) &&
+                std::fabs((double)value) * pow10(precision) <
+                    4503599627370496.0)
+            {
+                unsigned long long units =
+                    round_scaled(std::fabs((double)value), precision);
+                unsigned long long whole = units / pow10(precision);
+                unsigned long long frac = units % pow10(precision);
+
+                char* p = first;
+
+                if (std::signbit(value))
+                    *p++ = '-';
+
+                p += format_digits(p, last, whole);
+
+                if (precision > 0)
+                {
+                    *p++ = '.';
+
+                    for (int i = precision - 1; i >= 0; --i, frac /= 10)
+                        p[i] = '0' + frac % 10;
+
+                    p += precision;
+                }
+
+                return p - first;
+            }
+
+            int n = std::snprintf(
+                first,
+                last - first,
+                fixed ? "%.*f" : "%.*g",
+                precision,
+                (double)value);
+
+            n = std::min<int>(n, last - first - 1);
+
+            // printf follows LC_NUMERIC, files always use '.'.
+            const char* point = std::localeconv()->decimal_point;
+
+            if (point[0] != '.' && point[0] != '\0' && point[1] == '\0')
+                std::replace(first, first + n, point[0], '.');
+
+            return n;
+        }
+
+        /**
+         * @brief Formats a complex value NumPy style, e.g. 1.5-2j: the real
+         * part, then the imaginary part with its sign always written,
+         * followed by 'j'.
+         *
+         * @tparam T Component type.
+         * @param first Start of the output buffer.
+         * @param last End of the output buffer.
+         * @param value Value to be formatted.
+         * @param precision Applied to both parts, see format_number().
+         * @param fixed Applied to both parts, see format_number().
+         * @return Number of characters written.
+         */
+        template<typename T>
+        int format_number(
+            char* first,
+            char* last,
+            const std::complex<T>& value,
+            int precision,
+            bool fixed)
+        {
+            char* p = first;
+
+            p += format_number(p, last - 2, value.real(), precision, fixed);
+
+            // Negative parts, nan included, come with their own sign.
+            if (!std::signbit(value.imag()))
+                *p++ = '+';
+
+            p += format_number(p, last - 1, value.imag(), precision, fixed);
+            *p++ = 'j';
+
+            return p - first;
+        }
+
+        /**
+         * @brief Parses an integer from a character range. Does not need
+         * null termination. Leading whitespace is not skipped.
+         *
+         * @tparam T Integral data type.
+         * @param first Start of the text.
+         * @param last End of the text.
+         * @param value Parsed value, untouched on failure.
+         * @return Pointer past the parsed characters, nullptr if no value
+         * could be parsed or it does not fit T.
+         */
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value, const char*>::type
+        parse_number(const char* first, const char* last, T& value)
+        {
+            if (first < last && *first == '+')
+                ++first;
+
+#ifdef NUMC_HAS_TO_CHARS
+            auto result = std::from_chars(first, last, value);
+
+            return result.ec == std::errc() ? result.ptr : nullptr;
+#else
+            const char* p = first;
+            bool negative = p < last && *p == '-';
+
+            if (negative)
+            {
+                if (!std::is_signed<T>::value)
+                    return nullptr;
+
+                ++p;
+            }
+
+            const unsigned long long limit = negative ?
+                0ULL - (unsigned long long)std::numeric_limits<T>::min() :
+                (unsigned long long)std::numeric_limits<T>::max();
+            unsigned long long u = 0;
+            const char* digits = p;
+
+            for (; p < last && *p >= '0' && *p <= '9'; ++p)
+            {
+                unsigned d = *p - '0';
+
+                if (u > (limit - d) / 10)
+                    return nullptr;
+
+                u = u * 10 + d;
+            }
+
+            if (p == digits)
+                return nullptr;
+
+            value = negative ? (T)(0ULL - u) : (T)u;
+
+            return p;
+#endif
+        }
+
+        /**
+         * @brief strtod()/strtof() in the "C" locale, whatever LC_NUMERIC
+         * the host process has set, so that '.' is always the decimal
+         * point.
+         *
+         * @tparam T Floating point data type.
+         * @param text Null terminated text.
+         * @param end Set past the parsed characters, to text on failure.
+         * @return Parsed value.
+         */
+        template<typename T>
+        T strtod_classic(const char* text, char** end)
+        {
+#if defined(NUMC_HAS_STRTOD_L)
+            static const locale_t c_locale =
+                newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+
+            return sizeof(T) < sizeof(double) ?
+                (T)strtof_l(text, end, c_locale) :
+                (T)strtod_l(text, end, c_locale);
+#elif defined(_WIN32)
+            static const _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+
+            return sizeof(T) < sizeof(double) ?
+                (T)_strtof_l(text, end, c_locale) :
+                (T)_strtod_l(text, end, c_locale);
+#else
+            std::istringstream in(text);
+            double parsed = 0;
+
+            in.imbue(std::locale::classic());
+            in >> parsed;
+
+            std::streamoff used = in.fail() ? 0 :
+                in.eof() ? std::streamoff(std::char_traits<char>::length(
+                    text)) : std::streamoff(in.tellg());
+
+            *end = const_cast<char*>(text) + used;
+
+            return (T)parsed;
+#endif
+        }
+
+        /**
+         * @brief Parses a floating point value from a character range. Does
+         * not need null termination. Leading whitespace is not skipped.
+         *
+         * @note Without std::from_chars, plain decimals with up to 19
+         * significant digits are converted exactly on the fast path
+         * (Clinger). Anything else (long mantissas, large exponents, nan,
+         * inf) goes through strtod in the "C" locale on a bounded copy.
+         *
+         * @tparam T Floating point data type.
+         * @param first Start of the text.
+         * @param last End of the text.
+         * @param value Parsed value, untouched on failure.
+         * @return Pointer past the parsed characters, nullptr if no value
+         * could be parsed.
+         */
+        template<typename T>
+        typename std::enable_if<
+            std::is_floating_point<T>::value, const char*>::type
+        parse_number(const char* first, const char* last, T& value)
+        {
+            if (first < last && *first == '+')
+                ++first;
+
+#ifdef NUMC_HAS_TO_CHARS
+            auto result = std::from_chars(first, last, value);
+
+            if (result.ec == std::errc())
+                return result.ptr;
+#else
+            const char* p = first;
+            bool negative = p < last && *p == '-';
+
+            if (negative)
+                ++p;
+
+            unsigned long long mantissa = 0;
+            int digits = 0, exponent = 0;
+            bool any = false, exact = true;
+
+            for (; p < last && *p >= '0' && *p <= '9'; ++p, any = true)
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    digits += mantissa > 0;
+                }
+                else
+                {
+                    ++exponent;
+                    exact = false;
+                }
+            }
+
+            if (p < last && *p == '.')
+            {
+                for (++p; p < last && *p >= '0' && *p <= '9'; ++p, any = true)
+                {
+                    if (digits < 19)
+                    {
+                        mantissa = mantissa * 10 + (*p - '0');
+                        digits += mantissa > 0;
+                        --exponent;
+                    }
+                    else if (*p != '0')
+                    {
+                        exact = false;
+                    }
+                }
+            }
+
+            if (any && p < last && (*p == 'e' || *p == 'E'))
+            {
+                const char* q = p + 1;
+                bool negative_exp = q < last && *q == '-';
+
+                if (q < last && (*q == '-' || *q == '+'))
+                    ++q;
+
+                int e = 0;
+                const char* exp_digits = q;
+
+                for (; q < last && *q >= '0' && *q <= '9'; ++q)
+                    e = std::min(e * 10 + (*q - '0'), 100000);
+
+                if (q > exp_digits)
+                {
+                    exponent += negative_exp ? -e : e;
+                    p = q;
+                }
+            }
+
+            // Both the mantissa and the power of ten are exact, so one
+            // multiplication/division rounds correctly.
+            const bool is_float = sizeof(T) < sizeof(double);
+            const unsigned long long max_mantissa =
+                is_float ? (1ULL << 24) : (1ULL << 53);
+            const int max_exponent = is_float ? 10 : 22;
+
+            if (any && exact && mantissa <= max_mantissa &&
+                exponent >= -max_exponent && exponent <= max_exponent)
+            {
+                static const double powers[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                    1e20, 1e21, 1e22};
+
+                T m = (T)mantissa;
+                T scale = (T)powers[exponent < 0 ? -exponent : exponent];
+                T result = exponent < 0 ? m / scale : m * scale;
+
+                value = negative ? -result : result;
+
+                return p;
+            }
+#endif
+            // Slow path on a null terminated copy.
+            char buffer[128];
+            size_t n = std::min<size_t>(last - first, sizeof(buffer) - 1);
+            std::copy(first, first + n, buffer);
+            buffer[n] = '\0';
+
+            char* end = nullptr;
+            T parsed = strtod_classic<T>(buffer, &end);
+
+            if (end == buffer)
+                return nullptr;
+
+            value = parsed;
+
+            return first + (end - buffer);
+        }
+
+        namespace Detail
+        {
+            /**
+             * @brief Formats a 16 bit float through float32. A negative
+             * precision picks the fewest significant digits, up to
+             * max_digits, that read back to the same 16 bit value.
+             *
+             * @tparam H Float16 or BFloat16.
+             * @param max_digits Digits telling apart any two H values.
+             * @return Number of characters written.
+             */
+            template<typename H>
+            int format_half(
+                char* first,
+                char* last,
+                H value,
+                int precision,
+                bool fixed,
+                int max_digits)
+            {
+                const float32 x = float32(value);
+
+                if (precision >= 0 || !std::isfinite(x))
+                    return format_number(first, last, x, precision, fixed);
+
+                int digits = 1;
+
+                for (; digits < max_digits; ++digits)
+                {
+                    int n = format_number(first, last, x, digits, false);
+
+                    float32 back;
+
+                    if (parse_number(first, first + n, back) != nullptr &&
+                        float32(H(back)) == x)
+                        break;
+                }
+
+                // Whole numbers keep all their integer digits rather than
+                // switching to an exponent, e.g. 1000 over 1e+03.
+                const float32 magnitude = std::fabs(x);
+
+                if (magnitude >= 1 && magnitude < 1e17f)
+                    digits = std::max(
+                        digits, int(std::floor(std::log10(magnitude))) + 1);
+
+                return format_number(first, last, x, digits, false);
+            }
+
+            /// @brief Parses a 16 bit float through float32.
+            template<typename H>
+            const char* parse_half(
+                const char* first,
+                const char* last,
+                H& value)
+            {
+                float32 parsed;
+                const char* end = parse_number(first, last, parsed);
+
+                if (end != nullptr)
+                    value = H(parsed);
+
+                return end;
+            }
+        }
+
+        /**
+         * @brief Formats a float16 value through float32. A negative
+         * precision picks the shortest text that reads back to the same
+         * float16.
+         *
+         * @see format_number() for floating point values.
+         */
+        inline int format_number(
+            char* first,
+            char* last,
+            float16 value,
+            int precision,
+            bool fixed)
+        {
+            return Detail::format_half(first, last, value, precision, fixed, 5);
+        }
+
+        /**
+         * @brief Formats a bfloat16 value through float32. A negative
+         * precision picks the shortest text that reads back to the same
+         * bfloat16.
+         *
+         * @see format_number() for floating point values.
+         */
+        inline int format_number(
+            char* first,
+            char* last,
+            bfloat16 value,
+            int precision,
+            bool fixed)
+        {
+            return Detail::format_half(first, last, value, precision, fixed, 4);
+        }
+
+        /**
+         * @brief Parses a float16 value as a float32 rounded to float16.
+         *
+         * @see parse_number() for floating point values.
+         */
+        inline const char* parse_number(
+            const char* first,
+            const char* last,
+            float16& value)
+        {
+            return Detail::parse_half(first, last, value);
+        }
+
+        /**
+         * @brief Parses a bfloat16 value as a float32 rounded to bfloat16.
+         *
+         * @see parse_number() for floating point values.
+         */
+        inline const char* parse_number(
+            const char* first,
+            const char* last,
+            bfloat16& value)
+        {
+            return Detail::parse_half(first, last, value);
+        }
+
         /**
          * @brief Trims the string of the listed unwanted characters
          * from the left end.
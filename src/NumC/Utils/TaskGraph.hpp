@@ -0,0 +1,927 @@
+#pragma once
+
+#define TASK_GRAPH NumC::Utils::TaskGraph
+
+#include <NumC/Core/Memory.hpp>
+#include <NumC/Core/NdArray.hpp>
+#include <NumC/Core/Trace.hpp>
+#include <NumC/Utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace NumC
+{
+    namespace Utils
+    {
+        template<typename R>
+        class Task;
+
+        /**
+         * @brief Marks an array argument of TaskGraph::async() as written to
+         * by the task.
+         *
+         * @tparam A Array or view type.
+         */
+        template<typename A>
+        struct Writes
+        {
+            /// @brief Pointer to the array.
+            A* array;
+        };
+
+        /**
+         * @brief Marks an array argument of TaskGraph::async() as written to.
+         * Later tasks touching the same buffer wait for this one, and this
+         * one waits for the earlier readers and writers of the buffer.
+         *
+         * @tparam A Array or view type.
+         * @param array Reference to the array.
+         * @return Write marker passed to the task as A&.
+         */
+        template<typename A>
+        Writes<A> writes(A& array)
+        {
+            return Writes<A>{&array};
+        }
+
+        namespace Detail
+        {
+            template<size_t... Is>
+            struct IndexSequence {};
+
+            template<size_t N, size_t... Is>
+            struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Is...>
+            {};
+
+            template<size_t... Is>
+            struct MakeIndexSequence<0, Is...>
+            {
+                using type = IndexSequence<Is...>;
+            };
+
+            template<typename T>
+            std::true_type is_nd_array_test(const Core::NdArray<T>*);
+
+            std::false_type is_nd_array_test(...);
+
+            /// @brief True for NdArray and all its views.
+            template<typename A>
+            struct IsNdArray :
+                decltype(is_nd_array_test(std::declval<A*>()))
+            {};
+
+            /// @brief Size of a graph's task and buffer lists below which
+            /// they are not pruned.
+            const size_t TASK_PRUNE_MIN = 64;
+
+            /// @brief First error among the tasks of a graph.
+            struct TaskErrors
+            {
+                std::mutex mutex;
+                std::exception_ptr first;
+            };
+
+            /**
+             * @brief Node of the task graph. Runs on the shared ThreadPool
+             * once all the nodes it depends on are done.
+             */
+            class TaskNode : public std::enable_shared_from_this<TaskNode>
+            {
+                public:
+                    /// Aliases
+                    using node_ptr = std::shared_ptr<TaskNode>;
+
+                    /**
+                     * @brief Construct a new Task Node object. Captures the
+                     * memory tracker active on the submitting thread.
+                     */
+                    TaskNode() :
+                        __tracker(Core::MemoryTracker::active()),
+                        __pending(1),
+                        __done(false)
+                    {}
+
+                    virtual ~TaskNode() {}
+
+                    /**
+                     * @brief Makes this node run after another one. Must be
+                     * called before schedule().
+                     *
+                     * @param node Node to wait for. Ignored if null or done.
+                     */
+                    void depend_on(const node_ptr& node)
+                    {
+                        if (!node || node.get() == this)
+                            return;
+
+                        std::lock_guard<std::mutex> lock(node->__mutex);
+
+                        this->__dependencies.push_back(node);
+
+                        if (node->__done)
+                            return;
+
+                        ++this->__pending;
+                        node->__dependents.push_back(this->shared_from_this());
+                    }
+
+                    /**
+                     * @brief Releases the node. It is queued on the pool as
+                     * soon as its dependencies are done.
+                     *
+                     * @param errors Where the node reports its error, if it
+                     * fails. May be null.
+                     */
+                    void schedule(
+                        const std::shared_ptr<TaskErrors>& errors = nullptr)
+                    {
+                        this->__errors = errors;
+                        this->__release();
+                    }
+
+                    /**
+                     * @brief Checks if the node is done.
+                     *
+                     * @return True once the node ran or failed.
+                     */
+                    bool done() const
+                    {
+                        std::lock_guard<std::mutex> lock(this->__mutex);
+
+                        return this->__done;
+                    }
+
+                    /**
+                     * @brief Blocks until the node is done. Pool workers run
+                     * other queued jobs meanwhile instead of blocking.
+                     */
+                    void wait() const
+                    {
+                        std::unique_lock<std::mutex> lock(this->__mutex);
+
+                        while (!this->__done)
+                        {
+                            if (!ThreadPool::in_worker())
+                            {
+                                this->__cv.wait(lock);
+                                continue;
+                            }
+
+                            lock.unlock();
+
+                            bool ran = ThreadPool::instance().run_one();
+
+                            lock.lock();
+
+                            if (!ran && !this->__done)
+                                this->__cv.wait_for(
+                                    lock, std::chrono::milliseconds(1));
+                        }
+                    }
+
+                    /**
+                     * @brief Gets the error the node failed with.
+                     *
+                     * @return Exception thrown by the node or one of its
+                     * dependencies, null on success.
+                     */
+                    std::exception_ptr error() const
+                    {
+                        std::lock_guard<std::mutex> lock(this->__mutex);
+
+                        return this->__error;
+                    }
+
+                protected:
+                    /// @brief Runs the task body.
+                    virtual void _execute() = 0;
+
+                private:
+
+                    /// @brief Counts down a dependency and queues the node
+                    /// once none is left.
+                    void __release()
+                    {
+                        if (--this->__pending > 0)
+                            return;
+
+                        node_ptr self = this->shared_from_this();
+
+                        ThreadPool::instance().submit([self]
+                        {
+                            self->__run();
+                        });
+                    }
+
+                    /// @brief Runs the body unless a dependency failed, then
+                    /// releases the dependents.
+                    void __run()
+                    {
+                        std::exception_ptr error;
+
+                        for (const node_ptr& node : this->__dependencies)
+                        {
+                            if ((error = node->error()))
+                                break;
+                        }
+
+                        this->__dependencies.clear();
+
+                        if (!error)
+                        {
+                            Core::MemoryScope scope(this->__tracker);
+                            NUMC_TRACE_SCOPE("task", "async");
+
+                            try
+                            {
+                                this->_execute();
+                            }
+                            catch (...)
+                            {
+                                error = std::current_exception();
+                            }
+                        }
+
+                        // Reported before the node is marked done so that
+                        // wait_all() sees it once the node is waited for.
+                        if (error && this->__errors)
+                        {
+                            std::lock_guard<std::mutex> lock(
+                                this->__errors->mutex);
+
+                            if (!this->__errors->first)
+                                this->__errors->first = error;
+                        }
+
+                        this->__errors.reset();
+
+                        std::vector<node_ptr> dependents;
+
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+
+                            this->__error = error;
+                            this->__done = true;
+                            dependents.swap(this->__dependents);
+                        }
+
+                        this->__cv.notify_all();
+
+                        for (const node_ptr& node : dependents)
+                            node->__release();
+                    }
+
+                    /// @brief Tracker allocations of the task are charged to.
+                    Core::MemoryTracker::tracker_ptr __tracker;
+
+                    /// @brief Error report of the graph the node is in.
+                    std::shared_ptr<TaskErrors> __errors;
+
+                    /// @brief Unfinished dependencies + 1 until scheduled.
+                    std::atomic<size_t> __pending;
+
+                    mutable std::mutex __mutex;
+                    mutable std::condition_variable __cv;
+                    bool __done;
+                    std::exception_ptr __error;
+
+                    /// @brief Nodes this one waits for.
+                    std::vector<node_ptr> __dependencies;
+
+                    /// @brief Nodes waiting for this one.
+                    std::vector<node_ptr> __dependents;
+            };
+
+            /// @brief Buffers and nodes a task depends on.
+            struct TaskDeps
+            {
+                std::vector<const void*> reads;
+                std::vector<const void*> writes;
+                std::vector<TaskNode::node_ptr> nodes;
+            };
+
+            /**
+             * @brief Storage of a task result.
+             *
+             * @tparam R Result type.
+             */
+            template<typename R>
+            class TaskResult
+            {
+                public:
+                    /// Aliases
+                    using const_reference = const R&;
+
+                    template<typename Func>
+                    void store(Func& func)
+                    {
+                        this->__value.reset(new R(func()));
+                    }
+
+                    const_reference get() const
+                    {
+                        return *this->__value;
+                    }
+
+                private:
+                    std::unique_ptr<R> __value;
+            };
+
+            template<>
+            class TaskResult<void>
+            {
+                public:
+                    /// Aliases
+                    using const_reference = void;
+
+                    template<typename Func>
+                    void store(Func& func)
+                    {
+                        func();
+                    }
+
+                    const_reference get() const {}
+            };
+
+            /**
+             * @brief Task node holding a result.
+             *
+             * @tparam R Result type.
+             */
+            template<typename R>
+            class TaskState : public TaskNode
+            {
+                public:
+                    /// @brief Gets the result. Only valid once done.
+                    const TaskResult<R>& result() const
+                    {
+                        return this->_result;
+                    }
+
+                protected:
+                    TaskResult<R> _result;
+            };
+
+            /**
+             * @brief How a task argument is stored, passed to the task body
+             * and tracked. Plain values are copied, arrays passed as rvalues
+             * are copied too (sharing their buffer) and read.
+             */
+            template<typename Arg, typename Enable = void>
+            struct TaskArg
+            {
+                using stored = typename std::decay<Arg>::type;
+                using passed = stored&;
+
+                static stored store(Arg&& arg)
+                {
+                    return stored(std::forward<Arg>(arg));
+                }
+
+                static passed pass(stored& arg)
+                {
+                    return arg;
+                }
+
+                static void collect(const stored& arg, TaskDeps& deps)
+                {
+                    collect_value(
+                        arg, deps, IsNdArray<stored>());
+                }
+
+                static void collect_value(
+                    const stored& arg, TaskDeps& deps, std::true_type)
+                {
+                    deps.reads.push_back(arg.buffer_id());
+                }
+
+                static void collect_value(
+                    const stored&, TaskDeps&, std::false_type)
+                {}
+            };
+
+            /// @brief Arrays and views passed as lvalues are referenced.
+            template<typename Arg>
+            struct TaskArg<Arg&,
+                typename std::enable_if<
+                    IsNdArray<typename std::decay<Arg>::type>::value>::type>
+            {
+                using stored = Arg*;
+                using passed = Arg&;
+
+                static stored store(Arg& arg)
+                {
+                    return &arg;
+                }
+
+                static passed pass(stored arg)
+                {
+                    return *arg;
+                }
+
+                static void collect(stored arg, TaskDeps& deps)
+                {
+                    deps.reads.push_back(arg->buffer_id());
+                }
+            };
+
+            /// @brief Arrays marked with writes() are referenced.
+            template<typename Arg>
+            struct TaskArg<Arg,
+                typename std::enable_if<
+                    std::is_same<
+                        typename std::decay<Arg>::type,
+                        Writes<typename std::remove_pointer<
+                            decltype(std::declval<Arg>().array)>::type>
+                    >::value>::type>
+            {
+                using array_t = typename std::remove_pointer<
+                    decltype(std::declval<Arg>().array)>::type;
+                using stored = array_t*;
+                using passed = array_t&;
+
+                static stored store(Arg&& arg)
+                {
+                    return arg.array;
+                }
+
+                static passed pass(stored arg)
+                {
+                    return *arg;
+                }
+
+                static void collect(stored arg, TaskDeps& deps)
+                {
+                    deps.writes.push_back(arg->buffer_id());
+                }
+            };
+
+            /// @brief Task handles are passed as their result.
+            template<typename Arg>
+            struct TaskArg<Arg,
+                typename std::enable_if<
+                    std::is_same<
+                        typename std::decay<Arg>::type,
+                        Task<typename std::decay<Arg>::type::value_type>
+                    >::value>::type>
+            {
+                using stored = typename std::decay<Arg>::type;
+                using value_type = typename stored::value_type;
+                using passed = typename std::conditional<
+                    std::is_void<value_type>::value,
+                    const stored&,
+                    typename TaskResult<value_type>::const_reference>::type;
+
+                static stored store(Arg&& arg)
+                {
+                    return stored(std::forward<Arg>(arg));
+                }
+
+                static passed pass(const stored& arg)
+                {
+                    return pass_value(arg, std::is_void<value_type>());
+                }
+
+                static passed pass_value(const stored& arg, std::true_type)
+                {
+                    return arg;
+                }
+
+                static passed pass_value(const stored& arg, std::false_type)
+                {
+                    return arg.get();
+                }
+
+                static void collect(const stored& arg, TaskDeps& deps)
+                {
+                    deps.nodes.push_back(arg.node());
+                }
+            };
+
+            /// @brief Decayed return type of a task body.
+            template<typename Func, typename... Args>
+            struct TaskResultOf
+            {
+                using type = typename std::decay<decltype(
+                    std::declval<Func&>()(
+                        std::declval<typename TaskArg<Args>::passed>()...)
+                    )>::type;
+            };
+
+            /**
+             * @brief Task node binding a body to its arguments.
+             *
+             * @tparam Func Task body type.
+             * @tparam Args Argument types as passed to TaskGraph::async().
+             */
+            template<typename Func, typename... Args>
+            class BoundTask :
+                public TaskState<typename TaskResultOf<Func, Args...>::type>
+            {
+                public:
+                    /// Aliases
+                    using indices_t =
+                        typename MakeIndexSequence<sizeof...(Args)>::type;
+
+                    BoundTask(Func func, Args&&... args) :
+                        __func(std::move(func)),
+                        __args(TaskArg<Args>::store(
+                            std::forward<Args>(args))...)
+                    {}
+
+                    /**
+                     * @brief Gathers the buffers and nodes the arguments
+                     * depend on.
+                     *
+                     * @param deps Dependencies to be filled.
+                     */
+                    void collect(TaskDeps& deps) const
+                    {
+                        this->__collect(deps, indices_t());
+                    }
+
+                protected:
+                    void _execute() override
+                    {
+                        auto call = [this]
+                        {
+                            return this->__call(indices_t());
+                        };
+
+                        this->_result.store(call);
+                    }
+
+                private:
+                    template<size_t... Is>
+                    typename TaskResultOf<Func, Args...>::type
+                    __call(IndexSequence<Is...>)
+                    {
+                        return this->__func(TaskArg<Args>::pass(
+                            std::get<Is>(this->__args))...);
+                    }
+
+                    template<size_t... Is>
+                    void __collect(TaskDeps& deps, IndexSequence<Is...>) const
+                    {
+                        int expand[] = {0, (TaskArg<Args>::collect(
+                            std::get<Is>(this->__args), deps), 0)...};
+                        (void)expand;
+                    }
+
+                    Func __func;
+                    std::tuple<typename TaskArg<Args>::stored...> __args;
+            };
+        }
+
+        /**
+         * @brief Handle to the result of a task submitted to a TaskGraph.
+         *
+         * @tparam R Result type.
+         */
+        template<typename R>
+        class Task
+        {
+            public:
+                /// Aliases
+                using value_type = R;
+                using state_ptr = std::shared_ptr<Detail::TaskState<R>>;
+
+                /// @brief Construct an empty Task object.
+                Task() {}
+
+                /**
+                 * @brief Construct a new Task object.
+                 *
+                 * @param state Shared task state.
+                 */
+                explicit Task(const state_ptr& state) :
+                    __state(state)
+                {}
+
+                /**
+                 * @brief Checks if the handle refers to a task.
+                 *
+                 * @return True if not empty.
+                 */
+                bool valid() const
+                {
+                    return this->__state != nullptr;
+                }
+
+                /**
+                 * @brief Checks if the task is done, without blocking.
+                 *
+                 * @return True once the task ran or failed.
+                 */
+                bool ready() const
+                {
+                    this->__validate();
+
+                    return this->__state->done();
+                }
+
+                /// @brief Blocks until the task is done.
+                void wait() const
+                {
+                    this->__validate();
+                    this->__state->wait();
+                }
+
+                /**
+                 * @brief Waits for the task and gets its result.
+                 *
+                 * @note Rethrows the exception the task or one of the tasks
+                 * it depends on failed with.
+                 *
+                 * @return Reference to the result, valid while a handle to
+                 * the task exists.
+                 */
+                typename Detail::TaskResult<R>::const_reference get() const
+                {
+                    this->wait();
+
+                    std::exception_ptr error = this->__state->error();
+
+                    if (error)
+                        std::rethrow_exception(error);
+
+                    return this->__state->result().get();
+                }
+
+                /**
+                 * @brief Gets the graph node of the task.
+                 *
+                 * @return Pointer to the node.
+                 */
+                Detail::TaskNode::node_ptr node() const
+                {
+                    return this->__state;
+                }
+
+            private:
+
+                void __validate() const
+                {
+                    NUMC_CHECK(
+                        this->valid(),
+                        Core::ErrorCode::InvalidArgument,
+                        "task - 1: empty task handle.");
+                }
+
+                state_ptr __state;
+        };
+
+        /**
+         * @brief Runs array operations asynchronously on the shared
+         * ThreadPool, ordered by the data they touch.
+         *
+         * @note A task waits for the tasks whose results it takes as
+         * arguments, and for earlier tasks that conflict with it on an array
+         * buffer: reads wait for earlier writes, writes wait for earlier
+         * reads and writes. Views count as their base array. Independent
+         * tasks run concurrently.
+         *
+         * The graph only keeps weak references to its tasks. A task, with
+         * its arguments and result, is freed as soon as it is done and no
+         * Task handle refers to it, whether wait_all() is called or not.
+         *
+         * @warning Arrays passed as lvalues are referenced, not copied, and
+         * must outlive the task. The graph waits for its tasks when
+         * destroyed.
+         */
+        class TaskGraph
+        {
+            public:
+                /// @brief Construct a new Task Graph object.
+                TaskGraph() :
+                    __errors(std::make_shared<Detail::TaskErrors>())
+                {}
+
+                TaskGraph(const TaskGraph&) = delete;
+                TaskGraph& operator=(const TaskGraph&) = delete;
+
+                /// @brief Waits for all the submitted tasks.
+                ~TaskGraph()
+                {
+                    for (const node_wptr& ptr : this->__tasks)
+                    {
+                        node_ptr node = ptr.lock();
+
+                        if (node)
+                            node->wait();
+                    }
+                }
+
+                /**
+                 * @brief Submits func(args...) for asynchronous execution.
+                 *
+                 * @note Arguments are passed to func as follows:
+                 * - arrays and views: by reference, read by the task;
+                 * - writes(array): by reference, written by the task;
+                 * - Task<U> handles: as the const U& result;
+                 * - anything else: as a copy.
+                 *
+                 * @tparam Func Task body type.
+                 * @tparam Args Argument types.
+                 * @param func Task body.
+                 * @param args Task arguments.
+                 * @return Handle to the task result.
+                 */
+                template<typename Func, typename... Args>
+                Task<typename Detail::TaskResultOf<Func, Args...>::type>
+                async(Func func, Args&&... args)
+                {
+                    using result_t =
+                        typename Detail::TaskResultOf<Func, Args...>::type;
+                    using state_t = Detail::BoundTask<Func, Args...>;
+
+                    std::shared_ptr<state_t> state(new state_t(
+                        std::move(func), std::forward<Args>(args)...));
+                    Detail::TaskDeps deps;
+
+                    state->collect(deps);
+                    this->__record(state, deps);
+                    state->schedule(this->__errors);
+
+                    return Task<result_t>(state);
+                }
+
+                /**
+                 * @brief Blocks until all the submitted tasks are done.
+                 *
+                 * @note Rethrows the first error among the tasks that failed
+                 * since the last wait_all(), including the ones already
+                 * freed.
+                 */
+                void wait_all()
+                {
+                    std::vector<node_wptr> tasks;
+
+                    {
+                        std::lock_guard<std::mutex> lock(this->__mutex);
+                        tasks.swap(this->__tasks);
+                        this->__prune_at = Detail::TASK_PRUNE_MIN;
+                    }
+
+                    for (const node_wptr& ptr : tasks)
+                    {
+                        node_ptr node = ptr.lock();
+
+                        if (node)
+                            node->wait();
+                    }
+
+                    std::exception_ptr error;
+
+                    {
+                        std::lock_guard<std::mutex> lock(this->__mutex);
+
+                        this->__prune();
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(
+                            this->__errors->mutex);
+
+                        std::swap(error, this->__errors->first);
+                    }
+
+                    if (error)
+                        std::rethrow_exception(error);
+                }
+
+            private:
+                /// Aliases
+                using node_ptr = Detail::TaskNode::node_ptr;
+                using node_wptr = std::weak_ptr<Detail::TaskNode>;
+
+                /// @brief Tasks that last touched a buffer.
+                struct BufferAccess
+                {
+                    /// @brief Last task writing to the buffer.
+                    node_wptr writer;
+
+                    /// @brief Tasks reading it since the last write.
+                    std::vector<node_wptr> readers;
+                };
+
+                /// @brief Adds the dependency edges of a new task.
+                void __record(
+                    const std::shared_ptr<Detail::TaskNode>& node,
+                    const Detail::TaskDeps& deps)
+                {
+                    std::lock_guard<std::mutex> lock(this->__mutex);
+
+                    for (const node_ptr& dep : deps.nodes)
+                        node->depend_on(dep);
+
+                    for (const void* buffer : deps.reads)
+                    {
+                        if (buffer == nullptr)
+                            continue;
+
+                        BufferAccess& access = this->__buffers[buffer];
+
+                        node->depend_on(access.writer.lock());
+                        access.readers.push_back(node);
+                    }
+
+                    for (const void* buffer : deps.writes)
+                    {
+                        if (buffer == nullptr)
+                            continue;
+
+                        BufferAccess& access = this->__buffers[buffer];
+
+                        node->depend_on(access.writer.lock());
+
+                        for (const node_wptr& reader : access.readers)
+                            node->depend_on(reader.lock());
+
+                        access.writer = node;
+                        access.readers.clear();
+                    }
+
+                    this->__tasks.push_back(node);
+
+                    // Amortized: the lists are walked once they doubled.
+                    if (this->__entries() >= this->__prune_at)
+                    {
+                        this->__prune();
+                        this->__prune_at = std::max(
+                            Detail::TASK_PRUNE_MIN, 2 * this->__entries());
+                    }
+                }
+
+                /// @brief Combined size of the task and buffer lists.
+                size_t __entries() const
+                {
+                    return size_t(
+                        this->__tasks.size() + this->__buffers.size());
+                }
+
+                /**
+                 * @brief Forgets the finished tasks and the buffers no
+                 * pending task touches. Called with the mutex held.
+                 */
+                void __prune()
+                {
+                    auto is_idle = [](const node_wptr& ptr)
+                    {
+                        node_ptr node = ptr.lock();
+
+                        return !node || node->done();
+                    };
+
+                    this->__tasks.erase(
+                        std::remove_if(
+                            this->__tasks.begin(),
+                            this->__tasks.end(),
+                            is_idle),
+                        this->__tasks.end());
+
+                    for (auto it = this->__buffers.begin();
+                        it != this->__buffers.end();)
+                    {
+                        BufferAccess& access = it->second;
+
+                        access.readers.erase(
+                            std::remove_if(
+                                access.readers.begin(),
+                                access.readers.end(),
+                                is_idle),
+                            access.readers.end());
+
+                        if (is_idle(access.writer) && access.readers.empty())
+                            it = this->__buffers.erase(it);
+                        else
+                            ++it;
+                    }
+                }
+
+                std::mutex __mutex;
+                std::map<const void*, BufferAccess> __buffers;
+
+                /// @brief Tasks submitted since the last wait_all(), possibly
+                /// finished or freed.
+                std::vector<node_wptr> __tasks;
+
+                /// @brief Combined list size that triggers the next prune.
+                size_t __prune_at = Detail::TASK_PRUNE_MIN;
+
+                /// @brief Errors reported by the tasks.
+                std::shared_ptr<Detail::TaskErrors> __errors;
+        };
+    }
+}
@@ -0,0 +1,457 @@
+#pragma once
+
+#define THREAD_POOL NumC::Utils::ThreadPool
+
+#include <NumC/Core/Error.hpp>
+#include <NumC/Core/Type.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NumC
+{
+    namespace Utils
+    {
+        /**
+         * @brief Gets the number of hardware threads.
+         *
+         * @return Number of hardware threads, at least 1.
+         */
+        inline size_t hardware_threads()
+        {
+            size_t n = std::thread::hardware_concurrency();
+
+            return n > 0 ? n : 1;
+        }
+
+        /**
+         * @brief Work-stealing pool of worker threads.
+         *
+         * @note Each worker owns a deque. Jobs submitted by a worker go to
+         * the back of its own deque and are popped from there, jobs from
+         * other threads go to a shared queue. Idle workers steal from the
+         * front of the other deques. Threads waiting on a job should call
+         * run_one() instead of blocking so that queued jobs still make
+         * progress.
+         */
+        class ThreadPool
+        {
+            public:
+                /// Aliases
+                using job_t = std::function<void()>;
+
+                /**
+                 * @brief Gets the process wide pool, started on first use
+                 * with NUMC_NUM_THREADS workers if the environment variable
+                 * is set, else hardware_threads().
+                 *
+                 * @return Reference to the shared pool.
+                 */
+                static ThreadPool& instance()
+                {
+                    static ThreadPool pool(default_threads());
+
+                    return pool;
+                }
+
+                /**
+                 * @brief Construct a new Thread Pool object.
+                 *
+                 * @param n_threads Number of workers. 0 uses
+                 * hardware_threads().
+                 * @param pin Pins each worker to one CPU.
+                 */
+                explicit ThreadPool(size_t n_threads = 0, bool pin = false) :
+                    __queued(0),
+                    __stop(false),
+                    __pin(false)
+                {
+                    this->__start(n_threads, pin);
+                }
+
+                ThreadPool(const ThreadPool&) = delete;
+                ThreadPool& operator=(const ThreadPool&) = delete;
+
+                /// @brief Joins the workers and runs the jobs left.
+                ~ThreadPool()
+                {
+                    this->__join();
+
+                    while (this->run_one()) {}
+                }
+
+                /**
+                 * @brief Queues a job.
+                 *
+                 * @param job Job to be run on a worker.
+                 */
+                void submit(job_t job)
+                {
+                    Worker& worker = current();
+
+                    ++this->__queued;
+
+                    if (worker.pool == this)
+                        this->__queues[worker.index]->push_back(
+                            std::move(job));
+                    else
+                        this->__injected.push_back(std::move(job));
+
+                    std::lock_guard<std::mutex> lock(this->__sleep_mutex);
+                    this->__sleep_cv.notify_one();
+                }
+
+                /**
+                 * @brief Queues a job for one worker only. It is never
+                 * stolen, so it runs on that worker and, if the pool is
+                 * pinned, on that worker's CPU.
+                 *
+                 * @param index Worker index, less than size().
+                 * @param job Job to be run on the worker.
+                 */
+                void submit_to(size_t index, job_t job)
+                {
+                    NUMC_CHECK(
+                        index >= 0 && index < this->size(),
+                        Core::ErrorCode::InvalidArgument,
+                        "pool - 2: worker index out of range.");
+
+                    this->__owned[index]->push_back(std::move(job));
+
+                    // All woken: only the target worker may take it.
+                    std::lock_guard<std::mutex> lock(this->__sleep_mutex);
+                    this->__sleep_cv.notify_all();
+                }
+
+                /**
+                 * @brief Runs one queued job on the calling thread. Workers
+                 * take the jobs queued for them alone first, then their own
+                 * newest job, then the oldest shared one, then steal the
+                 * oldest job of another worker.
+                 *
+                 * @return True if a job was run, false if none was queued.
+                 */
+                bool run_one()
+                {
+                    job_t job;
+
+                    if (!this->__take(job))
+                        return false;
+
+                    job();
+
+                    return true;
+                }
+
+                /**
+                 * @brief Gets the number of workers.
+                 *
+                 * @return Number of worker threads.
+                 */
+                size_t size() const
+                {
+                    return this->__workers.size();
+                }
+
+                /**
+                 * @brief Checks if the workers are pinned to CPUs.
+                 *
+                 * @return True if pinned.
+                 */
+                bool pinned() const
+                {
+                    return this->__pin;
+                }
+
+                /**
+                 * @brief Restarts the pool with another number of workers.
+                 * Queued jobs are kept.
+                 *
+                 * @warning Must not be called from a worker of this pool.
+                 *
+                 * @param n_threads Number of workers. 0 uses
+                 * hardware_threads().
+                 * @param pin Pins each worker to one CPU.
+                 */
+                void resize(size_t n_threads, bool pin)
+                {
+                    NUMC_CHECK(
+                        current().pool != this,
+                        Core::ErrorCode::Unsupported,
+                        "pool - 1: a pool cannot be resized from one of its "
+                        "workers.");
+
+                    std::lock_guard<std::mutex> lock(this->__resize_mutex);
+
+                    this->__join();
+
+                    for (auto& queue : this->__queues)
+                        queue->move_to(this->__injected);
+
+                    // Owned jobs are not counted in __queued until shared.
+                    for (auto& queue : this->__owned)
+                        this->__queued += queue->move_to(this->__injected);
+
+                    this->__start(n_threads, pin);
+                }
+
+                /**
+                 * @brief Checks if the calling thread is a pool worker.
+                 *
+                 * @return True on a worker thread of any pool.
+                 */
+                static bool in_worker()
+                {
+                    return current().pool != nullptr;
+                }
+
+            private:
+
+                /// @brief Mutex guarded job deque.
+                class JobQueue
+                {
+                    public:
+                        void push_back(job_t job)
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+                            this->__jobs.push_back(std::move(job));
+                        }
+
+                        bool pop_back(job_t& job)
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+
+                            if (this->__jobs.empty())
+                                return false;
+
+                            job = std::move(this->__jobs.back());
+                            this->__jobs.pop_back();
+
+                            return true;
+                        }
+
+                        bool pop_front(job_t& job)
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+
+                            if (this->__jobs.empty())
+                                return false;
+
+                            job = std::move(this->__jobs.front());
+                            this->__jobs.pop_front();
+
+                            return true;
+                        }
+
+                        bool empty()
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+
+                            return this->__jobs.empty();
+                        }
+
+                        size_t move_to(JobQueue& other)
+                        {
+                            std::lock_guard<std::mutex> lock(this->__mutex);
+                            size_t n = this->__jobs.size();
+
+                            for (auto& job : this->__jobs)
+                                other.push_back(std::move(job));
+
+                            this->__jobs.clear();
+
+                            return n;
+                        }
+
+                    private:
+                        std::mutex __mutex;
+                        std::deque<job_t> __jobs;
+                };
+
+                /// @brief Pool and deque of the calling thread.
+                struct Worker
+                {
+                    ThreadPool* pool;
+                    size_t index;
+                };
+
+                /// @brief Gets the worker slot of the calling thread.
+                static Worker& current()
+                {
+                    static thread_local Worker worker = {nullptr, 0};
+
+                    return worker;
+                }
+
+                /// @brief Reads NUMC_NUM_THREADS, else hardware_threads().
+                static size_t default_threads()
+                {
+                    const char* value = std::getenv("NUMC_NUM_THREADS");
+                    long n = value ? std::atol(value) : 0;
+
+                    return n > 0 ? size_t(n) : hardware_threads();
+                }
+
+                /// @brief Pins the calling thread to the index-th usable CPU.
+                static void pin_thread(size_t index)
+                {
+#ifdef __linux__
+                    cpu_set_t allowed;
+                    CPU_ZERO(&allowed);
+
+                    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+                        return;
+
+                    int n_cpus = CPU_COUNT(&allowed);
+
+                    if (n_cpus <= 0)
+                        return;
+
+                    int target = int(index % size_t(n_cpus));
+
+                    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                    {
+                        if (!CPU_ISSET(cpu, &allowed) || target-- > 0)
+                            continue;
+
+                        cpu_set_t set;
+                        CPU_ZERO(&set);
+                        CPU_SET(cpu, &set);
+                        pthread_setaffinity_np(
+                            pthread_self(), sizeof(set), &set);
+
+                        return;
+                    }
+#else
+                    (void)index;
+#endif
+                }
+
+                /// @brief Starts the workers.
+                void __start(size_t n_threads, bool pin)
+                {
+                    if (n_threads <= 0)
+                        n_threads = hardware_threads();
+
+                    this->__stop = false;
+                    this->__pin = pin;
+                    this->__queues.clear();
+                    this->__owned.clear();
+
+                    for (size_t i = 0; i < n_threads; ++i)
+                    {
+                        this->__queues.emplace_back(new JobQueue());
+                        this->__owned.emplace_back(new JobQueue());
+                    }
+
+                    this->__workers.reserve(n_threads);
+
+                    for (size_t i = 0; i < n_threads; ++i)
+                        this->__workers.emplace_back(
+                            [this, i] { this->__run(i); });
+                }
+
+                /// @brief Stops and joins the workers.
+                void __join()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(this->__sleep_mutex);
+                        this->__stop = true;
+                    }
+
+                    this->__sleep_cv.notify_all();
+
+                    for (auto& worker : this->__workers)
+                        worker.join();
+
+                    this->__workers.clear();
+                }
+
+                /// @brief Takes the next job for the calling thread.
+                bool __take(job_t& job)
+                {
+                    Worker& worker = current();
+                    size_t n_queues = this->__queues.size();
+                    size_t self = worker.pool == this ? worker.index : 0;
+
+                    if (worker.pool == this &&
+                        this->__owned[self]->pop_front(job))
+                        return true;
+
+                    bool found =
+                        (worker.pool == this &&
+                            this->__queues[self]->pop_back(job)) ||
+                        this->__injected.pop_front(job);
+
+                    for (size_t i = 1; !found && i <= n_queues; ++i)
+                        found = this->__queues[(self + i) % n_queues]->
+                            pop_front(job);
+
+                    if (found)
+                        --this->__queued;
+
+                    return found;
+                }
+
+                /// @brief Worker loop.
+                void __run(size_t index)
+                {
+                    current() = Worker{this, index};
+
+                    if (this->__pin)
+                        pin_thread(index);
+
+                    while (true)
+                    {
+                        if (this->run_one())
+                            continue;
+
+                        std::unique_lock<std::mutex> lock(this->__sleep_mutex);
+
+                        this->__sleep_cv.wait(lock, [this, index]
+                        {
+                            return this->__stop || this->__queued > 0 ||
+                                !this->__owned[index]->empty();
+                        });
+
+                        if (this->__stop)
+                            break;
+                    }
+
+                    current() = Worker{nullptr, 0};
+                }
+
+                std::vector<std::thread> __workers;
+
+                /// @brief One deque per worker.
+                std::vector<std::unique_ptr<JobQueue>> __queues;
+
+                /// @brief Per worker jobs that are never stolen.
+                std::vector<std::unique_ptr<JobQueue>> __owned;
+
+                /// @brief Jobs submitted from outside the pool.
+                JobQueue __injected;
+
+                /// @brief Jobs in all the queues, but the owned ones.
+                std::atomic<size_t> __queued;
+
+                std::mutex __sleep_mutex;
+                std::condition_variable __sleep_cv;
+                std::mutex __resize_mutex;
+                bool __stop;
+                bool __pin;
+        };
+    }
+}